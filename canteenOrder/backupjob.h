@@ -0,0 +1,60 @@
+#ifndef BACKUPJOB_H
+#define BACKUPJOB_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include "uilagprobe.h"
+
+// 备份线程：用 SQLite 在线备份 API 做一次快照
+// 每步只拷贝有限的页数，步与步之间休眠，让出 CPU 和存储带宽给界面和业务写入。
+// 没有 HAVE_SQLITE_BACKUP (Qt 用自带的 SQLite) 时改用 VACUUM INTO 或写锁下拷贝文件。
+// 下面的参数只能在线程没运行时修改 (由 BackupManager::backupNow 设置)
+class BackupThread : public QThread
+{
+    Q_OBJECT
+public:
+    QString sourcePath;
+    QString targetDir;
+    int retention = 7;       // 保留的快照个数
+    int pagesPerStep = 64;   // 每步拷贝的页数 (默认页大小 4KB，即 256KB)
+    int stepPauseMs = 20;    // 步间休眠
+
+protected:
+    void run() override;
+
+signals:
+    void snapshotFinished(bool ok, const QString &file, qint64 elapsedMs, int pages, int steps);
+
+private:
+    bool copyDatabase(const QString &tmpPath, int *pages, int *steps);
+    void pruneOldSnapshots();
+};
+
+// 定时备份管理
+class BackupManager : public QObject
+{
+    Q_OBJECT
+public:
+    static BackupManager* instance();
+
+    void setTargetDir(const QString &dir);
+    void setRetention(int count);
+    void start(int intervalMinutes); // 启动定时备份
+    void backupNow();
+
+private:
+    explicit BackupManager(QObject *parent = nullptr);
+    static BackupManager* m_instance;
+
+    BackupThread *m_thread;
+    QString m_targetDir;
+    int m_retention;
+    QTimer *m_timer;
+    UiLagProbe *m_probe; // 备份期间统计界面卡顿
+
+private slots:
+    void onSnapshotFinished(bool ok, const QString &file, qint64 elapsedMs, int pages, int steps);
+};
+
+#endif // BACKUPJOB_H
@@ -0,0 +1,230 @@
+#include "boottrace.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTimer>
+#include <QEvent>
+#include <QWidget>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+#include <algorithm>
+#include <time.h>
+#include <unistd.h>
+
+BootTrace* BootTrace::m_instance = nullptr;
+
+BootTrace* BootTrace::instance()
+{
+    if (m_instance == nullptr) {
+        m_instance = new BootTrace();
+    }
+    return m_instance;
+}
+
+BootTrace::BootTrace(QObject *parent) : QObject(parent)
+{
+    m_originNs = processStartNs();
+    if (m_originNs <= 0) m_originNs = nowNs(); // 读不到就从第一次调用算起
+}
+
+// 与 /proc/<pid>/stat 的 starttime 同一基准 (开机以来，含休眠时间)
+qint64 BootTrace::nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return (qint64)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// /proc/self/stat 第 22 项：进程创建时刻，单位是时钟滴答 (通常 10ms)
+qint64 BootTrace::processStartNs()
+{
+    QFile file("/proc/self/stat");
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+    QByteArray stat = file.readAll();
+    // 第 2 项是带括号的进程名，里面可能有空格，从最后一个 ')' 之后开始数
+    int paren = stat.lastIndexOf(')');
+    if (paren < 0) return 0;
+    QList<QByteArray> fields = stat.mid(paren + 2).split(' ');
+    if (fields.size() < 20) return 0;
+    bool ok = false;
+    qint64 ticks = fields.at(19).toLongLong(&ok);
+    long hz = sysconf(_SC_CLK_TCK);
+    if (!ok || hz <= 0) return 0;
+    return ticks * (1000000000LL / hz);
+}
+
+static QString currentThreadName()
+{
+    QCoreApplication *app = QCoreApplication::instance();
+    if (app == nullptr) return "main";
+    return QThread::currentThread() == app->thread() ? "gui" : "pool";
+}
+
+void BootTrace::begin(const QString &name)
+{
+    qint64 now = nowNs();
+    QMutexLocker locker(&m_mutex);
+    if (m_open.contains(name)) return;
+    for (const Event &e : m_events) {
+        if (e.name == name) return;
+    }
+    Event event = { name, currentThreadName(), now - m_originNs, -1 };
+    m_open.insert(name, m_events.size());
+    m_events.append(event);
+}
+
+void BootTrace::end(const QString &name)
+{
+    qint64 now = nowNs();
+    QMutexLocker locker(&m_mutex);
+    QHash<QString, int>::iterator it = m_open.find(name);
+    if (it == m_open.end()) return;
+    m_events[it.value()].endNs = now - m_originNs;
+    m_open.erase(it);
+}
+
+void BootTrace::mark(const QString &name)
+{
+    qint64 now = nowNs() - m_originNs;
+    QMutexLocker locker(&m_mutex);
+    Event event = { name, currentThreadName(), now, now };
+    m_events.append(event);
+}
+
+void BootTrace::watchFirstPaint(QWidget *widget, const QString &name)
+{
+    m_paintWatch.insert(widget, name);
+    widget->installEventFilter(this);
+}
+
+// 过滤器看到的是绘制事件刚派发的时刻；再投递一个 0ms 定时器，
+// 它在本轮绘制 (包括 backing store 刷到屏幕) 结束后才执行，两者之间就是第一帧的绘制耗时
+bool BootTrace::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Paint && m_paintWatch.contains(watched)) {
+        QString name = m_paintWatch.take(watched);
+        watched->removeEventFilter(this);
+        begin(name);
+        QTimer::singleShot(0, this, [=]() {
+            end(name);
+            write();
+        });
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+static QString msString(qint64 ns)
+{
+    return QString::number(ns / 1e6, 'f', 1);
+}
+
+static QByteArray jsonEscape(const QString &text)
+{
+    QByteArray utf8 = text.toUtf8();
+    utf8.replace('\\', "\\\\").replace('"', "\\\"");
+    return utf8;
+}
+
+// 手工拼 JSON：每个事件一行、字段顺序固定，两个版本的文件直接 diff 也好读
+bool BootTrace::write(const QString &path) const
+{
+    QList<Event> events;
+    {
+        QMutexLocker locker(&m_mutex);
+        events = m_events;
+    }
+    std::stable_sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
+        return a.startNs < b.startNs;
+    });
+
+    QByteArray out;
+    out += "{\n";
+    out += "  \"origin\": \"process start\",\n";
+    out += "  \"written_ms\": " + msString(nowNs() - m_originNs).toUtf8() + ",\n";
+    out += "  \"events\": [\n";
+    for (int i = 0; i < events.size(); ++i) {
+        const Event &e = events.at(i);
+        out += "    {\"name\": \"" + jsonEscape(e.name) + "\", \"thread\": \"" + e.thread.toUtf8()
+             + "\", \"start_ms\": " + msString(e.startNs).toUtf8();
+        if (e.endNs >= 0) {
+            out += ", \"end_ms\": " + msString(e.endNs).toUtf8()
+                 + ", \"dur_ms\": " + msString(e.endNs - e.startNs).toUtf8();
+        }
+        out += (i + 1 < events.size()) ? "},\n" : "}\n";
+    }
+    out += "  ]\n}\n";
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        qDebug() << "BootTrace: write failed" << path;
+        return false;
+    }
+    qDebug().noquote() << QString("[BootTrace] %1 events written to %2").arg(events.size()).arg(path);
+    return true;
+}
+
+static bool loadTimeline(const QString &path, QStringList *order, QHash<QString, QJsonObject> *events)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "BootTrace: cannot open" << path;
+        return false;
+    }
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (doc.isNull()) {
+        qDebug() << "BootTrace:" << path << error.errorString();
+        return false;
+    }
+    for (const QJsonValue &value : doc.object().value("events").toArray()) {
+        QJsonObject e = value.toObject();
+        QString name = e.value("name").toString();
+        if (events->contains(name)) continue;
+        order->append(name);
+        events->insert(name, e);
+    }
+    return true;
+}
+
+static QString column(const QJsonObject &e, const char *key)
+{
+    return e.contains(key) ? QString::number(e.value(key).toDouble(), 'f', 1) : QString("-");
+}
+
+static QString delta(const QJsonObject &a, const QJsonObject &b, const char *key)
+{
+    if (!a.contains(key) || !b.contains(key)) return "-";
+    return QString::asprintf("%+.1f", b.value(key).toDouble() - a.value(key).toDouble());
+}
+
+bool BootTrace::diff(const QString &oldPath, const QString &newPath)
+{
+    QStringList oldOrder, newOrder;
+    QHash<QString, QJsonObject> oldEvents, newEvents;
+    if (!loadTimeline(oldPath, &oldOrder, &oldEvents) || !loadTimeline(newPath, &newOrder, &newEvents)) return false;
+
+    // 以新文件的顺序为主，旧文件里独有的阶段排在后面
+    QStringList names = newOrder;
+    for (const QString &name : oldOrder) {
+        if (!newEvents.contains(name)) names.append(name);
+    }
+
+    qDebug().noquote() << QString("[BootTrace] %1 %2 %3 %4   %5 %6 %7")
+                          .arg("phase", -28).arg("end old", 10).arg("end new", 10).arg("delta", 9)
+                          .arg("dur old", 9).arg("dur new", 9).arg("delta", 9);
+    for (const QString &name : names) {
+        QJsonObject a = oldEvents.value(name);
+        QJsonObject b = newEvents.value(name);
+        qDebug().noquote() << QString("[BootTrace] %1 %2 %3 %4   %5 %6 %7")
+                              .arg(name, -28).arg(column(a, "end_ms"), 10).arg(column(b, "end_ms"), 10)
+                              .arg(delta(a, b, "end_ms"), 9)
+                              .arg(column(a, "dur_ms"), 9).arg(column(b, "dur_ms"), 9).arg(delta(a, b, "dur_ms"), 9);
+    }
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef BOOTTRACE_H
+#define BOOTTRACE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QList>
+#include <QHash>
+#include <QString>
+
+class QWidget;
+
+// 启动时间线
+// 从进程创建 (/proc/self/stat 的 starttime) 开始，按单调时钟 (CLOCK_BOOTTIME，与 starttime 同一基准)
+// 记录各个命名阶段，一直到登录界面和主界面第一次绘制。结果写成 JSON (BOOT_TRACE_FILE)，
+// 每个阶段一行，时间都相对进程创建，不同版本的文件可以直接 diff，或者用 --boot-diff 对比
+class BootTrace : public QObject
+{
+    Q_OBJECT
+public:
+    static BootTrace* instance();
+
+    // 阶段起止，可以在任意线程调用；同名阶段以第一次为准
+    void begin(const QString &name);
+    void end(const QString &name);
+    void mark(const QString &name);  // 瞬时事件
+    // 控件第一次收到绘制事件时记一个 <name> 事件，并把当前时间线写盘
+    void watchFirstPaint(QWidget *widget, const QString &name);
+
+    bool write(const QString &path = BOOT_TRACE_FILE) const;
+    // 对比两个时间线文件，逐阶段打印结束时间和耗时的变化
+    static bool diff(const QString &oldPath, const QString &newPath);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    explicit BootTrace(QObject *parent = nullptr);
+    static BootTrace* m_instance;
+    static qint64 nowNs();
+    static qint64 processStartNs();
+
+    struct Event {
+        QString name;
+        QString thread;
+        qint64 startNs;     // 相对进程创建
+        qint64 endNs;       // 瞬时事件等于 startNs，未结束为 -1
+    };
+
+    mutable QMutex m_mutex;
+    qint64 m_originNs;          // 进程创建时刻
+    QList<Event> m_events;
+    QHash<QString, int> m_open; // 未结束的阶段 -> m_events 下标
+    QHash<QObject *, QString> m_paintWatch;
+};
+
+#endif // BOOTTRACE_H
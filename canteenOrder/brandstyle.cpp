@@ -0,0 +1,528 @@
+#include "brandstyle.h"
+#include <QApplication>
+#include <QPainter>
+#include <QPushButton>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSlider>
+#include <QStyleOption>
+#include <QStyleFactory>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QDebug>
+
+#define LOOK_PROPERTY "brandLook"
+
+// 输入框：圆角 8、2px 边框，内容离边框 10px (与原样式表 padding 一致)
+#define LINE_EDIT_RADIUS 8
+#define LINE_EDIT_BORDER 2
+#define LINE_EDIT_PADDING 10
+
+// 进度条：8px 槽、30px 圆形滑块
+#define SLIDER_GROOVE_HEIGHT 8
+#define SLIDER_HANDLE_SIZE 30
+
+// --- Look ---
+BrandStyle::Look::Look(const QColor &fill, int radius)
+    : fillColor(fill), borderWidth(0), borderSides(0), borderStyle(Qt::SolidLine), edgeWidth(0), radius(radius)
+{
+}
+
+BrandStyle::Look &BrandStyle::Look::pressed(const QColor &color)
+{
+    pressedColor = color;
+    return *this;
+}
+
+BrandStyle::Look &BrandStyle::Look::border(const QColor &color, int width, int sides, Qt::PenStyle style)
+{
+    borderColor = color;
+    borderWidth = width;
+    borderSides = sides;
+    borderStyle = style;
+    return *this;
+}
+
+BrandStyle::Look &BrandStyle::Look::edge(const QColor &color, int width)
+{
+    edgeColor = color;
+    edgeWidth = width;
+    return *this;
+}
+
+BrandStyle::Look &BrandStyle::Look::checked(const QColor &text, const QColor &bar)
+{
+    checkedText = text;
+    checkedBar = bar;
+    return *this;
+}
+
+// 全局默认按钮：橙色主按钮，以及 objectName 为 SecondaryButton 的咖啡色次按钮
+static BrandStyle::Look primaryButtonLook()
+{
+    return BrandStyle::Look(QColor("#FF8C00"), 10).pressed(QColor("#E65100")).edge(QColor("#E65100"), 4);
+}
+
+static BrandStyle::Look secondaryButtonLook()
+{
+    return BrandStyle::Look(QColor("#A1887F"), 10).pressed(QColor("#8D6E63")).edge(QColor("#5D4037"), 4);
+}
+
+// --- BrandStyle ---
+BrandStyle::BrandStyle() : QProxyStyle(QStyleFactory::create("Fusion"))
+{
+}
+
+void BrandStyle::install(QApplication *app)
+{
+    BrandStyle *style = new BrandStyle();
+    app->setStyle(style);
+    app->setPalette(style->standardPalette());
+
+    QFont font("Microsoft YaHei");
+    font.setPixelSize(18);
+    app->setFont(font);
+}
+
+QPalette BrandStyle::standardPalette() const
+{
+    QPalette pal = QProxyStyle::standardPalette();
+    pal.setColor(QPalette::Window, QColor("#FFF5E6"));
+    pal.setColor(QPalette::WindowText, QColor("#5D4037"));
+    pal.setColor(QPalette::Base, Qt::white);
+    pal.setColor(QPalette::Text, QColor("#5D4037"));
+    pal.setColor(QPalette::Button, QColor("#FF8C00"));
+    pal.setColor(QPalette::ButtonText, Qt::white);
+    pal.setColor(QPalette::Highlight, QColor("#FF8C00"));
+    pal.setColor(QPalette::HighlightedText, Qt::white);
+    return pal;
+}
+
+void BrandStyle::setPanel(QWidget *widget, const Look &look)
+{
+    widget->setAttribute(Qt::WA_StyledBackground);
+    widget->setAutoFillBackground(false);
+    widget->setProperty(LOOK_PROPERTY, QVariant::fromValue(look));
+    widget->update();
+}
+
+void BrandStyle::setButton(QAbstractButton *button, const Look &look, const QColor &text, int pixelSize, bool bold)
+{
+    button->setProperty(LOOK_PROPERTY, QVariant::fromValue(look));
+    setText(button, text, pixelSize, bold);
+}
+
+void BrandStyle::setText(QWidget *widget, const QColor &color, int pixelSize, bool bold, const QString &family)
+{
+    QPalette pal = widget->palette();
+    pal.setColor(QPalette::WindowText, color);
+    pal.setColor(QPalette::ButtonText, color);
+    pal.setColor(QPalette::Text, color);
+    widget->setPalette(pal);
+
+    QFont font = widget->font();
+    if (!family.isEmpty()) font.setFamily(family);
+    font.setPixelSize(pixelSize);
+    font.setBold(bold);
+    widget->setFont(font);
+}
+
+// 没有单独指定外观的控件在这里套上原全局样式表里的默认外观
+void BrandStyle::polish(QWidget *widget)
+{
+    QProxyStyle::polish(widget);
+
+    if (QPushButton *button = qobject_cast<QPushButton *>(widget)) {
+        if (!button->property(LOOK_PROPERTY).isValid()) {
+            bool secondary = button->objectName() == "SecondaryButton";
+            setButton(button, secondary ? secondaryButtonLook() : primaryButtonLook(), Qt::white, 20, true);
+        }
+    } else if (QLineEdit *edit = qobject_cast<QLineEdit *>(widget)) {
+        QFont font = edit->font();
+        font.setPixelSize(20);
+        edit->setFont(font);
+    } else if (QLabel *label = qobject_cast<QLabel *>(widget)) {
+        if (label->objectName() == "Title") setText(label, QColor("#BF360C"), 32, true);
+    }
+}
+
+bool BrandStyle::lookOf(const QWidget *widget, Look *look)
+{
+    if (widget == nullptr) return false;
+    QVariant value = widget->property(LOOK_PROPERTY);
+    if (!value.isValid()) return false;
+    *look = value.value<Look>();
+    return true;
+}
+
+// 立体边的画法：先用边色画整个圆角矩形，再把填充色画在上面、底部留出 edgeWidth；
+// 按下时不画边色，填充整体下移 edgeWidth，相当于原样式表的 border-bottom: 0 + margin-top
+void BrandStyle::drawLook(QPainter *painter, const QRect &rect, const Look &look, bool pressed, bool checked)
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(Qt::NoPen);
+
+    QRectF r(rect);
+    if (look.edgeWidth > 0 && look.edgeColor.isValid()) {
+        if (pressed) {
+            r.setTop(r.top() + look.edgeWidth);
+        } else {
+            painter->setBrush(look.edgeColor);
+            painter->drawRoundedRect(r, look.radius, look.radius);
+            r.setBottom(r.bottom() - look.edgeWidth);
+        }
+    }
+
+    QColor fill = (pressed && look.pressedColor.isValid()) ? look.pressedColor : look.fillColor;
+    bool fullBorder = look.borderColor.isValid() && look.borderWidth > 0 && look.borderSides == 0;
+    if (fullBorder) {
+        painter->setPen(QPen(look.borderColor, look.borderWidth, look.borderStyle));
+        qreal half = look.borderWidth / 2.0;
+        r.adjust(half, half, -half, -half);
+    }
+    if (fill.isValid() || fullBorder) {
+        painter->setBrush(fill.isValid() ? QBrush(fill) : QBrush(Qt::NoBrush));
+        if (look.radius > 0) painter->drawRoundedRect(r, look.radius, look.radius);
+        else painter->drawRect(r);
+    }
+
+    // 单边边框 (分隔线)，不跟圆角
+    if (look.borderColor.isValid() && look.borderWidth > 0 && look.borderSides != 0) {
+        painter->setPen(QPen(look.borderColor, look.borderWidth, look.borderStyle, Qt::FlatCap));
+        qreal half = look.borderWidth / 2.0;
+        QRectF b(rect);
+        if (look.borderSides & Qt::TopEdge) painter->drawLine(QPointF(b.left(), b.top() + half), QPointF(b.right(), b.top() + half));
+        if (look.borderSides & Qt::BottomEdge) painter->drawLine(QPointF(b.left(), b.bottom() - half), QPointF(b.right(), b.bottom() - half));
+        if (look.borderSides & Qt::LeftEdge) painter->drawLine(QPointF(b.left() + half, b.top()), QPointF(b.left() + half, b.bottom()));
+        if (look.borderSides & Qt::RightEdge) painter->drawLine(QPointF(b.right() - half, b.top()), QPointF(b.right() - half, b.bottom()));
+    }
+
+    if (checked && look.checkedBar.isValid()) {
+        painter->fillRect(QRect(rect.left(), rect.bottom() - 2, rect.width(), 3), look.checkedBar);
+    }
+    painter->restore();
+}
+
+void BrandStyle::drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter,
+                               const QWidget *widget) const
+{
+    Look look;
+    switch (element) {
+    case PE_Widget:
+        // 带 WA_StyledBackground 的控件在 paintEvent 之前会来这里画背景
+        if (lookOf(widget, &look)) {
+            drawLook(painter, option->rect, look, false, false);
+            return;
+        }
+        break;
+    case PE_PanelButtonCommand:
+    case PE_FrameFocusRect:
+        if (lookOf(widget, &look)) return;
+        break;
+    case PE_PanelLineEdit:
+        if (qobject_cast<const QLineEdit *>(widget)) {
+            bool focused = option->state & State_HasFocus;
+            painter->save();
+            painter->setRenderHint(QPainter::Antialiasing);
+            painter->setPen(QPen(QColor(focused ? "#FF8C00" : "#D7CCC8"), LINE_EDIT_BORDER));
+            painter->setBrush(QColor(focused ? "#FFFDE7" : "#FFFFFF"));
+            qreal half = LINE_EDIT_BORDER / 2.0;
+            painter->drawRoundedRect(QRectF(option->rect).adjusted(half, half, -half, -half), LINE_EDIT_RADIUS, LINE_EDIT_RADIUS);
+            painter->restore();
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    QProxyStyle::drawPrimitive(element, option, painter, widget);
+}
+
+void BrandStyle::drawControl(ControlElement element, const QStyleOption *option, QPainter *painter,
+                             const QWidget *widget) const
+{
+    Look look;
+    switch (element) {
+    case CE_PushButtonBevel:
+        if (lookOf(widget, &look)) {
+            drawLook(painter, option->rect, look, option->state & State_Sunken, option->state & State_On);
+            return;
+        }
+        break;
+    case CE_PushButtonLabel:
+        if (lookOf(widget, &look) && (option->state & State_On) && look.checkedText.isValid()) {
+            QStyleOptionButton button = *qstyleoption_cast<const QStyleOptionButton *>(option);
+            button.palette.setColor(QPalette::ButtonText, look.checkedText);
+            painter->save();
+            QFont font = painter->font();
+            font.setBold(true);
+            painter->setFont(font);
+            QProxyStyle::drawControl(element, &button, painter, widget);
+            painter->restore();
+            return;
+        }
+        break;
+    case CE_HeaderSection:
+        // 表头平铺底色，不画立体分隔
+        painter->fillRect(option->rect, option->palette.base());
+        return;
+    default:
+        break;
+    }
+    QProxyStyle::drawControl(element, option, painter, widget);
+}
+
+void BrandStyle::drawComplexControl(ComplexControl control, const QStyleOptionComplex *option, QPainter *painter,
+                                    const QWidget *widget) const
+{
+    const QStyleOptionSlider *slider = qstyleoption_cast<const QStyleOptionSlider *>(option);
+    if (control == CC_Slider && slider && slider->orientation == Qt::Horizontal) {
+        QRect groove = subControlRect(control, option, SC_SliderGroove, widget);
+        QRect handle = subControlRect(control, option, SC_SliderHandle, widget);
+        painter->save();
+        painter->setRenderHint(QPainter::Antialiasing);
+        painter->setPen(QColor("#444444"));
+        painter->setBrush(QColor("#333333"));
+        painter->drawRoundedRect(QRectF(groove).adjusted(0.5, 0.5, -0.5, -0.5), SLIDER_GROOVE_HEIGHT / 2, SLIDER_GROOVE_HEIGHT / 2);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(QColor("#FF8C00"));
+        painter->drawEllipse(handle);
+        painter->restore();
+        return;
+    }
+    QProxyStyle::drawComplexControl(control, option, painter, widget);
+}
+
+QRect BrandStyle::subControlRect(ComplexControl control, const QStyleOptionComplex *option, SubControl sc,
+                                 const QWidget *widget) const
+{
+    const QStyleOptionSlider *slider = qstyleoption_cast<const QStyleOptionSlider *>(option);
+    if (control == CC_Slider && slider && slider->orientation == Qt::Horizontal) {
+        const QRect &r = option->rect;
+        switch (sc) {
+        case SC_SliderGroove:
+            return QRect(r.x(), r.center().y() - SLIDER_GROOVE_HEIGHT / 2, r.width(), SLIDER_GROOVE_HEIGHT);
+        case SC_SliderHandle: {
+            int pos = sliderPositionFromValue(slider->minimum, slider->maximum, slider->sliderPosition,
+                                              r.width() - SLIDER_HANDLE_SIZE, slider->upsideDown);
+            return QRect(r.x() + pos, r.center().y() - SLIDER_HANDLE_SIZE / 2, SLIDER_HANDLE_SIZE, SLIDER_HANDLE_SIZE);
+        }
+        default:
+            break;
+        }
+    }
+    return QProxyStyle::subControlRect(control, option, sc, widget);
+}
+
+QRect BrandStyle::subElementRect(SubElement element, const QStyleOption *option, const QWidget *widget) const
+{
+    if (element == SE_LineEditContents) {
+        int inset = LINE_EDIT_BORDER + LINE_EDIT_PADDING;
+        return option->rect.adjusted(inset, LINE_EDIT_BORDER, -inset, -LINE_EDIT_BORDER);
+    }
+    return QProxyStyle::subElementRect(element, option, widget);
+}
+
+QSize BrandStyle::sizeFromContents(ContentsType type, const QStyleOption *option, const QSize &size,
+                                   const QWidget *widget) const
+{
+    if (type == CT_LineEdit) {
+        int inset = 2 * (LINE_EDIT_BORDER + LINE_EDIT_PADDING);
+        return QSize(size.width() + inset, size.height() + inset);
+    }
+    if (type == CT_PushButton) {
+        Look look;
+        if (lookOf(widget, &look)) {
+            // 原样式表按钮的 padding: 10px，再加上底部立体边
+            return QSize(size.width() + 20, size.height() + 20 + look.edgeWidth);
+        }
+    }
+    return QProxyStyle::sizeFromContents(type, option, size, widget);
+}
+
+int BrandStyle::pixelMetric(PixelMetric metric, const QStyleOption *option, const QWidget *widget) const
+{
+    Look look;
+    switch (metric) {
+    case PM_ButtonShiftVertical:
+        // 有立体边的按钮按下时文字跟着填充区下移
+        if (lookOf(widget, &look)) return look.edgeColor.isValid() ? look.edgeWidth : 0;
+        break;
+    case PM_ButtonShiftHorizontal:
+        if (lookOf(widget, &look)) return 0;
+        break;
+    case PM_SliderLength:
+    case PM_SliderThickness:
+        return SLIDER_HANDLE_SIZE;
+    default:
+        break;
+    }
+    return QProxyStyle::pixelMetric(metric, option, widget);
+}
+
+int BrandStyle::styleHint(StyleHint hint, const QStyleOption *option, const QWidget *widget,
+                          QStyleHintReturn *returnData) const
+{
+    if (hint == SH_Table_GridLineColor) return (int)QColor("#F0F0F0").rgba();
+    return QProxyStyle::styleHint(hint, option, widget, returnData);
+}
+
+// --- 性能测试 ---
+// 改造前的全局样式表和菜品行样式表，只留着做对比
+static const char *LEGACY_APP_QSS =
+        "QWidget { background-color: #FFF5E6; color: #5D4037; font-family: 'Microsoft YaHei'; font-size: 18px; }"
+        "QLineEdit { border: 2px solid #D7CCC8; border-radius: 8px; padding: 10px; background-color: white; font-size: 20px; }"
+        "QLineEdit:focus { border: 2px solid #FF8C00; background-color: #FFFDE7; }"
+        "QPushButton { background-color: #FF8C00; color: white; border-radius: 10px; padding: 10px; font-weight: bold; font-size: 20px; border-bottom: 4px solid #E65100; }"
+        "QPushButton:pressed { background-color: #E65100; border-bottom: 0px; margin-top: 4px; }"
+        "QPushButton#SecondaryButton { background-color: #A1887F; border-bottom: 4px solid #5D4037; }"
+        "QPushButton#SecondaryButton:pressed { background-color: #8D6E63; border-bottom: 0px; margin-top: 4px; }"
+        "QLabel#Title { font-size: 32px; font-weight: bold; color: #BF360C; }";
+
+static QWidget *buildBenchRow(QWidget *parent, bool legacy)
+{
+    QWidget *row = new QWidget(parent);
+    row->setFixedHeight(125);
+    QHBoxLayout *layout = new QHBoxLayout(row);
+    QLabel *image = new QLabel(row);
+    image->setFixedSize(80, 80);
+    QVBoxLayout *info = new QVBoxLayout();
+    QLabel *name = new QLabel(QStringLiteral("招牌鳗鱼饭"), row);
+    QLabel *desc = new QLabel(QStringLiteral("主厨推荐 | 现点现做"), row);
+    QLabel *price = new QLabel("58", row);
+    QPushButton *minus = new QPushButton(QStringLiteral("－"), row);
+    QLabel *count = new QLabel("0", row);
+    QPushButton *add = new QPushButton(QStringLiteral("＋"), row);
+    minus->setFixedSize(28, 28);
+    add->setFixedSize(28, 28);
+
+    if (legacy) {
+        row->setStyleSheet("background-color: white; border-bottom: 1px solid #F0F0F0;");
+        image->setStyleSheet("border: 1px solid #EEE; border-radius: 4px;");
+        name->setStyleSheet("font-size: 16px; color: #222; border: none; font-weight: bold;");
+        desc->setStyleSheet("font-size: 12px; color: #888; border: none;");
+        price->setStyleSheet("font-size: 24px; color: #FF4D4F; font-weight: bold; border: none; font-family: 'Arial';");
+        minus->setStyleSheet("QPushButton { border: 1px solid #DDD; background: white; color: #888; font-size: 18px; border-radius: 14px; font-weight: bold; }"
+                             "QPushButton:pressed { background: #EEE; }");
+        count->setStyleSheet("color: #333; font-size: 16px; border: none; font-weight: bold;");
+        add->setStyleSheet("QPushButton { border: none; background-color: #FFD161; color: #333; font-size: 18px; border-radius: 14px; font-weight: bold; }"
+                           "QPushButton:pressed { background-color: #FBC02D; }");
+    } else {
+        BrandStyle::setPanel(row, BrandStyle::Look(Qt::white).border(QColor("#F0F0F0"), 1, Qt::BottomEdge));
+        BrandStyle::setPanel(image, BrandStyle::Look(QColor(), 4).border(QColor("#EEEEEE")));
+        BrandStyle::setText(name, QColor("#222222"), 16, true);
+        BrandStyle::setText(desc, QColor("#888888"), 12);
+        BrandStyle::setText(price, QColor("#FF4D4F"), 24, true, "Arial");
+        BrandStyle::setButton(minus, BrandStyle::Look(Qt::white, 14).pressed(QColor("#EEEEEE")).border(QColor("#DDDDDD")),
+                              QColor("#888888"), 18, true);
+        BrandStyle::setText(count, QColor("#333333"), 16, true);
+        BrandStyle::setButton(add, BrandStyle::Look(QColor("#FFD161"), 14).pressed(QColor("#FBC02D")), QColor("#333333"), 18, true);
+    }
+
+    layout->addWidget(image);
+    info->addWidget(name);
+    info->addWidget(desc);
+    layout->addLayout(info);
+    layout->addStretch();
+    layout->addWidget(price);
+    layout->addWidget(minus);
+    layout->addWidget(count);
+    layout->addWidget(add);
+    return row;
+}
+
+void BrandStyle::runBenchmark(int rows)
+{
+    install(qApp);
+    const int repaints = 50;
+    QImage frame(650, 480, QImage::Format_ARGB32_Premultiplied);
+
+    for (int legacy = 1; legacy >= 0; --legacy) {
+        qApp->setStyleSheet(legacy ? LEGACY_APP_QSS : "");
+
+        QElapsedTimer timer;
+        timer.start();
+        QWidget page;
+        QVBoxLayout *layout = new QVBoxLayout(&page);
+        for (int i = 0; i < rows; ++i) layout->addWidget(buildBenchRow(&page, legacy));
+        // 界面显示时才会 polish，这里手动触发，算进构造时间
+        for (QWidget *child : page.findChildren<QWidget *>()) child->ensurePolished();
+        page.resize(650, rows * 125);
+        layout->activate();
+        qint64 buildNs = timer.nsecsElapsed();
+
+        timer.restart();
+        for (int i = 0; i < repaints; ++i) page.render(&frame, QPoint(), QRegion(0, 0, 650, 480));
+        qint64 paintNs = timer.nsecsElapsed();
+
+        qDebug().noquote() << QString("[UI] %1: build %2 rows %3 ms (%4 us/row), repaint 480px %5 ms/frame")
+                              .arg(legacy ? "stylesheet" : "BrandStyle ").arg(rows)
+                              .arg(buildNs / 1e6, 0, 'f', 1).arg(buildNs / 1e3 / rows, 0, 'f', 0)
+                              .arg(paintNs / 1e6 / repaints, 0, 'f', 2);
+    }
+    qApp->setStyleSheet("");
+}
+
+// --- BrandItemDelegate ---
+BrandItemDelegate::BrandItemDelegate(int rowHeight, int pixelSize, const QColor &text, QObject *parent)
+    : QStyledItemDelegate(parent), m_rowHeight(rowHeight), m_pixelSize(pixelSize),
+      m_paddingLeft(0), m_paddingRight(0), m_text(text), m_selectedBarWidth(0)
+{
+}
+
+void BrandItemDelegate::setPadding(int left, int right)
+{
+    m_paddingLeft = left;
+    m_paddingRight = right;
+}
+
+void BrandItemDelegate::setDivider(const QColor &color)
+{
+    m_divider = color;
+}
+
+void BrandItemDelegate::setSelected(const QColor &fill, const QColor &text, const QColor &bar, int barWidth)
+{
+    m_selectedFill = fill;
+    m_selectedText = text;
+    m_selectedBar = bar;
+    m_selectedBarWidth = barWidth;
+}
+
+void BrandItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const QRect &r = option.rect;
+    bool selected = (option.state & QStyle::State_Selected) && m_selectedFill.isValid();
+
+    painter->save();
+    if (selected) {
+        painter->fillRect(r, m_selectedFill);
+        if (m_selectedBarWidth > 0) painter->fillRect(QRect(r.left(), r.top(), m_selectedBarWidth, r.height()), m_selectedBar);
+    }
+    if (m_divider.isValid()) painter->fillRect(QRect(r.left(), r.bottom(), r.width(), 1), m_divider);
+
+    QRect content = r.adjusted(m_paddingLeft + (selected ? m_selectedBarWidth : 0), 0, -m_paddingRight, 0);
+    QIcon icon = index.data(Qt::DecorationRole).value<QIcon>();
+    if (!icon.isNull()) {
+        QSize size = option.decorationSize;
+        QRect iconRect(content.left(), r.center().y() - size.height() / 2 + 1, size.width(), size.height());
+        icon.paint(painter, iconRect);
+        content.setLeft(iconRect.right() + 1 + 4);
+    }
+
+    QFont font = option.font;
+    font.setPixelSize(m_pixelSize);
+    font.setBold(selected);
+    painter->setFont(font);
+    painter->setPen(selected ? m_selectedText : m_text);
+    painter->drawText(content, Qt::AlignLeft | Qt::AlignVCenter, index.data(Qt::DisplayRole).toString());
+    painter->restore();
+}
+
+QSize BrandItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    return QSize(QStyledItemDelegate::sizeHint(option, index).width(), m_rowHeight);
+}
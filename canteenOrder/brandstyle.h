@@ -0,0 +1,108 @@
+#ifndef BRANDSTYLE_H
+#define BRANDSTYLE_H
+
+#include <QProxyStyle>
+#include <QStyledItemDelegate>
+#include <QColor>
+#include <QMetaType>
+
+class QApplication;
+class QAbstractButton;
+
+// 品牌主题 (暖橙 / 咖啡色)
+// 原来的全局 QSS 加上各控件自己的 setStyleSheet，每次 polish 都要重新匹配规则，
+// 在 ARM 上建一行菜品、重绘一次都很慢。现在外观全部由本样式按调色板、字体和控件上挂的 Look 直接绘制，
+// 构造控件时不再解析任何样式表
+class BrandStyle : public QProxyStyle
+{
+    Q_OBJECT
+public:
+    // 面板 / 按钮的外观，挂在控件的动态属性上，绘制时读取
+    struct Look {
+        QColor fillColor;       // 无效表示透明
+        QColor pressedColor;    // 按下时的填充色，无效表示不变
+        QColor borderColor;     // 无效表示无边框
+        int borderWidth;
+        int borderSides;        // Qt::Edges，0 表示四周 (跟着圆角走)
+        Qt::PenStyle borderStyle;
+        QColor edgeColor;       // 底部立体边，按下时消失、内容下移
+        int edgeWidth;
+        QColor checkedText;     // 可选中按钮选中时：文字颜色加粗，底部画一条色条
+        QColor checkedBar;
+        int radius;
+
+        explicit Look(const QColor &fill = QColor(), int radius = 0);
+        Look &pressed(const QColor &color);
+        Look &border(const QColor &color, int width = 1, int sides = 0, Qt::PenStyle style = Qt::SolidLine);
+        Look &edge(const QColor &color, int width);
+        Look &checked(const QColor &text, const QColor &bar);
+    };
+
+    BrandStyle();
+
+    // 安装样式、全局调色板和字体，要在创建任何窗口之前调用
+    static void install(QApplication *app);
+
+    // 以下在构造控件时调用，代替原来的 setStyleSheet
+    static void setPanel(QWidget *widget, const Look &look);
+    static void setButton(QAbstractButton *button, const Look &look, const QColor &text, int pixelSize, bool bold = false);
+    static void setText(QWidget *widget, const QColor &color, int pixelSize, bool bold = false,
+                        const QString &family = QString());
+
+    // 性能测试：同样的菜品行分别用样式表和本样式构造、绘制，对比耗时 (启动参数 --bench-ui)
+    static void runBenchmark(int rows = 200);
+
+    QPalette standardPalette() const override;
+    void polish(QWidget *widget) override;
+    using QProxyStyle::polish;
+
+    void drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter,
+                       const QWidget *widget = nullptr) const override;
+    void drawControl(ControlElement element, const QStyleOption *option, QPainter *painter,
+                     const QWidget *widget = nullptr) const override;
+    void drawComplexControl(ComplexControl control, const QStyleOptionComplex *option, QPainter *painter,
+                            const QWidget *widget = nullptr) const override;
+    QRect subControlRect(ComplexControl control, const QStyleOptionComplex *option, SubControl sc,
+                         const QWidget *widget = nullptr) const override;
+    QRect subElementRect(SubElement element, const QStyleOption *option, const QWidget *widget = nullptr) const override;
+    QSize sizeFromContents(ContentsType type, const QStyleOption *option, const QSize &size,
+                           const QWidget *widget = nullptr) const override;
+    int pixelMetric(PixelMetric metric, const QStyleOption *option = nullptr, const QWidget *widget = nullptr) const override;
+    int styleHint(StyleHint hint, const QStyleOption *option = nullptr, const QWidget *widget = nullptr,
+                  QStyleHintReturn *returnData = nullptr) const override;
+
+private:
+    static bool lookOf(const QWidget *widget, Look *look);
+    static void drawLook(QPainter *painter, const QRect &rect, const Look &look, bool pressed, bool checked);
+};
+
+Q_DECLARE_METATYPE(BrandStyle::Look)
+
+// 纯文字列表的行：固定行高、底部分隔线，选中行换底色、文字加粗、左侧画色条
+// 代替 QListWidget::item 的样式表规则
+class BrandItemDelegate : public QStyledItemDelegate
+{
+public:
+    BrandItemDelegate(int rowHeight, int pixelSize, const QColor &text, QObject *parent = nullptr);
+
+    void setPadding(int left, int right);
+    void setDivider(const QColor &color);
+    void setSelected(const QColor &fill, const QColor &text, const QColor &bar, int barWidth);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    int m_rowHeight;
+    int m_pixelSize;
+    int m_paddingLeft;
+    int m_paddingRight;
+    QColor m_text;
+    QColor m_divider;
+    QColor m_selectedFill;
+    QColor m_selectedText;
+    QColor m_selectedBar;
+    int m_selectedBarWidth;
+};
+
+#endif // BRANDSTYLE_H
@@ -1,4 +1,4 @@
-QT       += core gui sql network
+QT       += core gui sql network concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -19,35 +19,78 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    backupjob.cpp \
+    boottrace.cpp \
+    brandstyle.cpp \
     dbmanager.cpp \
+    hardwarebackend.cpp \
     hardwarecontrol.cpp \
     haveordered.cpp \
+    lazypagestack.cpp \
     login.cpp \
     main.cpp \
     maininterface.cpp \
     mainwindow.cpp \
+    mediaproxy.cpp \
+    menucatalog.cpp \
     minimqtt.cpp \
+    orderexport.cpp \
+    orderpublisher.cpp \
     orderwidget.cpp \
+    passwordhasher.cpp \
     paywidget.cpp \
+    playbackposition.cpp \
+    postercache.cpp \
+    qrcode.cpp \
     register.cpp \
+    salesstats.cpp \
+    segmentcache.cpp \
     settlewidget.cpp \
+    simbackend.cpp \
     softkeyboard.cpp \
-    videowidget.cpp
+    startup.cpp \
+    toastmanager.cpp \
+    uilagprobe.cpp \
+    videoio.cpp \
+    videowidget.cpp \
+    yuvconvert.cpp
 
 HEADERS += \
+    backupjob.h \
+    boottrace.h \
+    brandstyle.h \
     dbmanager.h \
+    hardwarebackend.h \
     hardwarecontrol.h \
     haveordered.h \
+    lazypagestack.h \
     login.h \
     maininterface.h \
     mainwindow.h \
+    mediaproxy.h \
+    menucatalog.h \
     minimqtt.h \
+    orderexport.h \
+    orderpublisher.h \
     orderwidget.h \
+    passwordhasher.h \
     paywidget.h \
+    playbackposition.h \
+    postercache.h \
+    qrcode.h \
     register.h \
+    salesstats.h \
+    segmentcache.h \
     settlewidget.h \
+    simbackend.h \
     softkeyboard.h \
-    videowidget.h
+    spscring.h \
+    startup.h \
+    toastmanager.h \
+    uilagprobe.h \
+    videoio.h \
+    videowidget.h \
+    yuvconvert.h
 
 FORMS += \
     mainwindow.ui
@@ -65,3 +108,48 @@ RESOURCES += \
 */
 DEFINES += MQTT_IP=\\\"47.108.190.17\\\" \
             MQTT_PORT=1883
+
+# 数据库定时备份
+#   Qt 用 -system-sqlite 编译时打开 HAVE_SQLITE_BACKUP，从 QSQLITE 驱动取句柄调 SQLite 的 backup API 增量拷贝；
+#   Qt 用自带的 SQLite (默认) 时不能再链接一份 libsqlite3 (同一个文件上两份库会互相释放对方的锁)，
+#   备份改用 VACUUM INTO / 写锁下拷贝文件
+#   BACKUP_DIR：快照目录
+#   BACKUP_KEEP：保留的快照个数
+#   BACKUP_INTERVAL_MIN：备份间隔 (分钟)
+contains(QT_CONFIG, system-sqlite) {
+    DEFINES += HAVE_SQLITE_BACKUP
+    LIBS += -lsqlite3
+}
+DEFINES += BACKUP_DIR=\\\"/workdir/backup\\\" \
+            BACKUP_KEEP=7 \
+            BACKUP_INTERVAL_MIN=60
+
+# 日结导出目录 (列式订单文件)
+DEFINES += EXPORT_DIR=\\\"/workdir/reports\\\"
+
+# 启动时间线 (JSON)，用 --boot-diff 旧文件 新文件 对比两个版本
+DEFINES += BOOT_TRACE_FILE=\\\"/workdir/log/boot-trace.json\\\"
+
+# 主界面页面释放：每 MEMORY_CHECK_MS 毫秒看一次 MemAvailable，低于 MEMORY_LOW_MB 时释放后台的视频页
+DEFINES += MEMORY_CHECK_MS=30000 \
+            MEMORY_LOW_MB=48
+
+# 菜品视频目录，以及视频海报帧 (列表缩略图) 的磁盘缓存目录
+DEFINES += VIDEO_DIR=\\\"/workdir/videos\\\" \
+            POSTER_CACHE_DIR=\\\"/workdir/cache/posters\\\"
+
+# 网络视频的磁盘分段缓存 (LRU)
+#   MEDIA_CACHE_DIR：缓存目录
+#   MEDIA_CACHE_MB：容量上限 (MB)
+DEFINES += MEDIA_CACHE_DIR=\\\"/workdir/cache/media\\\" \
+            MEDIA_CACHE_MB=1024
+
+# 进程内视频解码 (libavcodec)：qmake CONFIG+=ffmpeg 打开，否则仍然调用 mplayer
+#   DISH_VIDEO_MUTE：1 = 菜品视频静音播放 (丢弃音轨)；0 = 带音轨的片子交给 mplayer 出声
+ffmpeg {
+    DEFINES += HAVE_FFMPEG \
+                DISH_VIDEO_MUTE=1
+    LIBS += -lavformat -lavcodec -lswscale -lavutil
+    SOURCES += videodecoder.cpp
+    HEADERS += videodecoder.h
+}
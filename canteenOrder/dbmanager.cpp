@@ -1,10 +1,237 @@
 #include "dbmanager.h"
+#include "passwordhasher.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QMessageAuthenticationCode>
+#include <QtConcurrent>
+
+// === SQLite 调优参数 ===
+// 开发板使用 eMMC/SD 卡，默认的回滚日志 + synchronous=FULL 每次提交都要多次 fsync
+// WAL 模式下提交只追加写日志，NORMAL 级别只在 checkpoint 时 fsync，掉电最多丢失最后一次提交
+static const char *TUNING_PRAGMAS[] = {
+    "PRAGMA journal_mode = WAL",
+    "PRAGMA synchronous = NORMAL",
+    "PRAGMA mmap_size = 33554432",  // 32MB 内存映射读
+    "PRAGMA cache_size = -4096",    // 4MB 页缓存 (负数表示 KB)
+    "PRAGMA temp_store = MEMORY"
+};
+
+// 数据库结构版本，记录在 PRAGMA user_version 中
+// v1: users 表由明文口令改为 salt + iterations + pw_hash
+// v2: orders 表增加 order_no (下单时生成、写进订单 JSON 和支付二维码的订单号)
+static const int SCHEMA_VERSION = 2;
+
+static const char *DB_FILE = "restaurant.db"; // 数据库文件将生成在运行目录
+
+// 已验证口令的缓存时长：同一班次内重复登录直接命中，不再跑 KDF
+static const qint64 VERIFIED_CACHE_TTL_MS = 2 * 60 * 60 * 1000;
+
+static const char *SQL_INSERT_USER  = "INSERT INTO users (username, salt, iterations, pw_hash) VALUES (:name, :salt, :iter, :hash)";
+static const char *SQL_LOGIN        = "SELECT salt, iterations, pw_hash FROM users WHERE username = :name";
+static const char *SQL_INSERT_ORDER = "INSERT INTO orders (table_no, order_no, total_cents, created_at) VALUES (:table, :no, :total, :ts)";
+static const char *SQL_INSERT_ITEM  = "INSERT INTO order_items (order_id, dish, qty, unit_cents) VALUES (:oid, :dish, :qty, :unit)";
+// 旧版 SQLite 没有 UPSERT，用 INSERT OR IGNORE + UPDATE 两步完成累加
+static const char *SQL_ENSURE_SALES = "INSERT OR IGNORE INTO dish_sales_daily (dish, day, qty) VALUES (:dish, :day, 0)";
+static const char *SQL_ADD_SALES    = "UPDATE dish_sales_daily SET qty = qty + :qty WHERE dish = :dish AND day = :day";
+static const char *SQL_QUEUE_OUTBOX = "INSERT OR IGNORE INTO order_outbox (order_no, topic, payload, created_at) VALUES (:no, :topic, :payload, :ts)";
+static const char *SQL_DROP_OUTBOX  = "DELETE FROM order_outbox WHERE order_no = :no";
+
+// 对指定连接应用调优参数 (每个连接都要单独设置)
+static void applyTuningProfile(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    for (const char *pragma : TUNING_PRAGMAS) {
+        if (!query.exec(pragma)) {
+            qDebug() << "Pragma error:" << pragma << query.lastError();
+        }
+    }
+}
+
+static void createSchema(QSqlDatabase &db)
+{
+    QStringList sqls;
+    // 用户表
+    sqls << "CREATE TABLE IF NOT EXISTS users ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "username TEXT UNIQUE, "
+            "password TEXT)";
+    // 订单表 (金额统一以分为单位存储，避免浮点误差)
+    sqls << "CREATE TABLE IF NOT EXISTS orders ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "table_no INTEGER, "
+            "total_cents INTEGER, "
+            "created_at INTEGER)";   // 毫秒时间戳
+    sqls << "CREATE TABLE IF NOT EXISTS order_items ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "order_id INTEGER, "
+            "dish TEXT, "
+            "qty INTEGER, "
+            "unit_cents INTEGER)";
+    // 销量聚合表：每道菜每天一行，滚动窗口只需读取最近 30 个桶，不用扫描订单明细
+    sqls << "CREATE TABLE IF NOT EXISTS dish_sales_daily ("
+            "dish TEXT, "
+            "day INTEGER, "
+            "qty INTEGER, "
+            "PRIMARY KEY (dish, day))";
+    // 待发给后厨的订单：先落库再发，收到 PUBACK 才删除，断网 / 重启后接着发
+    sqls << "CREATE TABLE IF NOT EXISTS order_outbox ("
+            "order_no TEXT PRIMARY KEY, "
+            "topic TEXT, "
+            "payload TEXT, "
+            "created_at INTEGER)";
+    sqls << "CREATE INDEX IF NOT EXISTS idx_orders_created ON orders (created_at)";
+    sqls << "CREATE INDEX IF NOT EXISTS idx_items_order ON order_items (order_id)";
+
+    QSqlQuery query(db);
+    for (const QString &sql : sqls) {
+        if (!query.exec(sql)) {
+            qDebug() << "Create table error:" << query.lastError();
+        }
+    }
+}
+
+static bool migrateSchema(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    int version = 0;
+    if (query.exec("PRAGMA user_version") && query.next()) {
+        version = query.value(0).toInt();
+    }
+    query.finish();
+    if (version >= SCHEMA_VERSION) return true;
+
+    // v0 -> v1 要把明文口令逐个跑 KDF。先在事务外读出旧口令并算好哈希，
+    // 写事务里只剩 ALTER / UPDATE，不会因为 KDF 长时间占着写锁。
+    // 正常启动时这里在 prepareDatabase 的后台线程执行，不占 GUI 线程
+    struct LegacyRow { qint64 id; QByteArray salt; QByteArray hash; };
+    QList<LegacyRow> legacy;
+    if (version < 1) {
+        if (!query.exec("SELECT id, password FROM users WHERE password IS NOT NULL")) {
+            qDebug() << "Migrate error:" << query.lastError();
+            return false;
+        }
+        while (query.next()) {
+            LegacyRow row;
+            row.id = query.value(0).toLongLong();
+            row.salt = PasswordHasher::generateSalt();
+            row.hash = PasswordHasher::hash(query.value(1).toString(), row.salt, PasswordHasher::DEFAULT_ITERATIONS);
+            legacy.append(row);
+        }
+        query.finish();
+    }
+
+    if (!db.transaction()) {
+        qDebug() << "Migrate error: begin transaction" << db.lastError();
+        return false;
+    }
+    bool ok = true;
+    if (version < 1) {
+        // 新增哈希列，写入转换结果后清空明文
+        // SQLite 不支持 DROP COLUMN，旧的 password 列保留但不再写入
+        ok = query.exec("ALTER TABLE users ADD COLUMN salt BLOB")
+          && query.exec("ALTER TABLE users ADD COLUMN iterations INTEGER")
+          && query.exec("ALTER TABLE users ADD COLUMN pw_hash BLOB");
+        if (!ok) qDebug() << "Migrate error:" << query.lastQuery() << query.lastError();
+
+        QSqlQuery update(db);
+        if (ok && !update.prepare("UPDATE users SET salt = :salt, iterations = :iter, pw_hash = :hash, password = NULL WHERE id = :id")) {
+            qDebug() << "Migrate error:" << update.lastError();
+            ok = false;
+        }
+        for (int i = 0; ok && i < legacy.size(); ++i) {
+            update.bindValue(":salt", legacy[i].salt);
+            update.bindValue(":iter", PasswordHasher::DEFAULT_ITERATIONS);
+            update.bindValue(":hash", legacy[i].hash);
+            update.bindValue(":id", legacy[i].id);
+            if (!update.exec()) {
+                qDebug() << "Migrate user error:" << update.lastError();
+                ok = false;
+            }
+        }
+        if (ok) qDebug() << "Schema v1: hashed" << legacy.size() << "legacy password(s)";
+    }
+    if (ok && version < 2) {
+        // 旧订单没有订单号，保持 NULL；唯一索引不约束 NULL
+        ok = query.exec("ALTER TABLE orders ADD COLUMN order_no TEXT")
+          && query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_orders_no ON orders (order_no)");
+        if (!ok) qDebug() << "Migrate error:" << query.lastQuery() << query.lastError();
+    }
+    if (ok && !query.exec(QString("PRAGMA user_version = %1").arg(SCHEMA_VERSION))) {
+        qDebug() << "Migrate error:" << query.lastError();
+        ok = false;
+    }
+
+    // 任何一步失败都整体回滚：不能留下加了列却没写哈希、明文还在的半成品，下次启动重新迁移
+    if (ok && db.commit()) return true;
+    if (ok) qDebug() << "Migrate error: commit" << db.lastError();
+    db.rollback();
+    return false;
+}
+
+// 在一个事务内写入订单头和明细，语句由调用方提供 (可以是缓存的，也可以是临时 prepare 的)
+static qint64 writeOrder(QSqlDatabase &db, QSqlQuery &orderQuery, QSqlQuery &itemQuery,
+                         int tableNo, const QString &orderNo,
+                         const QMap<QString, int> &cart, const QMap<QString, double> &prices)
+{
+    if (cart.isEmpty()) return -1;
+
+    qint64 totalCents = 0;
+    QMapIterator<QString, int> i(cart);
+    while (i.hasNext()) {
+        i.next();
+        totalCents += qRound64(prices.value(i.key(), 0) * 100) * i.value();
+    }
+
+    if (!db.transaction()) {
+        qDebug() << "Begin transaction error:" << db.lastError();
+        return -1;
+    }
+
+    orderQuery.bindValue(":table", tableNo);
+    orderQuery.bindValue(":no", orderNo);   // 性能测试传 null QString，写成 NULL
+    orderQuery.bindValue(":total", totalCents);
+    orderQuery.bindValue(":ts", QDateTime::currentMSecsSinceEpoch());
+    if (!orderQuery.exec()) {
+        qDebug() << "Save order error:" << orderQuery.lastError();
+        db.rollback();
+        return -1;
+    }
+    qint64 orderId = orderQuery.lastInsertId().toLongLong();
+
+    i.toFront();
+    while (i.hasNext()) {
+        i.next();
+        itemQuery.bindValue(":oid", orderId);
+        itemQuery.bindValue(":dish", i.key());
+        itemQuery.bindValue(":qty", i.value());
+        itemQuery.bindValue(":unit", qRound64(prices.value(i.key(), 0) * 100));
+        if (!itemQuery.exec()) {
+            qDebug() << "Save order item error:" << itemQuery.lastError();
+            db.rollback();
+            return -1;
+        }
+    }
+
+    if (!db.commit()) {
+        qDebug() << "Commit error:" << db.lastError();
+        db.rollback();
+        return -1;
+    }
+    return orderId;
+}
 
 DBManager::DBManager(QObject *parent) : QObject(parent)
 {
     // 初始化数据库连接，使用SQLite
     m_db = QSqlDatabase::addDatabase("QSQLITE");
-    m_db.setDatabaseName("restaurant.db"); // 数据库文件将生成在运行目录
+    m_db.setDatabaseName(DB_FILE);
+
+    // 已验证缓存的时间基准和 HMAC 密钥，只存在于本进程内存中
+    m_clock.start();
+    m_cacheKey = PasswordHasher::generateSalt(32);
 
     if(openDb()){
         initTable();
@@ -24,53 +251,344 @@ bool DBManager::openDb()
             qDebug() << "Error: connection with database failed";
             return false;
         }
+        // 连接刚建立，语句缓存中的旧语句已失效
+        m_stmtCache.clear();
+        applyTuningProfile(m_db);
     }
     return true;
 }
 
+QString DBManager::databasePath() const
+{
+    return QFileInfo(m_db.databaseName()).absoluteFilePath();
+}
+
 void DBManager::initTable()
 {
-    // 创建用户表
-    QSqlQuery query;
-    QString sql = "CREATE TABLE IF NOT EXISTS users ("
-                  "id INTEGER PRIMARY KEY AUTOINCREMENT, "
-                  "username TEXT UNIQUE, "
-                  "password TEXT)";
-    if (!query.exec(sql)) {
-        qDebug() << "Create table error:" << query.lastError();
+    createSchema(m_db);
+    if (!migrateSchema(m_db)) qDebug() << "Error: schema migration failed, rolled back";
+}
+
+bool DBManager::prepareDatabase()
+{
+    const QString connName = "startup";
+    bool ok;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connName);
+        db.setDatabaseName(DB_FILE);
+        ok = db.open();
+        if (ok) {
+            applyTuningProfile(db);
+            createSchema(db);
+            ok = migrateSchema(db);
+            db.close();
+        } else {
+            qDebug() << "Startup: open database failed" << db.lastError();
+        }
+    }
+    QSqlDatabase::removeDatabase(connName);
+    return ok;
+}
+
+// 取缓存的预编译语句，第一次使用时才 prepare
+QSqlQuery &DBManager::cachedQuery(const QString &sql)
+{
+    QHash<QString, QSqlQuery>::iterator it = m_stmtCache.find(sql);
+    if (it == m_stmtCache.end()) {
+        QSqlQuery query(m_db);
+        if (!query.prepare(sql)) {
+            qDebug() << "Prepare error:" << sql << query.lastError();
+        }
+        it = m_stmtCache.insert(sql, query);
     }
+    return it.value();
 }
 
-// 实现注册功能：保存用户到数据库
-bool DBManager::registerUser(const QString &username, const QString &password)
+// 实现注册功能 (异步)：KDF 交给线程池，算完回到 GUI 线程写库 (数据库连接属于 GUI 线程)
+void DBManager::registerUserAsync(const QString &username, const QString &password)
 {
-    if(username.isEmpty() || password.isEmpty()) return false;
+    if(username.isEmpty() || password.isEmpty()) {
+        emit registerFinished(username, false);
+        return;
+    }
+
+    QByteArray salt = PasswordHasher::generateSalt();
+    QFutureWatcher<QByteArray> *watcher = new QFutureWatcher<QByteArray>(this);
+    connect(watcher, &QFutureWatcher<QByteArray>::finished, this, [=]() {
+        QSqlQuery &query = cachedQuery(SQL_INSERT_USER);
+        query.bindValue(":name", username);
+        query.bindValue(":salt", salt);
+        query.bindValue(":iter", PasswordHasher::DEFAULT_ITERATIONS);
+        query.bindValue(":hash", watcher->result());
 
-    QSqlQuery query;
-    query.prepare("INSERT INTO users (username, password) VALUES (:name, :pass)");
+        bool ok = query.exec();
+        if (!ok) qDebug() << "Register error:" << query.lastError();
+        watcher->deleteLater();
+        emit registerFinished(username, ok);
+    });
+    watcher->setFuture(QtConcurrent::run([=]() {
+        return PasswordHasher::hash(password, salt, PasswordHasher::DEFAULT_ITERATIONS);
+    }));
+}
+
+// 查询用户的口令记录 (只查库，不做 KDF，耗时很短)
+bool DBManager::fetchCredential(const QString &username, Credential *out)
+{
+    QSqlQuery &query = cachedQuery(SQL_LOGIN);
     query.bindValue(":name", username);
-    query.bindValue(":pass", password); // 实际项目中建议加密存储
 
-    if(query.exec()){
-        return true;
+    bool found = query.exec() && query.next(); // 找到用户
+    if (found) {
+        out->salt = query.value(0).toByteArray();
+        out->iterations = query.value(1).toInt();
+        out->hash = query.value(2).toByteArray();
+    }
+    // 复用语句前必须 reset，否则会一直持有读锁，阻塞 WAL checkpoint
+    query.finish();
+    return found;
+}
+
+QByteArray DBManager::cacheDigest(const QString &username, const QString &password) const
+{
+    return QMessageAuthenticationCode::hash((username + QChar('\n') + password).toUtf8(),
+                                            m_cacheKey, QCryptographicHash::Sha256);
+}
+
+// 登录验证功能 (异步)
+// 1. 命中已验证缓存：立即返回
+// 2. 否则在 GUI 线程查出盐和哈希，把 KDF 计算交给线程池，完成后发出 loginFinished
+void DBManager::loginUserAsync(const QString &username, const QString &password)
+{
+    QByteArray digest = cacheDigest(username, password);
+    QHash<QString, VerifiedLogin>::iterator it = m_verifiedCache.find(username);
+    if (it != m_verifiedCache.end()) {
+        // 只在过期时删除；输错一次密码不应清掉刚验证过的条目，走完整校验即可
+        if (it->expireAt <= m_clock.elapsed()) {
+            m_verifiedCache.erase(it);
+        } else if (PasswordHasher::constantTimeEquals(it->digest, digest)) {
+            qDebug() << "Login: verified-credential cache hit for" << username;
+            emit loginFinished(username, true);
+            return;
+        }
+    }
+
+    Credential cred;
+    if (username.isEmpty() || !fetchCredential(username, &cred)) {
+        emit loginFinished(username, false);
+        return;
+    }
+
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [=]() {
+        bool ok = watcher->result();
+        if (ok) {
+            VerifiedLogin entry;
+            entry.digest = digest;
+            entry.expireAt = m_clock.elapsed() + VERIFIED_CACHE_TTL_MS;
+            m_verifiedCache.insert(username, entry);
+        }
+        watcher->deleteLater();
+        emit loginFinished(username, ok);
+    });
+    watcher->setFuture(QtConcurrent::run([=]() {
+        return PasswordHasher::verify(password, cred.salt, cred.iterations, cred.hash);
+    }));
+}
+
+qint64 DBManager::saveOrder(int tableNo, const QString &orderNo,
+                            const QMap<QString, int> &cart, const QMap<QString, double> &prices)
+{
+    if (!openDb()) return -1;
+
+    // 取副本 (与缓存共享同一条语句)：第二次 cachedQuery 可能触发 QHash 扩容，使第一个引用失效
+    QSqlQuery orderQuery = cachedQuery(SQL_INSERT_ORDER);
+    QSqlQuery itemQuery = cachedQuery(SQL_INSERT_ITEM);
+    return writeOrder(m_db, orderQuery, itemQuery, tableNo, orderNo, cart, prices);
+}
+
+bool DBManager::addDishSales(int day, const QMap<QString, int> &counts)
+{
+    if (counts.isEmpty() || !openDb()) return false;
+
+    QSqlQuery ensure = cachedQuery(SQL_ENSURE_SALES);
+    QSqlQuery add = cachedQuery(SQL_ADD_SALES);
+
+    m_db.transaction();
+    QMapIterator<QString, int> i(counts);
+    while (i.hasNext()) {
+        i.next();
+        ensure.bindValue(":dish", i.key());
+        ensure.bindValue(":day", day);
+        add.bindValue(":qty", i.value());
+        add.bindValue(":dish", i.key());
+        add.bindValue(":day", day);
+        if (!ensure.exec() || !add.exec()) {
+            qDebug() << "Add dish sales error:" << ensure.lastError() << add.lastError();
+            m_db.rollback();
+            return false;
+        }
+    }
+    return m_db.commit();
+}
+
+bool DBManager::queueOutbox(const QString &orderNo, const QString &topic, const QString &payload)
+{
+    if (!openDb()) return false;
+
+    QSqlQuery &query = cachedQuery(SQL_QUEUE_OUTBOX);
+    query.bindValue(":no", orderNo);
+    query.bindValue(":topic", topic);
+    query.bindValue(":payload", payload);
+    query.bindValue(":ts", QDateTime::currentMSecsSinceEpoch());
+    bool ok = query.exec();
+    if (!ok) qDebug() << "Queue outbox error:" << query.lastError();
+    return ok;
+}
+
+void DBManager::dropOutbox(const QString &orderNo)
+{
+    if (!openDb()) return;
+
+    QSqlQuery &query = cachedQuery(SQL_DROP_OUTBOX);
+    query.bindValue(":no", orderNo);
+    if (!query.exec()) qDebug() << "Drop outbox error:" << query.lastError();
+}
+
+QList<OutboxMessage> DBManager::loadOutbox()
+{
+    QList<OutboxMessage> messages;
+    if (!openDb()) return messages;
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT order_no, topic, payload FROM order_outbox ORDER BY created_at")) {
+        qDebug() << "Load outbox error:" << query.lastError();
+        return messages;
+    }
+    while (query.next()) {
+        OutboxMessage message;
+        message.orderNo = query.value(0).toString();
+        message.topic = query.value(1).toString();
+        message.payload = query.value(2).toString();
+        messages.append(message);
+    }
+    return messages;
+}
+
+QList<DishSalesBucket> DBManager::loadDishSales(int fromDay)
+{
+    QList<DishSalesBucket> buckets;
+    if (!openDb()) return buckets;
+
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM dish_sales_daily WHERE day < :day");
+    query.bindValue(":day", fromDay);
+    query.exec();
+
+    query.setForwardOnly(true);
+    query.prepare("SELECT dish, day, qty FROM dish_sales_daily WHERE day >= :day");
+    query.bindValue(":day", fromDay);
+    if (query.exec()) {
+        while (query.next()) {
+            DishSalesBucket b;
+            b.dish = query.value(0).toString();
+            b.day = query.value(1).toInt();
+            b.qty = query.value(2).toInt();
+            buckets.append(b);
+        }
     } else {
-        qDebug() << "Register error:" << query.lastError();
-        return false;
+        qDebug() << "Load dish sales error:" << query.lastError();
     }
+    return buckets;
 }
 
-// 登录验证功能
-bool DBManager::loginUser(const QString &username, const QString &password)
+// --- 性能测试 ---
+// 分别用 "默认参数 + 每次 prepare" 和 "调优参数 + 语句缓存" 两种方式，
+// 在独立的数据库文件上跑相同次数的登录和下单，输出每秒操作数
+void DBManager::runBenchmark(int rounds)
 {
-    QSqlQuery query;
-    query.prepare("SELECT username FROM users WHERE username = :name AND password = :pass");
-    query.bindValue(":name", username);
-    query.bindValue(":pass", password);
+    QMap<QString, int> cart;
+    cart.insert(QStringLiteral("招牌鳗鱼饭"), 1);
+    cart.insert(QStringLiteral("铁火卷"), 2);
+    cart.insert(QStringLiteral("经典可乐"), 1);
+    QMap<QString, double> prices;
+    prices.insert(QStringLiteral("招牌鳗鱼饭"), 58);
+    prices.insert(QStringLiteral("铁火卷"), 667);
+    prices.insert(QStringLiteral("经典可乐"), 273);
 
-    if(query.exec()){
-        if(query.next()){
-            return true; // 找到用户
+    for (int tuned = 0; tuned <= 1; ++tuned) {
+        const QString connName = tuned ? "bench_tuned" : "bench_default";
+        const QString fileName = connName + ".db";
+        QFile::remove(fileName);
+        QFile::remove(fileName + "-wal");
+        QFile::remove(fileName + "-shm");
+
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connName);
+            db.setDatabaseName(fileName);
+            if (!db.open()) {
+                qDebug() << "Benchmark: open failed" << db.lastError();
+                return;
+            }
+            if (tuned) applyTuningProfile(db);
+            createSchema(db);
+            migrateSchema(db);
+
+            QSqlQuery seed(db);
+            seed.prepare(SQL_INSERT_USER);
+            seed.bindValue(":name", "bench");
+            seed.bindValue(":salt", QByteArray(PasswordHasher::SALT_BYTES, 'x'));
+            seed.bindValue(":iter", 1);
+            seed.bindValue(":hash", QByteArray(PasswordHasher::KEY_BYTES, 'x'));
+            seed.exec();
+
+            QElapsedTimer timer;
+
+            // 1. 登录 (只测口令记录查询，KDF 耗时与数据库配置无关)
+            int hits = 0;
+            auto login = [&](QSqlQuery &query) {
+                query.bindValue(":name", "bench");
+                if (query.exec() && query.next()) ++hits;
+                query.finish();
+            };
+            QSqlQuery cachedLogin(db);
+            cachedLogin.prepare(SQL_LOGIN);
+            timer.start();
+            for (int n = 0; n < rounds; ++n) {
+                if (tuned) {
+                    login(cachedLogin);
+                } else {
+                    QSqlQuery fresh(db);
+                    fresh.prepare(SQL_LOGIN);
+                    login(fresh);
+                }
+            }
+            qint64 loginMs = qMax<qint64>(timer.elapsed(), 1);
+
+            // 2. 下单 (每单一个事务)
+            int saved = 0;
+            QSqlQuery cachedOrder(db), cachedItem(db);
+            cachedOrder.prepare(SQL_INSERT_ORDER);
+            cachedItem.prepare(SQL_INSERT_ITEM);
+            timer.start();
+            for (int n = 0; n < rounds; ++n) {
+                if (tuned) {
+                    if (writeOrder(db, cachedOrder, cachedItem, 1, QString(), cart, prices) > 0) ++saved;
+                } else {
+                    QSqlQuery freshOrder(db), freshItem(db);
+                    freshOrder.prepare(SQL_INSERT_ORDER);
+                    freshItem.prepare(SQL_INSERT_ITEM);
+                    if (writeOrder(db, freshOrder, freshItem, 1, QString(), cart, prices) > 0) ++saved;
+                }
+            }
+            qint64 orderMs = qMax<qint64>(timer.elapsed(), 1);
+
+            qDebug().noquote() << QString("[DB Bench] %1: login %2 ops/s (%3/%4 ok), order insert %5 ops/s (%6/%7 ok)")
+                                  .arg(tuned ? "tuned  " : "default")
+                                  .arg(rounds * 1000.0 / loginMs, 0, 'f', 1).arg(hits).arg(rounds)
+                                  .arg(rounds * 1000.0 / orderMs, 0, 'f', 1).arg(saved).arg(rounds);
+            db.close();
         }
+        QSqlDatabase::removeDatabase(connName);
     }
-    return false;
 }
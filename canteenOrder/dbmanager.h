@@ -5,21 +5,84 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QHash>
+#include <QMap>
+#include <QElapsedTimer>
 #include <QDebug>
 
+// 菜品按天分桶的销量
+struct DishSalesBucket {
+    QString dish;
+    int day;     // 儒略日
+    int qty;
+};
+
+// 还没送达后厨的订单消息
+struct OutboxMessage {
+    QString orderNo;
+    QString topic;
+    QString payload;
+};
+
 class DBManager : public QObject
 {
     Q_OBJECT
 public:
     static DBManager& instance(); // 单例访问点
     bool openDb();
-    bool registerUser(const QString &username, const QString &password);
-    bool loginUser(const QString &username, const QString &password);
+    QString databasePath() const; // 数据库文件的绝对路径
+    // 异步注册：KDF 在线程池中计算，算完回到 GUI 线程写库，结果通过 registerFinished 返回
+    void registerUserAsync(const QString &username, const QString &password);
+    // 异步登录：KDF 在线程池中计算，结果通过 loginFinished 返回
+    void loginUserAsync(const QString &username, const QString &password);
+
+    // 保存一笔已支付的订单 (订单头 + 明细)，orderNo 是订单 JSON 里的订单号；成功返回行 id，失败返回 -1
+    qint64 saveOrder(int tableNo, const QString &orderNo,
+                     const QMap<QString, int> &cart, const QMap<QString, double> &prices);
+
+    // 按天累加菜品销量
+    bool addDishSales(int day, const QMap<QString, int> &counts);
+    // 读取 fromDay 及之后的分桶销量，同时清理更早的桶
+    QList<DishSalesBucket> loadDishSales(int fromDay);
+
+    // 订单发件箱：发布前先写进来 (同一订单号只留一条)，服务器确认后删除
+    bool queueOutbox(const QString &orderNo, const QString &topic, const QString &payload);
+    void dropOutbox(const QString &orderNo);
+    QList<OutboxMessage> loadOutbox();     // 按入队先后
+
+    // 启动预备：在后台线程用独立连接打开数据库、设置 WAL 并建表 / 迁移，
+    // 之后 GUI 线程再 instance() 只剩几条无操作的 IF NOT EXISTS
+    static bool prepareDatabase();
+
+    // 性能测试：对比默认配置与调优配置下的登录 / 下单吞吐 (启动参数 --bench-db)
+    static void runBenchmark(int rounds = 2000);
+
+signals:
+    void loginFinished(const QString &username, bool ok);
+    void registerFinished(const QString &username, bool ok);   // false 通常是用户名已存在
 
 private:
+    struct Credential {
+        QByteArray salt;
+        int iterations;
+        QByteArray hash;
+    };
+    // 已验证口令缓存项：只保存 HMAC 摘要，不保存明文
+    struct VerifiedLogin {
+        QByteArray digest;
+        qint64 expireAt;
+    };
+
     explicit DBManager(QObject *parent = 0);
     QSqlDatabase m_db;
+    QHash<QString, QSqlQuery> m_stmtCache; // 预编译语句缓存 <SQL, 已 prepare 的语句>
+    QHash<QString, VerifiedLogin> m_verifiedCache;
+    QByteArray m_cacheKey;
+    QElapsedTimer m_clock;
     void initTable();
+    QSqlQuery &cachedQuery(const QString &sql);
+    bool fetchCredential(const QString &username, Credential *out);
+    QByteArray cacheDigest(const QString &username, const QString &password) const;
 };
 
 #endif // DBMANAGER_H
@@ -0,0 +1,352 @@
+#include "hardwarebackend.h"
+#include "simbackend.h"
+#include <QByteArray>
+#include <QList>
+#include <QDebug>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <errno.h>
+#include <string.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+// === 硬件路径定义 (LED) ===
+// GEC6818 的 LED 子系统路径
+#define PATH_LED_BRIGHTNESS "/sys/class/leds/led1/brightness"
+#define PATH_LED_MAX        "/sys/class/leds/led1/max_brightness"
+// 如果 led1 不亮，尝试改为 led2, led3, led4
+
+// === 蜂鸣器 PWM2 (sysfs) ===
+// 内核带 PWM 驱动时由硬件产生方波，音高不受 CPU 负载影响
+#define PATH_PWM_CHIP "/sys/class/pwm/pwmchip0"
+#define PATH_PWM2     PATH_PWM_CHIP "/pwm2"
+
+// === S5P6818 物理寄存器地址 (蜂鸣器 & 按键) ===
+#define GPIOB_PHY_BASE 0xC001B000 // 按键 (GPIOB30)
+#define GPIOC_PHY_BASE 0xC001C000 // 蜂鸣器 (PWM2 -> GPIOC14 复用)
+#define GPIO_WINDOW_BASE GPIOB_PHY_BASE
+#define GPIO_WINDOW_SIZE (GPIOC_PHY_BASE + 0x1000 - GPIOB_PHY_BASE)
+
+// 寄存器偏移
+#define GPIO_OUT     0x00
+#define GPIO_OUTENB  0x04
+#define GPIO_PAD     0x18
+
+// 引脚号
+#define BEEP_PIN     14   // GPIOC14 (PWM2引脚)
+
+// 按键引脚 (都在 GPIOB，低电平有效)，下标为 KeyId
+static const int KEY_PINS[KEY_COUNT] = {
+    30, // KEY_URGE
+    31, // KEY_AUX1
+    9   // KEY_AUX2
+};
+
+// === GPIO 字符设备 ===
+// S5P6818 每个 GPIO 组注册为一个 gpiochip：gpiochip0 = A 组，gpiochip1 = B 组 ...
+#ifndef KEY_GPIOCHIP
+#define KEY_GPIOCHIP "/dev/gpiochip1"
+#endif
+#ifndef BEEP_GPIOCHIP
+#define BEEP_GPIOCHIP "/dev/gpiochip2"
+#endif
+
+#define KEY_IDLE_POLL_MS 50 // 寄存器轮询间隔上限：全部按键松开时用这个，消抖期间调用方会传更短的 KEY_SCAN_MS
+
+qint64 HardwareBackend::nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (qint64)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+HardwareBackend *HardwareBackend::create()
+{
+    QList<QByteArray> order;
+    QByteArray wanted = qgetenv("CANTEEN_HAL");
+    if (!wanted.isEmpty()) order << wanted;
+#if defined(__arm__) || defined(__aarch64__)
+    // 寄存器地址和 gpiochip 编号都是 S5P6818 的，只在 ARM 板子上自动尝试，
+    // 避免在 PC 上误写同一地址 / 同一编号的 GPIO
+    order << "gpiochip" << "mmap";
+#endif
+    order << "sim";
+
+    QList<QByteArray> tried;
+    for (const QByteArray &kind : order) {
+        if (tried.contains(kind)) continue;
+        tried << kind;
+
+        HardwareBackend *backend = nullptr;
+        if (kind == "gpiochip") backend = new GpioChipBackend();
+        else if (kind == "mmap") backend = new MmapBackend();
+        else if (kind == "sim") backend = new SimBackend();
+        else {
+            qDebug() << "HAL: unknown backend" << kind;
+            continue;
+        }
+
+        if (backend->open()) {
+            qDebug() << "HAL: using" << backend->name() << "backend";
+            return backend;
+        }
+        qDebug() << "HAL:" << backend->name() << "backend unavailable";
+        delete backend;
+    }
+    return nullptr;
+}
+
+// --- 板载公共部分 (sysfs) ---
+static int openSysfs(const char *path)
+{
+    int fd = ::open(path, O_WRONLY | O_CLOEXEC);
+    if (fd < 0) qDebug() << "Sysfs Open Error:" << path << strerror(errno);
+    return fd;
+}
+
+// sysfs 属性每次都从偏移 0 写入整个值，fd 可以一直复用
+static void writeFd(int fd, const QByteArray &val)
+{
+    if (fd < 0) return;
+    ssize_t n = ::pwrite(fd, val.constData(), val.size(), 0);
+    Q_UNUSED(n);
+}
+
+BoardBackend::~BoardBackend()
+{
+    if (m_ledFd >= 0) ::close(m_ledFd);
+    if (m_pwmPeriodFd >= 0) ::close(m_pwmPeriodFd);
+    if (m_pwmDutyFd >= 0) ::close(m_pwmDutyFd);
+    if (m_pwmEnableFd >= 0) ::close(m_pwmEnableFd);
+}
+
+bool BoardBackend::openLed()
+{
+    if (m_ledFd >= 0) return true;
+    m_ledFd = openSysfs(PATH_LED_BRIGHTNESS);
+
+    // 普通 GPIO LED 的 max_brightness 是 1，呼吸灯效在这种灯上退化为半占空比闪烁
+    int fd = ::open(PATH_LED_MAX, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        char buf[16] = {0};
+        if (::read(fd, buf, sizeof(buf) - 1) > 0) {
+            int max = atoi(buf);
+            if (max > 0) m_ledMax = max;
+        }
+        ::close(fd);
+    }
+    return m_ledFd >= 0;
+}
+
+void BoardBackend::setLed(int brightness)
+{
+    // 注意：有些板子 1 是亮，有些 0 是亮，请根据实际情况调整
+    int level = (qBound(0, brightness, 255) * m_ledMax + 127) / 255;
+    writeFd(m_ledFd, QByteArray::number(level));
+}
+
+bool BoardBackend::initPwm()
+{
+    if (m_pwm) return true;
+    if (::access(PATH_PWM_CHIP, F_OK) != 0) return false;
+
+    if (::access(PATH_PWM2, F_OK) != 0) {
+        int fd = openSysfs(PATH_PWM_CHIP "/export");
+        writeFd(fd, "2");
+        if (fd >= 0) ::close(fd);
+    }
+    m_pwmPeriodFd = openSysfs(PATH_PWM2 "/period");
+    m_pwmDutyFd = openSysfs(PATH_PWM2 "/duty_cycle");
+    m_pwmEnableFd = openSysfs(PATH_PWM2 "/enable");
+    m_pwm = (m_pwmPeriodFd >= 0 && m_pwmDutyFd >= 0 && m_pwmEnableFd >= 0);
+    return m_pwm;
+}
+
+void BoardBackend::startTone(int freqHz)
+{
+    if (freqHz <= 0) return;
+    qint64 periodNs = 1000000000LL / freqHz;
+    // 先清占空比再改周期，否则新周期小于旧占空比时内核会拒绝写入
+    writeFd(m_pwmDutyFd, "0");
+    writeFd(m_pwmPeriodFd, QByteArray::number(periodNs));
+    writeFd(m_pwmDutyFd, QByteArray::number(periodNs / 2));
+    writeFd(m_pwmEnableFd, "1");
+}
+
+void BoardBackend::stopTone()
+{
+    writeFd(m_pwmEnableFd, "0");
+}
+
+// --- 寄存器后端 ---
+MmapBackend::~MmapBackend()
+{
+    if (m_window) ::munmap(m_window, GPIO_WINDOW_SIZE);
+}
+
+bool MmapBackend::open()
+{
+    int mem_fd = ::open("/dev/mem", O_RDWR | O_SYNC | O_CLOEXEC);
+    if (mem_fd < 0) {
+        qDebug() << "Error: Failed to open /dev/mem. Need Root permission!";
+        return false;
+    }
+    void *map_base = ::mmap(NULL, GPIO_WINDOW_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, GPIO_WINDOW_BASE);
+    ::close(mem_fd);
+    if (map_base == MAP_FAILED) {
+        qDebug() << "Error: mmap failed.";
+        return false;
+    }
+    m_window = map_base;
+
+    volatile unsigned int *regs = (volatile unsigned int *)map_base;
+    m_gpiob = regs + ((GPIOB_PHY_BASE - GPIO_WINDOW_BASE) >> 2);
+    m_gpioc = regs + ((GPIOC_PHY_BASE - GPIO_WINDOW_BASE) >> 2);
+
+    // 设置 GPIOC14 为输出 (OUTENB 第14位置1)，初始电平拉低 (关)
+    *(m_gpioc + (GPIO_OUTENB >> 2)) |= (1 << BEEP_PIN);
+    *(m_gpioc + (GPIO_OUT >> 2)) &= ~(1 << BEEP_PIN);
+    // 设置按键引脚为输入 (OUTENB 对应位置0)
+    for (int k = 0; k < KEY_COUNT; ++k) {
+        *(m_gpiob + (GPIO_OUTENB >> 2)) &= ~(1u << KEY_PINS[k]);
+    }
+
+    openLed();
+    initPwm();
+    return true;
+}
+
+void MmapBackend::setBuzzer(bool high)
+{
+    if (!m_gpioc) return;
+    if (high) {
+        *(m_gpioc + (GPIO_OUT >> 2)) |= (1 << BEEP_PIN);
+    } else {
+        *(m_gpioc + (GPIO_OUT >> 2)) &= ~(1 << BEEP_PIN);
+    }
+}
+
+bool MmapBackend::scanKeys(int timeoutMs, quint32 *pressed)
+{
+    // 寄存器没有事件可等，只能按间隔轮询。空闲时调用方给的是长超时，按 50ms 节拍轮询；
+    // 有按键在消抖时调用方给的是 5ms，这时才密集采样
+    ::usleep(qBound(0, timeoutMs, KEY_IDLE_POLL_MS) * 1000);
+
+    // 一次读出整组 PAD，再按引脚拆位
+    unsigned int pad = *(m_gpiob + (GPIO_PAD >> 2));
+    quint32 bits = 0;
+    for (int k = 0; k < KEY_COUNT; ++k) {
+        if (!(pad & (1u << KEY_PINS[k]))) bits |= 1u << k;
+    }
+    *pressed = bits;
+    return true;
+}
+
+// --- 字符设备后端 ---
+GpioChipBackend::GpioChipBackend()
+{
+    for (int k = 0; k < KEY_COUNT; ++k) m_keyFds[k] = -1;
+}
+
+GpioChipBackend::~GpioChipBackend()
+{
+    for (int k = 0; k < KEY_COUNT; ++k) {
+        if (m_keyFds[k] >= 0) ::close(m_keyFds[k]);
+    }
+    if (m_beepFd >= 0) ::close(m_beepFd);
+}
+
+bool GpioChipBackend::open()
+{
+    // 按键：每个引脚申请双边沿事件，按下和松开都要喂给消抖状态机
+    int chipFd = ::open(KEY_GPIOCHIP, O_RDONLY | O_CLOEXEC);
+    if (chipFd < 0) return false;
+
+    for (int k = 0; k < KEY_COUNT; ++k) {
+        struct gpioevent_request ereq;
+        memset(&ereq, 0, sizeof(ereq));
+        ereq.lineoffset = KEY_PINS[k];
+        ereq.handleflags = GPIOHANDLE_REQUEST_INPUT;
+        ereq.eventflags = GPIOEVENT_REQUEST_BOTH_EDGES;
+        strncpy(ereq.consumer_label, "canteen-key", sizeof(ereq.consumer_label) - 1);
+
+        if (::ioctl(chipFd, GPIO_GET_LINEEVENT_IOCTL, &ereq) < 0) {
+            qDebug() << "GPIO line event request failed:" << KEY_GPIOCHIP << KEY_PINS[k] << strerror(errno);
+            continue;
+        }
+        m_keyFds[k] = ereq.fd;
+        m_keyMask |= 1u << k;
+    }
+    ::close(chipFd);
+    if (!(m_keyMask & (1u << KEY_URGE))) return false; // 催单键都拿不到就换后端
+    openLed();
+
+    // 蜂鸣器：有 PWM 驱动时不占用引脚
+    if (!initPwm()) {
+        chipFd = ::open(BEEP_GPIOCHIP, O_RDONLY | O_CLOEXEC);
+        if (chipFd >= 0) {
+            struct gpiohandle_request hreq;
+            memset(&hreq, 0, sizeof(hreq));
+            hreq.lineoffsets[0] = BEEP_PIN;
+            hreq.lines = 1;
+            hreq.flags = GPIOHANDLE_REQUEST_OUTPUT;
+            hreq.default_values[0] = 0;
+            strncpy(hreq.consumer_label, "canteen-beep", sizeof(hreq.consumer_label) - 1);
+
+            if (::ioctl(chipFd, GPIO_GET_LINEHANDLE_IOCTL, &hreq) == 0) {
+                m_beepFd = hreq.fd;
+            } else {
+                qDebug() << "GPIO line handle request failed:" << BEEP_GPIOCHIP << BEEP_PIN << strerror(errno);
+            }
+            ::close(chipFd);
+        }
+    }
+    return true;
+}
+
+void GpioChipBackend::setBuzzer(bool high)
+{
+    if (m_beepFd < 0) return;
+    struct gpiohandle_data data;
+    memset(&data, 0, sizeof(data));
+    data.values[0] = high ? 1 : 0;
+    ::ioctl(m_beepFd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+}
+
+bool GpioChipBackend::scanKeys(int timeoutMs, quint32 *pressed)
+{
+    struct pollfd pfds[KEY_COUNT];
+    int keyOf[KEY_COUNT];
+    int n = 0;
+    for (int k = 0; k < KEY_COUNT; ++k) {
+        if (m_keyFds[k] < 0) continue;
+        pfds[n].fd = m_keyFds[k];
+        pfds[n].events = POLLIN | POLLPRI;
+        pfds[n].revents = 0;
+        keyOf[n++] = k;
+    }
+    if (::poll(pfds, n, timeoutMs) < 0 && errno != EINTR) return false;
+
+    // 事件只用来唤醒；事件 fd 是阻塞的，每个就绪的 fd 只读一个，避免卡在 read 上
+    for (int i = 0; i < n; ++i) {
+        if (!(pfds[i].revents & (POLLIN | POLLPRI))) continue;
+        struct gpioevent_data ev;
+        ssize_t r = ::read(pfds[i].fd, &ev, sizeof(ev));
+        Q_UNUSED(r);
+    }
+
+    // 电平以当前读数为准，事件丢了也不会卡在错误状态
+    quint32 bits = 0;
+    for (int i = 0; i < n; ++i) {
+        struct gpiohandle_data data;
+        memset(&data, 0, sizeof(data));
+        if (::ioctl(pfds[i].fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data) < 0) return false;
+        if (data.values[0] == 0) bits |= 1u << keyOf[i];
+    }
+    *pressed = bits;
+    return true;
+}
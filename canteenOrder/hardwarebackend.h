@@ -0,0 +1,121 @@
+#ifndef HARDWAREBACKEND_H
+#define HARDWAREBACKEND_H
+
+#include <QtGlobal>
+
+// 物理按键编号，对应按键位掩码里的位
+enum KeyId {
+    KEY_URGE = 0, // GPIOB30 催单键
+    KEY_AUX1,     // GPIOB31
+    KEY_AUX2,     // GPIOB9
+    KEY_COUNT
+};
+
+// 硬件抽象层：LED、蜂鸣器、按键的底层访问
+// HardwareControl 只通过这个接口操作硬件，板子上走寄存器 / 字符设备，
+// 开发机和 CI 上走仿真后端 (SimBackend)
+class HardwareBackend
+{
+public:
+    virtual ~HardwareBackend() {}
+
+    virtual const char *name() const = 0;
+    // 打开设备，返回 false 表示此后端在当前机器上不可用
+    virtual bool open() = 0;
+
+    // LED 亮度 0~255 (0 为灭)，后端按自己的 max_brightness 换算
+    virtual void setLed(int brightness) = 0;
+
+    // 蜂鸣器：hasToneGenerator() 为真时由硬件 (PWM) 出方波，调用 startTone/stopTone；
+    // 否则调用方在实时线程里用 setBuzzer 翻转引脚
+    virtual bool hasBuzzer() const = 0;
+    virtual bool hasToneGenerator() const { return false; }
+    virtual void setBuzzer(bool high) = 0;
+    virtual void startTone(int freqHz) { Q_UNUSED(freqHz); }
+    virtual void stopTone() {}
+
+    // 按键：keyMask() 为已配置按键的位掩码 (位号见 KeyId)
+    // scanKeys 最多等待 timeoutMs (有边沿事件的后端会提前返回)，然后一次采样全部按键，
+    // *pressed 为当前按下的按键位，是原始电平，消抖由调用方做；采样失败返回 false
+    virtual quint32 keyMask() const = 0;
+    virtual bool scanKeys(int timeoutMs, quint32 *pressed) = 0;
+    bool hasKeys() const { return keyMask() != 0; }
+
+    // 记录一个应用层事件 (如 "mqtt_publish")，仿真后端用来统计按键到该事件的延迟
+    virtual void trace(const char *event) { Q_UNUSED(event); }
+
+    // 按环境变量 CANTEEN_HAL (mmap / gpiochip / sim) 创建并打开后端；
+    // 未指定或指定的后端打不开时依次尝试 gpiochip、mmap，最后退回 sim
+    static HardwareBackend *create();
+
+    static qint64 nowNs(); // CLOCK_MONOTONIC，纳秒
+};
+
+// 板载后端的公共部分：LED (sysfs) 和蜂鸣器 PWM2 (sysfs)
+// sysfs 属性文件在 open 时打开一次，之后每次只有一次 pwrite
+class BoardBackend : public HardwareBackend
+{
+public:
+    ~BoardBackend();
+    void setLed(int brightness) override;
+    bool hasToneGenerator() const override { return m_pwm; }
+    void startTone(int freqHz) override;
+    void stopTone() override;
+
+protected:
+    bool openLed();
+    bool initPwm(); // 检测并导出 PWM2
+
+    bool m_pwm = false;
+
+private:
+    int m_ledFd = -1;
+    int m_ledMax = 255;
+    int m_pwmPeriodFd = -1;
+    int m_pwmDutyFd = -1;
+    int m_pwmEnableFd = -1;
+};
+
+// 寄存器后端：mmap /dev/mem 直接读写 S5P6818 的 GPIO 寄存器 (需要 root)
+// GPIOB、GPIOC 相邻，一次映射整个窗口，两组寄存器都从这块映射里取
+class MmapBackend : public BoardBackend
+{
+public:
+    ~MmapBackend();
+    const char *name() const override { return "mmap"; }
+    bool open() override;
+
+    bool hasBuzzer() const override { return m_gpioc || m_pwm; }
+    void setBuzzer(bool high) override;
+
+    quint32 keyMask() const override { return m_gpiob ? (1u << KEY_COUNT) - 1 : 0; }
+    bool scanKeys(int timeoutMs, quint32 *pressed) override; // 每次读一次 PAD 寄存器
+
+private:
+    void *m_window = nullptr;                 // GPIOB ~ GPIOC 寄存器窗口
+    volatile unsigned int *m_gpiob = nullptr; // 按键
+    volatile unsigned int *m_gpioc = nullptr; // 蜂鸣器
+};
+
+// 字符设备后端：/dev/gpiochipN，按键用内核边沿事件唤醒，蜂鸣器用 line handle
+class GpioChipBackend : public BoardBackend
+{
+public:
+    GpioChipBackend();
+    ~GpioChipBackend();
+    const char *name() const override { return "gpiochip"; }
+    bool open() override;
+
+    bool hasBuzzer() const override { return m_beepFd >= 0 || m_pwm; }
+    void setBuzzer(bool high) override;
+
+    quint32 keyMask() const override { return m_keyMask; }
+    bool scanKeys(int timeoutMs, quint32 *pressed) override; // poll 等待任意按键的边沿
+
+private:
+    int m_keyFds[KEY_COUNT];
+    quint32 m_keyMask = 0;
+    int m_beepFd = -1;
+};
+
+#endif // HARDWAREBACKEND_H
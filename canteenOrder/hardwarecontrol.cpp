@@ -1,26 +1,15 @@
 #include "hardwarecontrol.h"
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/mman.h>
-#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
 
-// === 硬件路径定义 (LED) ===
-// GEC6818 的 LED 子系统路径
-#define PATH_LED_BRIGHTNESS "/sys/class/leds/led1/brightness"
-// 如果 led1 不亮，尝试改为 led2, led3, led4
+#define BUZZER_RT_PRIORITY 50 // SCHED_FIFO 优先级 (软件方波)
+#define LED_PULSE_STEP_MS  20 // 呼吸灯亮度刷新间隔
 
-// === S5P6818 物理寄存器地址 (蜂鸣器 & 按键) ===
-#define GPIOB_PHY_BASE 0xC001B000 // 按键 (GPIOB30)
-#define GPIOC_PHY_BASE 0xC001C000 // 蜂鸣器 (PWM2 -> GPIOC14 复用)
-
-// 寄存器偏移
-#define GPIO_OUT     0x00
-#define GPIO_OUTENB  0x04
-#define GPIO_PAD     0x18
-
-// 引脚号
-#define KEY_PIN      30   // GPIOB30
-#define BEEP_PIN     14   // GPIOC14 (PWM2引脚)
+#define KEY_DEBOUNCE_MS  20  // 电平保持这么久才算稳定
+#define KEY_SCAN_MS      5   // 消抖期间的扫描间隔
+#define KEY_IDLE_WAIT_MS 200 // 空闲时在后端上等待的上限 (用于检查 stopFlag)
 
 HardwareControl* HardwareControl::m_instance = nullptr;
 
@@ -34,143 +23,366 @@ HardwareControl* HardwareControl::instance()
 
 HardwareControl::HardwareControl(QObject *parent) : QObject(parent)
 {
-    gpioc_base = nullptr;
-    gpiob_base = nullptr;
+    backend = nullptr;
 
     // 按键线程
     keyThread = new KeyMonitorThread();
-    connect(keyThread, &KeyMonitorThread::urgeKeyPressed, this, &HardwareControl::urgeOrderTriggered);
+    inputTimer = new QTimer(this);
+    inputTimer->setInterval(INPUT_FRAME_MS);
+    connect(inputTimer, &QTimer::timeout, this, &HardwareControl::drainInput);
+
+    // 蜂鸣器线程
+    buzzerThread = new BuzzerThread();
+    connect(buzzerThread, &BuzzerThread::melodyFinished, this, &HardwareControl::onMelodyFinished);
+    beepProbe = new UiLagProbe(16, this);
 
-    // 蜂鸣器定时器 (用于产生音频频率)
-    beepTimer = new QTimer(this);
-    connect(beepTimer, &QTimer::timeout, this, &HardwareControl::toggleBeep);
+    // LED 线程
+    ledThread = new LedThread();
 }
 
-// 内存映射通用函数
-volatile unsigned int* map_register(off_t target_base) {
-    int mem_fd = ::open("/dev/mem", O_RDWR | O_SYNC);
-    if (mem_fd < 0) {
-        qDebug() << "Error: Failed to open /dev/mem. Need Root permission!";
-        return nullptr;
+void HardwareControl::initHardware()
+{
+    // 按 CANTEEN_HAL 选择后端：板子上是 gpiochip / mmap，其他机器退回仿真
+    backend = HardwareBackend::create();
+    if (!backend) return;
+
+    // 1. 蜂鸣器
+    if (backend->hasBuzzer()) {
+        buzzerThread->backend = backend;
+        buzzerThread->start();
+        ledThread->buzzer = buzzerThread;
+        qDebug() << "Beep initialized," << (backend->hasToneGenerator() ? "hardware tone" : "software square wave");
     }
 
-    void *map_base = ::mmap(NULL, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, target_base);
-    ::close(mem_fd);
+    // 2. LED：线程启动时先关灯
+    ledThread->backend = backend;
+    ledThread->start();
 
-    if (map_base == MAP_FAILED) {
-        qDebug() << "Error: mmap failed.";
-        return nullptr;
+    // 3. 按键
+    if (backend->hasKeys()) {
+        keyThread->backend = backend;
+        keyThread->start();
+        inputTimer->start();
+        qDebug() << "Buttons initialized via" << backend->name() << "mask" << backend->keyMask();
     }
-    return (volatile unsigned int *)map_base;
 }
 
-// 辅助函数：写文件 (用于 LED)
-void writeSysfs(const QString &path, const QString &val) {
-    QFile file(path);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        file.write(val.toLatin1());
-        file.close();
-    } else {
-        qDebug() << "Sysfs Write Error:" << path;
-    }
+void HardwareControl::trace(const char *event)
+{
+    if (backend) backend->trace(event);
 }
 
-void HardwareControl::initHardware()
+void HardwareControl::drainInput()
 {
-    // 1. 初始化 LED (Sysfs)
-    // 既然系统已经有了 /sys/class/leds/led1，我们直接用，不需要初始化
-    // 先尝试关灯
-    writeSysfs(PATH_LED_BRIGHTNESS, "0");
-    qDebug() << "LED initialized via Sysfs (led1)";
-
-    // 2. 初始化 蜂鸣器 (Mmap -> GPIOC14)
-    gpioc_base = map_register(GPIOC_PHY_BASE);
-    if (gpioc_base) {
-        // 设置 GPIOC14 为输出 (OUTENB 第14位置1)
-        *(gpioc_base + (GPIO_OUTENB >> 2)) |= (1 << BEEP_PIN);
-        // 初始电平拉低 (关)
-        *(gpioc_base + (GPIO_OUT >> 2)) &= ~(1 << BEEP_PIN);
-        qDebug() << "Beep initialized via Mmap (GPIOC14)";
-    }
-
-    // 3. 初始化 按键 (Mmap -> GPIOB30)
-    gpiob_base = map_register(GPIOB_PHY_BASE);
-    if (gpiob_base) {
-        // 设置 GPIOB30 为输入 (OUTENB 第30位置0)
-        *(gpiob_base + (GPIO_OUTENB >> 2)) &= ~(1 << KEY_PIN);
-
-        // 启动线程
-        keyThread->gpio_base = gpiob_base;
-        keyThread->start();
-        qDebug() << "Button initialized via Mmap (GPIOB30)";
+    InputEvent ev;
+    while (keyThread->events.pop(&ev)) {
+        qint64 waitUs = (HardwareBackend::nowNs() - ev.tsNs) / 1000;
+        qDebug().noquote() << QString("[Input] key %1 %2, edge -> UI %3 ms")
+                              .arg(ev.key).arg(ev.pressed ? "press" : "release")
+                              .arg(waitUs / 1000.0, 0, 'f', 1);
+        emit keyEvent(ev.key, ev.pressed, ev.tsNs);
+
+        if (ev.key == KEY_URGE && ev.pressed) {
+            lastPressNs = ev.tsNs;
+            trace("urge_dispatched");
+            emit urgeOrderTriggered();
+        }
     }
+
+    int dropped = keyThread->dropped.exchange(0);
+    if (dropped) qDebug() << "[Input]" << dropped << "key events dropped, ring full";
+}
+
+// --- 反馈 ---
+void HardwareControl::signalSuccess()
+{
+    // LED 亮 3s，同时 500Hz 响 150ms
+    post(Feedback{LedPattern::solid(3000), QVector<Tone>() << Tone{500, 150}});
 }
 
-// --- LED 控制 (Sysfs) ---
 void HardwareControl::flashLedSuccess()
 {
-    // 写入 1 (或者 255) 点亮
-    // 注意：有些板子 1 是亮，有些 0 是亮，请根据实际情况调整
-    writeSysfs(PATH_LED_BRIGHTNESS, "255"); // 尝试最大亮度
+    post(Feedback{LedPattern::solid(3000), QVector<Tone>()});
+}
 
-    // 200ms 后关闭
-    QTimer::singleShot(3000, this, SLOT(stopLed()));
+void HardwareControl::playSuccessSound()
+{
+    // 500Hz 响 150ms
+    playTones(QVector<Tone>() << Tone{500, 150});
 }
 
-void HardwareControl::stopLed()
+void HardwareControl::playTones(const QVector<Tone> &melody)
 {
-    writeSysfs(PATH_LED_BRIGHTNESS, "0");
+    if (melody.isEmpty()) return;
+    post(Feedback{LedPattern::keep(), melody});
 }
 
-// --- 蜂鸣器控制 (软件 PWM) ---
-void HardwareControl::playSuccessSound()
+void HardwareControl::post(const Feedback &feedback)
 {
-    if (!gpioc_base) return;
+    if (!ledThread->isRunning()) return;
 
-    beepDuration = 0;
-    // 1ms 翻转一次，约 500Hz
-    beepTimer->start(1);
+    // 由按键触发的反馈：记录从按下到提交反馈的延迟
+    if (lastPressNs) {
+        qDebug().noquote() << QString("[Input] press -> feedback %1 ms")
+                              .arg((HardwareBackend::nowNs() - lastPressNs) / 1000000.0, 0, 'f', 1);
+        lastPressNs = 0;
+    }
+
+    if (!feedback.tones.isEmpty() && ledThread->buzzer) {
+        if (pendingMelodies++ == 0) beepProbe->start();
+    }
+    ledThread->post(feedback);
 }
 
-void HardwareControl::toggleBeep()
+void HardwareControl::onMelodyFinished(int toggles, qint64 avgJitterUs, qint64 maxJitterUs)
 {
-    if (!gpioc_base) return;
+    if (--pendingMelodies == 0) beepProbe->stop();
+    qDebug().noquote() << QString("[Beep] %1 toggles, jitter avg %2 us max %3 us | GUI frame avg %4 ms, max lag %5 ms")
+                          .arg(toggles).arg(avgJitterUs).arg(maxJitterUs)
+                          .arg(beepProbe->avgIntervalMs(), 0, 'f', 1).arg(beepProbe->maxLagMs());
+}
 
-    beepState = !beepState;
-    if (beepState) {
-        *(gpioc_base + (GPIO_OUT >> 2)) |= (1 << BEEP_PIN);
-    } else {
-        *(gpioc_base + (GPIO_OUT >> 2)) &= ~(1 << BEEP_PIN);
+// --- LED 线程 ---
+int LedPattern::levelAt(qint64 elapsedMs, int *nextMs) const
+{
+    *nextMs = -1;
+    switch (kind) {
+    case Solid:
+        if (onMs == 0) return brightness;
+        if (elapsedMs >= onMs) return 0;
+        *nextMs = (int)(onMs - elapsedMs);
+        return brightness;
+    case Blink:
+    case Pulse: {
+        int period = (kind == Blink) ? onMs + offMs : onMs;
+        if (period <= 0 || (count > 0 && elapsedMs >= (qint64)count * period)) return 0;
+        int phase = (int)(elapsedMs % period);
+        if (kind == Blink) {
+            *nextMs = (phase < onMs) ? onMs - phase : period - phase;
+            return (phase < onMs) ? brightness : 0;
+        }
+        // 三角波：前半周期渐亮，后半周期渐灭
+        *nextMs = LED_PULSE_STEP_MS;
+        int half = period / 2;
+        int rise = (phase < half) ? phase : period - phase;
+        return half ? brightness * rise / half : 0;
     }
+    default:
+        return 0;
+    }
+}
+
+void LedThread::post(const Feedback &feedback)
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue.enqueue(feedback);
+    m_cond.wakeOne();
+}
 
-    // 响 150ms (150次翻转)
-    if (++beepDuration > 150) {
-        beepTimer->stop();
-        // 强制拉低，确保停止发声
-        *(gpioc_base + (GPIO_OUT >> 2)) &= ~(1 << BEEP_PIN);
+void LedThread::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stop = true;
+    m_cond.wakeOne();
+}
+
+void LedThread::run()
+{
+    LedPattern pattern = LedPattern::off();
+    qint64 startNs = HardwareBackend::nowNs();
+    int lastLevel = -1;
+
+    QMutexLocker locker(&m_mutex);
+    while (!m_stop) {
+        while (!m_queue.isEmpty()) {
+            Feedback fb = m_queue.dequeue();
+            if (!fb.tones.isEmpty() && buzzer) buzzer->enqueue(fb.tones);
+            if (fb.led.kind != LedPattern::Keep) {
+                pattern = fb.led;
+                startNs = HardwareBackend::nowNs();
+            }
+        }
+
+        int nextMs = -1;
+        int level = pattern.levelAt((HardwareBackend::nowNs() - startNs) / 1000000, &nextMs);
+        if (level != lastLevel) {
+            // 写 sysfs 时不持锁，UI 提交反馈不会被阻塞
+            locker.unlock();
+            backend->setLed(level);
+            locker.relock();
+            lastLevel = level;
+        }
+
+        if (!m_queue.isEmpty() || m_stop) continue;
+        if (nextMs < 0) m_cond.wait(&m_mutex);
+        else m_cond.wait(&m_mutex, qMax(nextMs, 1));
     }
+    locker.unlock();
+    backend->setLed(0);
 }
 
-// --- 按键监听线程 ---
-void KeyMonitorThread::run()
+// --- 蜂鸣器线程 ---
+void BuzzerThread::enqueue(const QVector<Tone> &melody)
 {
-    if (!gpio_base) return;
+    QMutexLocker locker(&m_mutex);
+    m_queue.enqueue(melody);
+    m_cond.wakeOne();
+}
+
+void BuzzerThread::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stop = true;
+    m_cond.wakeOne();
+}
+
+static inline void addNs(struct timespec *ts, long ns)
+{
+    ts->tv_nsec += ns;
+    while (ts->tv_nsec >= 1000000000L) {
+        ts->tv_nsec -= 1000000000L;
+        ts->tv_sec++;
+    }
+}
+
+static inline qint64 diffNs(const struct timespec &a, const struct timespec &b)
+{
+    return (qint64)(a.tv_sec - b.tv_sec) * 1000000000LL + (a.tv_nsec - b.tv_nsec);
+}
 
-    int lastState = 1; // 默认高电平
+// 软件方波：每半个周期一个绝对截止时间，迟到不会累积到后面的翻转
+void BuzzerThread::playSoftware(const Tone &tone, int *toggles, qint64 *sumJitterNs, qint64 *maxJitterNs)
+{
+    struct timespec deadline, now;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    if (tone.freqHz <= 0) {
+        addNs(&deadline, (long)tone.durationMs * 1000000L);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr);
+        return;
+    }
+
+    long halfPeriodNs = 500000000L / tone.freqHz;
+    int count = (int)((qint64)tone.durationMs * 1000000LL / halfPeriodNs);
+    bool level = false;
+    for (int i = 0; i < count; ++i) {
+        addNs(&deadline, halfPeriodNs);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {}
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        level = !level;
+        backend->setBuzzer(level);
+
+        qint64 jitter = diffNs(now, deadline);
+        *sumJitterNs += jitter;
+        if (jitter > *maxJitterNs) *maxJitterNs = jitter;
+        ++*toggles;
+    }
+    backend->setBuzzer(false); // 强制拉低，确保停止发声
+}
+
+void BuzzerThread::playHardware(const Tone &tone)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    addNs(&deadline, (long)tone.durationMs * 1000000L);
 
-    while (!stopFlag) {
-        // 读取 GPIO_PAD 状态
-        unsigned int val = *(gpio_base + (GPIO_PAD >> 2));
-        // 提取第 30 位
-        int currentState = (val >> KEY_PIN) & 0x1;
+    backend->startTone(tone.freqHz);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {}
+    backend->stopTone();
+}
+
+void BuzzerThread::run()
+{
+    // 软件方波对唤醒延迟敏感，尽量切到实时调度 (需要 root)
+    struct sched_param sp;
+    sp.sched_priority = BUZZER_RT_PRIORITY;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) != 0) {
+        qDebug() << "BuzzerThread: SCHED_FIFO unavailable, running with normal priority";
+    }
+
+    bool hardware = backend->hasToneGenerator();
+    forever {
+        QVector<Tone> melody;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_stop) m_cond.wait(&m_mutex);
+            if (m_stop) return;
+            melody = m_queue.dequeue();
+        }
+
+        int toggles = 0;
+        qint64 sumJitter = 0, maxJitter = 0;
+        for (const Tone &tone : melody) {
+            if (hardware) playHardware(tone);
+            else playSoftware(tone, &toggles, &sumJitter, &maxJitter);
+        }
+        emit melodyFinished(toggles, toggles ? sumJitter / toggles / 1000 : 0, maxJitter / 1000);
+    }
+}
+
+// --- 按键扫描线程 ---
+// 单个引脚的消抖状态机：电平变化后要稳定 KEY_DEBOUNCE_MS 才确认，事件时间取第一次边沿
+struct KeyDebouncer {
+    enum State { Released, PressPending, Pressed, ReleasePending };
+    State state = Released;
+    qint64 sinceNs = 0;
+
+    bool settling() const { return state == PressPending || state == ReleasePending; }
+
+    // 返回 true 表示确认了一次按下 / 松开，写入 *ev
+    bool update(bool down, qint64 now, InputEvent *ev)
+    {
+        const qint64 stableNs = KEY_DEBOUNCE_MS * 1000000LL;
+        switch (state) {
+        case Released:
+            if (down) { state = PressPending; sinceNs = now; }
+            return false;
+        case PressPending:
+            if (!down) { state = Released; return false; } // 抖动
+            if (now - sinceNs < stableNs) return false;
+            state = Pressed;
+            ev->pressed = true;
+            ev->tsNs = sinceNs;
+            return true;
+        case Pressed:
+            if (!down) { state = ReleasePending; sinceNs = now; }
+            return false;
+        case ReleasePending:
+            if (down) { state = Pressed; return false; }
+            if (now - sinceNs < stableNs) return false;
+            state = Released;
+            ev->pressed = false;
+            ev->tsNs = sinceNs;
+            return true;
+        }
+        return false;
+    }
+};
+
+void KeyMonitorThread::run()
+{
+    KeyDebouncer keys[KEY_COUNT];
+    const quint32 mask = backend->keyMask();
+    bool settling = false;
+
+    while (!stopFlag.load(std::memory_order_relaxed)) {
+        quint32 pressed = 0;
+        if (!backend->scanKeys(settling ? KEY_SCAN_MS : KEY_IDLE_WAIT_MS, &pressed)) {
+            QThread::msleep(KEY_SCAN_MS);
+            continue;
+        }
 
-        // 下降沿检测 (1 -> 0)
-        if (lastState == 1 && currentState == 0) {
-            qDebug() << "Physical Button Pressed!";
-            emit urgeKeyPressed();
-            QThread::msleep(300); // 消抖
+        qint64 now = HardwareBackend::nowNs();
+        settling = false;
+        for (int k = 0; k < KEY_COUNT; ++k) {
+            if (!(mask & (1u << k))) continue;
+            InputEvent ev;
+            if (keys[k].update(pressed & (1u << k), now, &ev)) {
+                ev.key = k;
+                if (!events.push(ev)) dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            settling = settling || keys[k].settling();
         }
-        lastState = currentState;
-        QThread::msleep(50); // 轮询间隔
     }
 }
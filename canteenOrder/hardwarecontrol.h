@@ -4,22 +4,126 @@
 #include <QObject>
 #include <QThread>
 #include <QTimer>
-#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QVector>
 #include <QDebug>
+#include "uilagprobe.h"
+#include "hardwarebackend.h"
+#include "spscring.h"
+#include <atomic>
 
-// 按键监听线程类
+// 一个音：频率 (Hz，0 表示静音) + 时长 (ms)
+struct Tone {
+    int freqHz;
+    int durationMs;
+};
+
+// LED 灯效描述，由 LED 线程按时间推进
+struct LedPattern {
+    enum Kind {
+        Keep,   // 不改变当前灯效 (只播放声音的反馈)
+        Off,
+        Solid,  // 常亮 onMs 后熄灭，onMs 为 0 表示一直亮
+        Blink,  // 亮 onMs、灭 offMs 为一个周期
+        Pulse   // 呼吸：onMs 内渐亮再渐灭为一个周期
+    };
+    Kind kind;
+    int onMs;
+    int offMs;
+    int count;      // 周期数 (N 次闪烁)，0 表示一直重复直到被新灯效替换
+    int brightness;
+
+    static LedPattern keep()                { return LedPattern{Keep, 0, 0, 0, 0}; }
+    static LedPattern off()                 { return LedPattern{Off, 0, 0, 0, 0}; }
+    static LedPattern solid(int ms)         { return LedPattern{Solid, ms, 0, 1, 255}; }
+    static LedPattern blink(int onMs, int offMs, int count = 0) { return LedPattern{Blink, onMs, offMs, count, 255}; }
+    static LedPattern flash(int n)          { return blink(120, 120, n); }
+    static LedPattern pulse(int periodMs, int count = 0) { return LedPattern{Pulse, periodMs, 0, count, 255}; }
+
+    // elapsedMs 时刻的亮度；*nextMs 为距离下一次亮度变化的时间，-1 表示之后不再变化
+    int levelAt(qint64 elapsedMs, int *nextMs) const;
+};
+
+// 一次操作反馈：灯效 + 音序，UI 只需要提交一次
+struct Feedback {
+    LedPattern led;
+    QVector<Tone> tones;
+};
+
+// 一次已消抖的按键事件
+struct InputEvent {
+    qint64 tsNs;  // 按下 / 松开的时刻 (CLOCK_MONOTONIC，取第一次边沿)
+    int key;      // KeyId
+    bool pressed;
+};
+
+// 按键扫描线程
+// 每次扫描向后端采样一次全部按键，逐个引脚过消抖状态机，结果写入无锁环形队列，
+// 由 GUI 线程每帧取走；有引脚在消抖期间时按 KEY_SCAN_MS 间隔扫描，否则在后端上长等
 class KeyMonitorThread : public QThread
 {
     Q_OBJECT
 public:
-    volatile unsigned int* gpio_base = nullptr;
-    bool stopFlag = false;
+    HardwareBackend *backend = nullptr;
+    std::atomic<bool> stopFlag;
+    SpscRing<InputEvent, 64> events; // 生产者：本线程，消费者：GUI 线程
+    std::atomic<int> dropped;        // 队列满丢弃的事件数
+
+    KeyMonitorThread() : stopFlag(false), dropped(0) {}
+
+protected:
+    void run() override;
+};
+
+// 蜂鸣器线程：提交的音序排队播放，调用方立即返回
+// 后端有硬件方波 (PWM2) 时直接用；否则在实时线程里按绝对时间点翻转蜂鸣器引脚
+class BuzzerThread : public QThread
+{
+    Q_OBJECT
+public:
+    HardwareBackend *backend = nullptr;
+    void enqueue(const QVector<Tone> &melody);
+    void stop();
 
 protected:
     void run() override;
 
 signals:
-    void urgeKeyPressed(); // 线程发出的原始信号
+    // 一段音序播放完毕：翻转次数、唤醒抖动 (实际唤醒时间 - 目标时间) 的平均值和最大值
+    void melodyFinished(int toggles, qint64 avgJitterUs, qint64 maxJitterUs);
+
+private:
+    void playSoftware(const Tone &tone, int *toggles, qint64 *sumJitterNs, qint64 *maxJitterNs);
+    void playHardware(const Tone &tone);
+
+    QMutex m_mutex;
+    QWaitCondition m_cond;
+    QQueue<QVector<Tone> > m_queue;
+    bool m_stop = false;
+};
+
+// LED 线程：按灯效描述驱动 LED，反馈里的音序转交给蜂鸣器线程
+// 新反馈到来时立即替换当前灯效；没有灯效在变化时一直睡在条件变量上
+class LedThread : public QThread
+{
+    Q_OBJECT
+public:
+    HardwareBackend *backend = nullptr;
+    BuzzerThread *buzzer = nullptr; // 为空时丢弃音序
+
+    void post(const Feedback &feedback);
+    void stop();
+
+protected:
+    void run() override;
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_cond;
+    QQueue<Feedback> m_queue;
+    bool m_stop = false;
 };
 
 // 硬件控制主类
@@ -30,30 +134,38 @@ public:
     static HardwareControl* instance(); // 单例获取
     void initHardware();                // 初始化
 
-    // 硬件动作接口
+    // 硬件动作接口：都只是往 LED 线程的队列里放一条反馈，立即返回
+    void signalSuccess();      // 操作成功：LED 亮 + 蜂鸣器响
     void flashLedSuccess();    // LED 闪烁
     void playSuccessSound();   // 蜂鸣器响
+    void playTones(const QVector<Tone> &melody); // 播放音序
+    void post(const Feedback &feedback);
+    void trace(const char *event);     // 记录应用层事件 (仿真后端统计按键到该事件的延迟)
+
+    static const int INPUT_FRAME_MS = 16; // GUI 取按键事件的间隔 (一帧)
 
 private:
     explicit HardwareControl(QObject *parent = nullptr);
     static HardwareControl* m_instance;
 
-    // 内存映射指针
-    volatile unsigned int* gpioc_base; // 蜂鸣器
-    volatile unsigned int* gpiob_base; // 按键
+    HardwareBackend *backend; // 硬件抽象层，initHardware 时按环境选择
 
     // 辅助对象
     KeyMonitorThread *keyThread;
-    QTimer *beepTimer;
-    int beepDuration = 0;
-    bool beepState = false;
+    BuzzerThread *buzzerThread;
+    LedThread *ledThread;
+    QTimer *inputTimer;        // 每帧取一次按键事件
+    UiLagProbe *beepProbe;     // 蜂鸣期间统计界面帧间隔
+    int pendingMelodies = 0;
+    qint64 lastPressNs = 0;    // 最近一次按下的时刻，统计按下到反馈的延迟
 
 signals:
     void urgeOrderTriggered(); // 【关键】转发给 UI 的信号
+    void keyEvent(int key, bool pressed, qint64 tsNs); // 所有按键的原始事件，给以后的按键功能用
 
 private slots:
-    void stopLed();
-    void toggleBeep();
+    void drainInput();
+    void onMelodyFinished(int toggles, qint64 avgJitterUs, qint64 maxJitterUs);
 };
 
 #endif // HARDWARECONTROL_H
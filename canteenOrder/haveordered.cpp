@@ -1,24 +1,22 @@
 #include "haveordered.h"
 #include "hardwarecontrol.h"
+#include "brandstyle.h"
 #include <QHBoxLayout>
 #include <QDebug>
 #include <QScroller>
-#include <QMessageBox>
+#include "toastmanager.h"
+#include "orderpublisher.h"
 #include <QTimer>
 #include <QDateTime>
 
 HaveOrdered::HaveOrdered(QWidget *parent) : QWidget(parent)
 {
-    this->setAttribute(Qt::WA_StyledBackground);
-    this->setStyleSheet("background-color: #F5F5F5;"); // 全局浅灰背景，突出内容卡片感
+    BrandStyle::setPanel(this, BrandStyle::Look(QColor("#F5F5F5"))); // 全局浅灰背景，突出内容卡片感
 
     initUI();
 
-    m_mqtt = new MiniMqtt(this);
-    connect(m_mqtt, &MiniMqtt::connected, [=](){
-        qDebug() << "HaveOrdered: MQTT Connected!";
-    });
-    m_mqtt->connectToHost(MQTT_IP, MQTT_PORT);
+    // 催单走程序共用的会话，本页 (内存紧张时会被释放) 不再自己连
+    m_mqtt = OrderPublisher::instance()->session();
 }
 
 void HaveOrdered::initUI()
@@ -30,16 +28,16 @@ void HaveOrdered::initUI()
     // === 1. 顶部 Header 区域 (橙色背景) ===
     QWidget *headerContainer = new QWidget(this);
     headerContainer->setFixedHeight(60);
-    headerContainer->setStyleSheet("background-color: #FF8C00;"); // 品牌橙色
+    BrandStyle::setPanel(headerContainer, BrandStyle::Look(QColor("#FF8C00"))); // 品牌橙色
 
     QHBoxLayout *headerLayout = new QHBoxLayout(headerContainer);
     headerLayout->setContentsMargins(20, 0, 20, 0);
 
     lblTitle = new QLabel("历史订单", this);
-    lblTitle->setStyleSheet("color: white; font-size: 20px; font-weight: bold; font-family: 'Microsoft YaHei';");
+    BrandStyle::setText(lblTitle, Qt::white, 20, true, "Microsoft YaHei");
 
     lblCountInfo = new QLabel("共 0 道菜品", this);
-    lblCountInfo->setStyleSheet("color: rgba(255,255,255,0.8); font-size: 16px;");
+    BrandStyle::setText(lblCountInfo, QColor(255, 255, 255, 204), 16);
 
     headerLayout->addWidget(lblTitle);
     headerLayout->addStretch();
@@ -54,37 +52,27 @@ void HaveOrdered::initUI()
     // 支持触摸滑动
     QScroller::grabGesture(listOrders, QScroller::LeftMouseButtonGesture);
 
-    // 列表美化样式
-    listOrders->setStyleSheet(
-                "QListWidget {"
-                "   background-color: white;"
-                "   border: none;"
-                "   outline: none;"
-                "}"
-                "QListWidget::item {"
-                "   height: 60px;"                 // 增加行高，方便查看
-                "   border-bottom: 1px solid #EEE;" // 优雅的分割线
-                "   padding-left: 20px;"
-                "   padding-right: 20px;"
-                "   color: #333;"
-                "   font-size: 18px;"
-                "}"
-                );
+    // 列表美化样式：白底、60px 行高、分隔线
+    listOrders->setFrameShape(QFrame::NoFrame);
+    BrandItemDelegate *orderDelegate = new BrandItemDelegate(60, 18, QColor("#333333"), listOrders);
+    orderDelegate->setPadding(20, 20);       // 左右留白
+    orderDelegate->setDivider(QColor("#EEEEEE")); // 优雅的分割线
+    listOrders->setItemDelegate(orderDelegate);
 
     // === 3. 底部状态栏 (白色悬浮感) ===
     QWidget *bottomBar = new QWidget(this);
     bottomBar->setFixedHeight(50);
-    bottomBar->setStyleSheet("background-color: white; border-top: 1px solid #DDD;");
+    BrandStyle::setPanel(bottomBar, BrandStyle::Look(Qt::white).border(QColor("#DDDDDD"), 1, Qt::TopEdge));
 
     QHBoxLayout *bottomLayout = new QHBoxLayout(bottomBar);
     bottomLayout->setContentsMargins(20, 0, 20, 0);
 
     // 加一个小图标或者圆点装饰
     QLabel *dotLabel = new QLabel("●", this);
-    dotLabel->setStyleSheet("color: #26C28D; font-size: 14px;"); // 绿色圆点
+    BrandStyle::setText(dotLabel, QColor("#26C28D"), 14); // 绿色圆点
 
     lblStatus = new QLabel("当前无进行中的订单", this);
-    lblStatus->setStyleSheet("color: #666; font-size: 16px; font-weight: bold;");
+    BrandStyle::setText(lblStatus, QColor("#666666"), 16, true);
 
     bottomLayout->addWidget(dotLabel);
     bottomLayout->addSpacing(10);
@@ -194,26 +182,22 @@ void HaveOrdered::handleUrge()
     QString jsonCmd = "{\"type\":\"service\", \"action\":\"urge\", \"table\":1}";
 
     m_mqtt->publish("canteen/service/urge", jsonCmd);
+    HardwareControl::instance()->trace("mqtt_publish");
     qDebug() << "Urge sent:" << jsonCmd;
 
-    HardwareControl::instance()->flashLedSuccess();
-    HardwareControl::instance()->playSuccessSound();
+    HardwareControl::instance()->signalSuccess();
 
     lblStatus->setText(QStringLiteral("已发送催单提醒！厨师收到了！"));
-    lblStatus->setStyleSheet("color: #FF0000; font-size: 16px; font-weight: bold;");
+    BrandStyle::setText(lblStatus, QColor("#FF0000"), 16, true);
 
     QTimer::singleShot(3000, this, [=](){
         lblStatus->setText(QStringLiteral("后厨正在加紧制作中，请耐心等待..."));
-        lblStatus->setStyleSheet("color: #666; font-size: 16px; font-weight: bold;");
+        BrandStyle::setText(lblStatus, QColor("#666666"), 16, true);
     });
 
     // 弹窗提示
-    QMessageBox *box = new QMessageBox(QMessageBox::Information,
-                                       QStringLiteral("催单成功"),
-                                       QStringLiteral("您的催单请求已发送！\n服务员马上就来！"),
-                                       QMessageBox::Ok, this);
-    QTimer::singleShot(2000, box, SLOT(close()));
-    box->show();
+    ToastManager::instance()->show(QStringLiteral("您的催单请求已发送！\n服务员马上就来！"),
+                                   ToastManager::Info, "urge");
 }
 
 bool HaveOrdered::hasOrders() const
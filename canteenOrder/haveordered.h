@@ -38,7 +38,7 @@ private:
     QLabel *lblStatus;       // 底部状态栏
     QMap<QString, int> m_totalOrderedItems; // 数据源
     QPushButton *m_btnUrge; // 催单按钮
-    MiniMqtt *m_mqtt;
+    MiniMqtt *m_mqtt;        // OrderPublisher 的共用会话，不归本页所有
 };
 
 #endif // HAVEORDERED_H
@@ -0,0 +1,68 @@
+#include "lazypagestack.h"
+#include <QVBoxLayout>
+#include <QElapsedTimer>
+#include <QDebug>
+
+LazyPageStack::LazyPageStack(QWidget *parent) : QStackedWidget(parent)
+{
+}
+
+int LazyPageStack::addPage(const Factory &factory, bool releasable)
+{
+    Slot slot;
+    slot.container = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(slot.container);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+    slot.factory = factory;
+    slot.releasable = releasable;
+    m_slots.append(slot);
+    return addWidget(slot.container);
+}
+
+QWidget *LazyPageStack::page(int index) const
+{
+    if (index < 0 || index >= m_slots.size()) return nullptr;
+    return m_slots.at(index).page;
+}
+
+QWidget *LazyPageStack::ensurePage(int index)
+{
+    if (index < 0 || index >= m_slots.size()) return nullptr;
+    Slot &slot = m_slots[index];
+    if (slot.page) return slot.page;
+
+    QElapsedTimer timer;
+    timer.start();
+    QWidget *page = slot.factory();
+    slot.container->layout()->addWidget(page);
+    slot.page = page;
+    qDebug().noquote() << QString("[Pages] page %1 created in %2 ms").arg(index).arg(timer.elapsed());
+    emit pageCreated(index, page);
+    return page;
+}
+
+void LazyPageStack::showPage(int index)
+{
+    if (!ensurePage(index)) return;
+    setCurrentIndex(index);
+}
+
+int LazyPageStack::releaseIdle()
+{
+    int released = 0;
+    for (int i = 0; i < m_slots.size(); ++i) {
+        Slot &slot = m_slots[i];
+        if (!slot.releasable || !slot.page || i == currentIndex()) continue;
+        // 可能正处在这个页面自己发出的信号里，延后删除；指针先清掉，再进来就会重新创建
+        QWidget *page = slot.page;
+        slot.page = nullptr;
+        page->hide();
+        connect(page, &QObject::destroyed, this, [=](){ emit pageDestroyed(i); });
+        page->deleteLater();
+        ++released;
+        qDebug().noquote() << QString("[Pages] page %1 released").arg(i);
+        emit pageReleased(i);
+    }
+    return released;
+}
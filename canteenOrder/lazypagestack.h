@@ -0,0 +1,41 @@
+#ifndef LAZYPAGESTACK_H
+#define LAZYPAGESTACK_H
+
+#include <QStackedWidget>
+#include <QPointer>
+#include <QVector>
+#include <functional>
+
+// 按需创建页面的 QStackedWidget
+// 每个下标先放一个空容器，注册的工厂在第一次切到这一页时才调用；
+// 标记为可释放的页面在内存紧张时可以删掉，下次进入重新创建。容器一直在，下标不会变
+class LazyPageStack : public QStackedWidget
+{
+    Q_OBJECT
+public:
+    typedef std::function<QWidget *()> Factory;
+
+    explicit LazyPageStack(QWidget *parent = nullptr);
+
+    int addPage(const Factory &factory, bool releasable = false); // 返回页面下标
+    QWidget *page(int index) const;     // 还没创建 (或已释放) 返回 nullptr
+    QWidget *ensurePage(int index);     // 没有就马上创建
+    void showPage(int index);           // 创建 (如需要) 并切换过去
+    int releaseIdle();                  // 释放不在前台的可释放页面，返回释放个数
+
+signals:
+    void pageCreated(int index, QWidget *page);
+    void pageReleased(int index);       // 已从栈里摘下，对象还要等 deleteLater
+    void pageDestroyed(int index);      // 对象真正删除时发出
+
+private:
+    struct Slot {
+        QWidget *container;
+        Factory factory;
+        bool releasable;
+        QPointer<QWidget> page;
+    };
+    QVector<Slot> m_slots;
+};
+
+#endif // LAZYPAGESTACK_H
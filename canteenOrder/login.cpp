@@ -1,7 +1,12 @@
 #include "login.h"
 #include "dbmanager.h"
-#include <QMessageBox>
+#include "boottrace.h"
+#include "toastmanager.h"
 #include <QEvent>
+#include <QTimer>
+
+// 登录界面显示出来之后再开始准备主界面，不和首帧抢时间
+#define MAIN_PREPARE_DELAY_MS 300
 
 login::login(QWidget *parent) : QWidget(parent)
 {
@@ -51,6 +56,7 @@ login::login(QWidget *parent) : QWidget(parent)
     connect(btnLogin, SIGNAL(clicked()), this, SLOT(onLoginClicked()));
     connect(btnToRegister, SIGNAL(clicked()), this, SLOT(showRegisterPage()));
     connect(registerPage, SIGNAL(goBackToLogin()), this, SLOT(showLoginPage()));
+    connect(&DBManager::instance(), &DBManager::loginFinished, this, &login::onLoginFinished);
 
     // --- 4. 键盘 ---
     keyboard = new SoftKeyboard(this);
@@ -58,6 +64,10 @@ login::login(QWidget *parent) : QWidget(parent)
 
     userEdit->installEventFilter(this);
     passEdit->installEventFilter(this);
+
+    // --- 5. 趁用户输入账号密码时准备主界面 ---
+    m_mainWin = nullptr;
+    QTimer::singleShot(MAIN_PREPARE_DELAY_MS, this, SLOT(prepareMainInterface()));
 }
 
 login::~login() {}
@@ -67,24 +77,52 @@ void login::onLoginClicked()
     QString name = userEdit->text();
     QString pass = passEdit->text();
 
-    // 验证用户名和密码
-    if(DBManager::instance().loginUser(name, pass)){
+    // 验证用户名和密码 (后台计算，结果在 onLoginFinished 中处理)
+    setVerifying(true);
+    DBManager::instance().loginUserAsync(name, pass);
+}
+
+void login::onLoginFinished(const QString &username, bool ok)
+{
+    Q_UNUSED(username);
+    setVerifying(false);
+
+    if(ok){
         // 1. 先把软键盘收起来
         SoftKeyboard::instance()->hide();
 
-        // 3. 创建主界面对象
-        MainInterface *mainWin = new MainInterface();
+        // 3. 主界面一般已经在后台准备好了，这里只补上没做完的步骤
+        BootTrace::instance()->begin("mainInterface.construct");
+        if (!m_mainWin) m_mainWin = new MainInterface();
+        m_mainWin->finishPreparation();
+        BootTrace::instance()->end("mainInterface.construct");
 
         // 4. 显示主界面
-        mainWin->showFullScreen();
+        BootTrace::instance()->watchFirstPaint(m_mainWin, "mainInterface.firstPaint");
+        m_mainWin->showFullScreen();
         this->close();
     } else {
-        QMessageBox::warning(this, "错误", "用户名或密码错误");
-        name.clear();
-        pass.clear();
+        ToastManager::instance()->show("用户名或密码错误", ToastManager::Warning);
+        passEdit->clear();
     }
 }
 
+void login::prepareMainInterface()
+{
+    if (m_mainWin) return;
+    m_mainWin = new MainInterface();
+    m_mainWin->prepareInSteps();
+}
+
+void login::setVerifying(bool busy)
+{
+    btnLogin->setEnabled(!busy);
+    btnToRegister->setEnabled(!busy);
+    userEdit->setEnabled(!busy);
+    passEdit->setEnabled(!busy);
+    btnLogin->setText(busy ? "验证中..." : "登 录");
+}
+
 void login::showRegisterPage()
 {
     loginContainer->hide();
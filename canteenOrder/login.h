@@ -23,10 +23,14 @@ protected:
 
 private slots:
     void onLoginClicked();
+    void onLoginFinished(const QString &username, bool ok);
     void showRegisterPage();
     void showLoginPage();
+    void prepareMainInterface();    // 登录界面空闲时先把主界面准备好
 
 private:
+    void setVerifying(bool busy); // 口令校验中的界面状态
+
     QLineEdit *userEdit;
     QLineEdit *passEdit;
     QPushButton *btnLogin;
@@ -37,6 +41,7 @@ private:
     QVBoxLayout *mainLayout;
 
     SoftKeyboard *keyboard;
+    MainInterface *m_mainWin;       // 预先准备的主界面，登录成功后直接显示
 };
 
 #endif // LOGIN_H
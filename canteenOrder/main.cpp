@@ -1,19 +1,80 @@
 #include "login.h"
 #include "hardwarecontrol.h"
+#include "dbmanager.h"
+#include "backupjob.h"
+#include "orderexport.h"
+#include "yuvconvert.h"
+#include "menucatalog.h"
+#include "startup.h"
+#include "boottrace.h"
+#include "brandstyle.h"
+#include "qrcode.h"
+#include "orderpublisher.h"
 #include <QApplication>
 #include <QSplashScreen>
 #include <QPixmap>
 #include <QTimer>
-#include <QEventLoop>
 #include <QDebug>
+#include <QDate>
 #include <QTextCodec>
+#include <QDir>
+#include <QtConcurrent>
 
 int main(int argc, char *argv[])
 {
+    // 进程创建到这里是动态链接和静态初始化的时间
+    BootTrace::instance()->mark("main");
     QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
 
+    BootTrace::instance()->begin("qapplication");
     QApplication a(argc, argv);
-    HardwareControl::instance()->initHardware();
+    BootTrace::instance()->end("qapplication");
+
+    // 性能测试模式：跑完直接退出，不进入界面
+    if (a.arguments().contains("--bench-db")) {
+        DBManager::runBenchmark();
+        return 0;
+    }
+    if (a.arguments().contains("--bench-ui")) {
+        BrandStyle::runBenchmark();
+        return 0;
+    }
+    if (a.arguments().contains("--bench-video")) {
+        return YuvConvert::runBenchmark() ? 0 : 1;
+    }
+    if (a.arguments().contains("--bench-qr")) {
+        QrCode::runBenchmark();
+        return 0;
+    }
+    // 日结导出 / 报表模式：--export-day yyyy-MM-dd，--report 文件
+    int argIndex = a.arguments().indexOf("--export-day");
+    if (argIndex > 0) {
+        QString arg = argIndex + 1 < a.arguments().size() ? a.arguments().at(argIndex + 1) : QString();
+        QDate day = QDate::fromString(arg, "yyyy-MM-dd");
+        if (!day.isValid()) {
+            // 无效日期会导出成 orders-.ccol，直接报错退出
+            qDebug().noquote() << "Usage: canteenOrder --export-day yyyy-MM-dd (invalid date:" << (arg.isEmpty() ? QString("<missing>") : arg) << ")";
+            return 2;
+        }
+        QDir().mkpath(EXPORT_DIR);
+        QString out = QDir(EXPORT_DIR).filePath(OrderExporter::fileNameFor(day));
+        return OrderExporter::exportDay(DBManager::instance().databasePath(), day, out) ? 0 : 1;
+    }
+    // 启动时间线对比：--boot-diff 旧文件 新文件
+    argIndex = a.arguments().indexOf("--boot-diff");
+    if (argIndex > 0 && argIndex + 2 < a.arguments().size()) {
+        return BootTrace::diff(a.arguments().at(argIndex + 1), a.arguments().at(argIndex + 2)) ? 0 : 1;
+    }
+    argIndex = a.arguments().indexOf("--report");
+    if (argIndex > 0 && argIndex + 1 < a.arguments().size()) {
+        OrderReportReader::Report report;
+        if (!OrderReportReader::read(a.arguments().at(argIndex + 1), &report)) return 1;
+        OrderReportReader::print(report);
+        return 0;
+    }
+
+    StartupSequencer startup;
+    BootTrace::instance()->begin("splash");
     QPixmap pixmap(":/res/startup.png");
     if (pixmap.isNull()) {
         qDebug() << "warning:picture path can not find....";
@@ -25,31 +86,52 @@ int main(int argc, char *argv[])
     QSplashScreen splash(pixmap);
     splash.setFixedSize(800, 480);
     splash.show(); // 显示画面
+    a.processEvents();
+    BootTrace::instance()->end("splash");
+
+    // 互不依赖的启动工作并行跑，启动画面只显示到它们完成为止
+    startup.runInBackground("database", []() { DBManager::prepareDatabase(); });
+    startup.runInBackground("catalog", []() {
+        MenuCatalog::allDishes();
+        MenuCatalog::warmThumbnails();
+    });
+
+    startup.begin("hardware");
+    HardwareControl::instance()->initHardware();
+    startup.end("hardware");
+
+    startup.begin("style");
+    BrandStyle::install(&a);
+    startup.end("style");
 
-    QEventLoop loop;
-    QTimer::singleShot(3000, &loop, SLOT(quit()));
-    loop.exec();
-    QString qss =
-            "QWidget { background-color: #FFF5E6; color: #5D4037; font-family: 'Microsoft YaHei'; font-size: 18px; }"
-            "QLineEdit { border: 2px solid #D7CCC8; border-radius: 8px; padding: 10px; background-color: white; font-size: 20px; }"
-            "QLineEdit:focus { border: 2px solid #FF8C00; background-color: #FFFDE7; }"
-            "QPushButton { background-color: #FF8C00; color: white; border-radius: 10px; padding: 10px; font-weight: bold; font-size: 20px; border-bottom: 4px solid #E65100; }"
-            "QPushButton:pressed { background-color: #E65100; border-bottom: 0px; margin-top: 4px; }"
-            "QPushButton#SecondaryButton { background-color: #A1887F; border-bottom: 4px solid #5D4037; }"
-            "QPushButton#SecondaryButton:pressed { background-color: #8D6E63; border-bottom: 0px; margin-top: 4px; }"
-            "QLabel#Title { font-size: 32px; font-weight: bold; color: #BF360C; }"
-            "SoftKeyboard { background-color: #3E2723; border-top: 4px solid #5D4037; border-top-left-radius: 20px; border-top-right-radius: 20px; }"
-            "SoftKeyboard QPushButton { background-color: #FFF8E1; color: #3E2723; border: none; border-radius: 6px; font-size: 20px; font-weight: bold; border-bottom: 3px solid #D7CCC8; }"
-            "SoftKeyboard QPushButton:pressed { background-color: #FFECB3; border-bottom: 0px; margin-top: 3px; }"
-            "SoftKeyboard QPushButton#SpaceKey { background-color: white; border-bottom: 3px solid #CFD8DC; }"
-            "SoftKeyboard QPushButton#FuncKey { background-color: #6D4C41; color: white; border-bottom: 3px solid #3E2723; }"
-            "SoftKeyboard QPushButton#FuncKey:pressed { background-color: #5D4037; border-bottom: 0px; margin-top: 3px; }"
-            "SoftKeyboard QPushButton#ActionKey { background-color: #FF6F00; color: white; border-bottom: 3px solid #BF360C; }"
-            "SoftKeyboard QPushButton#ActionKey:pressed { background-color: #E65100; border-bottom: 0px; margin-top: 3px; }";
-    a.setStyleSheet(qss);
+    // 登录界面构造时要用数据库，主界面要用菜品图
+    startup.waitFor("database");
+    // 程序共用的 MQTT 会话：这里只发起连接、载入没送达的订单，不等连上 (离线也要能开机点餐)。
+    // 点餐页、已点页和订单发布都用这一条连接，登录后不用再建
+    startup.begin("mqtt");
+    OrderPublisher::instance();
+    startup.end("mqtt");
+    startup.begin("login");
     login w;
+    startup.end("login");
+    startup.waitFor("catalog");
     splash.finish(&w);
+    BootTrace::instance()->watchFirstPaint(&w, "login.firstPaint");
     w.show();
+    startup.report();
+
+    // 数据库定时在线备份 (后台低优先级线程)
+    BackupManager::instance()->start(BACKUP_INTERVAL_MIN);
+
+    // 日结导出：启动时补导之前没导出的日期，之后每小时检查一次 (后台线程)
+    QString dbPath = DBManager::instance().databasePath();
+    auto exportPending = [dbPath]() {
+        QtConcurrent::run([dbPath]() { OrderExporter::exportMissingDays(dbPath, EXPORT_DIR); });
+    };
+    QTimer exportTimer;
+    QObject::connect(&exportTimer, &QTimer::timeout, exportPending);
+    exportTimer.start(60 * 60 * 1000);
+    exportPending();
 
     return a.exec();
 }
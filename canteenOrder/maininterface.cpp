@@ -1,10 +1,17 @@
 #include "maininterface.h"
+#include "dbmanager.h"
+#include "salesstats.h"
+#include "brandstyle.h"
+#include "postercache.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QDebug>
 #include <QCoreApplication>
 #include <QPixmap>
+#include <QFile>
+#include <QElapsedTimer>
+#include <malloc.h>
 
 MainInterface::MainInterface(QWidget *parent) : QWidget(parent)
 {
@@ -17,10 +24,15 @@ MainInterface::MainInterface(QWidget *parent) : QWidget(parent)
     m_orderPage = nullptr;
     m_videoPage = nullptr;
     m_settlePage = nullptr;
+    m_haveOrderedPage = nullptr;
+    m_memoryTimer = nullptr;
+    m_prepareStep = PREPARE_CACHES;
+    m_prepareTimer = new QTimer(this);
+    m_prepareTimer->setSingleShot(true);
+    m_prepareTimer->setInterval(0);
+    connect(m_prepareTimer, SIGNAL(timeout()), this, SLOT(prepareStep()));
 
-    this->setStyleSheet(
-                "MainInterface { background-color: #FFFFFF; font-family: 'Microsoft YaHei'; }"
-                );
+    BrandStyle::setPanel(this, BrandStyle::Look(Qt::white));
 
     initUI();
 }
@@ -34,45 +46,114 @@ void MainInterface::initUI()
     initHeader(); // 初始化头部和Tab
 
     // === 初始化 StackedWidget 和子页面 ===
-    stackedWidget = new QStackedWidget(this);
+    // 页面在第一次进入时才创建 (mplayer 进程、菜品列表都跟着推迟)
+    stackedWidget = new LazyPageStack(this);
 
     // 1. 点餐页
-    m_orderPage = new OrderWidget(this);
-    stackedWidget->addWidget(m_orderPage); // Index 0
-
-    // 2. 视频页
-    m_videoPage = new VideoWidget(this);
-    connect(m_videoPage, SIGNAL(videoStarted()), this, SLOT(handleVideoStarted()));
-    connect(m_videoPage, SIGNAL(videoStopped()), this, SLOT(handleVideoStopped()));
-    stackedWidget->addWidget(m_videoPage); // Index 1
+    stackedWidget->addPage([=]() {
+        m_orderPage = new OrderWidget();
+        return m_orderPage;
+    });
+
+    // 2. 视频页：不常用，内存紧张时可以释放
+    stackedWidget->addPage([=]() {
+        m_videoPage = new VideoWidget();
+        connect(m_videoPage, SIGNAL(videoStarted()), this, SLOT(handleVideoStarted()));
+        connect(m_videoPage, SIGNAL(videoStopped()), this, SLOT(handleVideoStopped()));
+        return m_videoPage;
+    }, true);
 
     // 3. 结算页 (SettleWidget)
     // 注意：这里假设 SettleWidget 就是你实现 MQTT 发送的那个界面
-    m_settlePage = new SettleWidget(this);
-    connect(m_settlePage, SIGNAL(paySuccess()), this, SLOT(handlePaySuccess()));
-    stackedWidget->addWidget(m_settlePage); // Index 2
-
-    // 4. 已点菜品页 (Index 3)
-    m_haveOrderedPage = new HaveOrdered(this);
-    stackedWidget->addWidget(m_haveOrderedPage);
+    stackedWidget->addPage([=]() {
+        m_settlePage = new SettleWidget();
+        connect(m_settlePage, SIGNAL(paySuccess()), this, SLOT(handlePaySuccess()));
+        return m_settlePage;
+    });
+
+    // 4. 已点菜品页
+    stackedWidget->addPage([=]() {
+        m_haveOrderedPage = new HaveOrdered();
+        return m_haveOrderedPage;
+    });
 
     // 连接 Stack 切换信号
     connect(stackedWidget, SIGNAL(currentChanged(int)), this, SLOT(onPageChanged(int)));
 
+    // 页面真正删除后再把空闲堆还给系统，RSS 才会降下来。
+    // destroyed() 发出时子控件可能还没析构完，排到下一轮事件循环再 trim
+    connect(stackedWidget, &LazyPageStack::pageDestroyed, this, [=](){
+        QTimer::singleShot(0, this, [](){ malloc_trim(0); });
+    });
+
+    m_memoryTimer = new QTimer(this);
+    connect(m_memoryTimer, SIGNAL(timeout()), this, SLOT(checkMemoryPressure()));
+    m_memoryTimer->start(MEMORY_CHECK_MS);
+
     mainLayout->addWidget(headerWidget);
     mainLayout->addWidget(tabWidget);
     mainLayout->addWidget(stackedWidget);
 
-    // 默认显示第一页
-    onPageChanged(0);
+    // 第一页 (点餐页) 在 prepareStep() 里创建
+}
+
+
+void MainInterface::prepareInSteps()
+{
+    if (!isPrepared()) m_prepareTimer->start();
 }
 
+void MainInterface::finishPreparation()
+{
+    while (!isPrepared()) prepareStep();
+    m_prepareTimer->stop();
+
+    // 准备步骤在登录前就会构造点餐页，它的 MQTT 收发和硬件催单等到真正登录才开始
+    stackedWidget->ensurePage(PAGE_ORDER);
+    if (m_orderPage) m_orderPage->activate();
+}
+
+// 每次只做一步，做完排下一步；步骤之间回到事件循环，登录界面的输入和重绘不受影响
+void MainInterface::prepareStep()
+{
+    if (isPrepared()) return;
+    QElapsedTimer timer;
+    timer.start();
+    int step = m_prepareStep++;
+
+    switch (step) {
+    case PREPARE_CACHES:
+        // 不涉及界面的部分：销量统计 (读库)、视频海报 (后台线程开始抽帧)
+        SalesStats::instance();
+        PosterCache::instance()->prefetchDir(VIDEO_DIR);
+        break;
+    case PREPARE_ORDER_PAGE:
+        // 点餐页：分类和首屏菜品行 (MQTT 和硬件信号登录后才接上)，其余菜品行由点餐页自己分批补
+        stackedWidget->showPage(PAGE_ORDER);
+        onPageChanged(PAGE_ORDER);
+        break;
+    case PREPARE_POLISH:
+        // 提前 polish 和排版，显示时不用再做
+        for (QWidget *child : findChildren<QWidget *>()) child->ensurePolished();
+        layout()->activate();
+        break;
+    default:
+        break;
+    }
+
+    qDebug().noquote() << QString("[MainInterface] prepare step %1: %2 ms").arg(step).arg(timer.elapsed());
+    if (isPrepared()) {
+        emit prepared();
+    } else if (!m_prepareTimer->isActive()) {
+        m_prepareTimer->start();
+    }
+}
 
 void MainInterface::initHeader()
 {
     headerWidget = new QWidget(this);
     headerWidget->setFixedHeight(90);
-    headerWidget->setStyleSheet("background-color: #2D2D2D;");
+    BrandStyle::setPanel(headerWidget, BrandStyle::Look(QColor("#2D2D2D")));
 
     QHBoxLayout *hLayout = new QHBoxLayout(headerWidget);
     hLayout->setContentsMargins(15, 10, 15, 0);
@@ -83,7 +164,9 @@ void MainInterface::initHeader()
     if (pixmap.isNull()) {
         // 图片加载失败
         imgLabel->setText("LOGO");
-        imgLabel->setStyleSheet("background-color: #FF8C00; color: white; border-radius: 8px; font-weight: bold; qproperty-alignment: AlignCenter;");
+        imgLabel->setAlignment(Qt::AlignCenter);
+        BrandStyle::setPanel(imgLabel, BrandStyle::Look(QColor("#FF8C00"), 8));
+        BrandStyle::setText(imgLabel, Qt::white, 18, true);
         qDebug() << "警告: 图片加载失败，请检查路径";
     } else {
         // 图片加载成功
@@ -91,14 +174,13 @@ void MainInterface::initHeader()
 
         imgLabel->setPixmap(scaledPix);
         imgLabel->setAlignment(Qt::AlignCenter);
-        imgLabel->setStyleSheet("background-color: transparent; border-radius: 8px;");
     }
 
     QVBoxLayout *infoLayout = new QVBoxLayout();
     QLabel *nameLabel = new QLabel("美滋滋寿司餐厅", headerWidget);
-    nameLabel->setStyleSheet("color: white; font-size: 22px; font-weight: bold;");
+    BrandStyle::setText(nameLabel, Qt::white, 22, true);
     QLabel *detailLabel = new QLabel("★★★★★ 4.9分 | 配送 5 元", headerWidget);
-    detailLabel->setStyleSheet("color: #AAAAAA; font-size: 12px;");
+    BrandStyle::setText(detailLabel, QColor("#AAAAAA"), 12);
 
     infoLayout->addWidget(nameLabel);
     infoLayout->addWidget(detailLabel);
@@ -110,7 +192,7 @@ void MainInterface::initHeader()
     // 导航 Tab 栏
     tabWidget = new QWidget(this);
     tabWidget->setFixedHeight(60);
-    tabWidget->setStyleSheet("background-color: white; border-bottom: 1px solid #E0E0E0;");
+    BrandStyle::setPanel(tabWidget, BrandStyle::Look(Qt::white).border(QColor("#E0E0E0"), 1, Qt::BottomEdge));
 
     QHBoxLayout *tabLayout = new QHBoxLayout(tabWidget);
 
@@ -122,12 +204,10 @@ void MainInterface::initHeader()
         btn->setObjectName(objName);
         btn->setCheckable(true);
         btn->setFixedWidth(120);
-        btn->setStyleSheet(
-                    "QPushButton { border: none; font-size: 16px; color: #666; background: transparent; padding-bottom: 10px; margin-top: 10px; }"
-                    "QPushButton:checked { color: #333; font-weight: bold; border-bottom: 3px solid #FFD161; }"
-                    );
+        btn->setFixedHeight(60);
+        BrandStyle::setButton(btn, BrandStyle::Look().checked(QColor("#333333"), QColor("#FFD161")), QColor("#666666"), 16);
         connect(btn, &QPushButton::clicked, [=](){
-            if(stackedWidget) stackedWidget->setCurrentIndex(index);
+            if(stackedWidget) stackedWidget->showPage(index);
             });
         return btn;
         };
@@ -167,7 +247,7 @@ void MainInterface::onPageChanged(int index)
     }
 
     // 2. 特殊逻辑：如果切换到了“确认下单”页 (Index 2)
-    if (index == 2) {
+    if (index == PAGE_SETTLE) {
         if (m_orderPage && m_settlePage) {
             // A. 同步购物车数据和价格 (用于界面显示)
             QMap<QString, int> cart = m_orderPage->getCartData();
@@ -179,7 +259,7 @@ void MainInterface::onPageChanged(int index)
             m_settlePage->setOrderData(mqttJson);
         }
     }
-    if (index != 1 && m_videoPage) {
+    if (index != PAGE_VIDEO && m_videoPage) {
         m_videoPage->stopVideo();
     }
 }
@@ -198,12 +278,17 @@ void MainInterface::handleVideoStopped()
 
 void MainInterface::handlePaySuccess()
 {
-    // 1. 将订单数据移动到“已点菜品”历史记录
+    // 1. 将订单数据移动到“已点菜品”历史记录 (历史页还没打开过的话现在创建)
+    stackedWidget->ensurePage(PAGE_HAVE_ORDERED);
     if (m_orderPage && m_haveOrderedPage) {
         // 获取购物车数据
         QMap<QString, int> cart = m_orderPage->getCartData();
         if (!cart.isEmpty()) {
             m_haveOrderedPage->addOrder(cart);
+            // 落库，供统计和报表使用
+            qint64 orderId = DBManager::instance().saveOrder(1, m_orderPage->orderNo(), cart, m_orderPage->getPriceData());
+            qDebug() << "Order saved, id:" << orderId;
+            SalesStats::instance()->recordSale(cart);
         }
     }
 
@@ -214,6 +299,32 @@ void MainInterface::handlePaySuccess()
 
     // 3. 支付成功后自动跳转回点餐首页
     if (stackedWidget) {
-        stackedWidget->setCurrentIndex(0);
+        stackedWidget->showPage(PAGE_ORDER);
+    }
+}
+
+// /proc/meminfo 的 MemAvailable (KB)，读不到返回 -1
+static qint64 availableMemoryKb()
+{
+    QFile file("/proc/meminfo");
+    if (!file.open(QIODevice::ReadOnly)) return -1;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (line.startsWith("MemAvailable:")) {
+            return line.mid(13).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+
+void MainInterface::checkMemoryPressure()
+{
+    qint64 availKb = availableMemoryKb();
+    if (availKb < 0 || availKb >= MEMORY_LOW_MB * 1024) return;
+
+    int released = stackedWidget->releaseIdle();
+    if (released > 0) {
+        // malloc_trim 在页面的 destroyed() 之后做 (见构造函数)
+        qDebug() << "Memory low:" << availKb / 1024 << "MB available, released" << released << "page(s)";
     }
 }
@@ -2,13 +2,15 @@
 #define MAININTERFACE_H
 
 #include <QWidget>
-#include <QStackedWidget>
+#include <QPointer>
+#include <QTimer>
 #include <QPushButton>
 #include "orderwidget.h"
 #include "videowidget.h"
 #include "settlewidget.h"
 #include "haveordered.h"
 #include "minimqtt.h"
+#include "lazypagestack.h"
 
 class MainInterface : public QWidget
 {
@@ -17,10 +19,24 @@ class MainInterface : public QWidget
 public:
     explicit MainInterface(QWidget *parent = nullptr);
 
+    // 分步准备：构造函数只搭外框，剩下的工作每轮事件循环做一步，
+    // 登录界面空闲时就可以先做；登录成功后 finishPreparation() 把没做完的步骤一次做完
+    void prepareInSteps();
+    void finishPreparation();
+    bool isPrepared() const { return m_prepareStep >= PREPARE_DONE; }
+
+signals:
+    void prepared();
+
 private:
     void initUI();
     void initHeader(); // 头部 Logo 和 Tab
 
+    // 页面下标
+    enum Page { PAGE_ORDER = 0, PAGE_VIDEO, PAGE_SETTLE, PAGE_HAVE_ORDERED };
+    // 准备步骤
+    enum PrepareStep { PREPARE_CACHES = 0, PREPARE_ORDER_PAGE, PREPARE_POLISH, PREPARE_DONE };
+
 private slots:
     void onPageChanged(int index);   // 页面切换逻辑
 
@@ -29,15 +45,21 @@ private slots:
     void handleVideoStopped();
     void handlePaySuccess();
 
+    void checkMemoryPressure();      // 可用内存低于 MEMORY_LOW_MB 时释放后台页面
+    void prepareStep();
+
 private:
     // 布局容器
     QWidget *headerWidget;
     QWidget *tabWidget;
-    QStackedWidget *stackedWidget;
+    LazyPageStack *stackedWidget;
+    QTimer *m_memoryTimer;
+    QTimer *m_prepareTimer;
+    int m_prepareStep;
 
-    // 三大子模块实例
+    // 子模块实例，第一次进入对应页面时才创建
     OrderWidget *m_orderPage;
-    VideoWidget *m_videoPage;
+    QPointer<VideoWidget> m_videoPage;  // 内存紧张时会被释放
     SettleWidget *m_settlePage;
     HaveOrdered *m_haveOrderedPage;
 };
@@ -0,0 +1,345 @@
+#include "mediaproxy.h"
+#include "segmentcache.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QElapsedTimer>
+#include <QUrl>
+#include <QFileInfo>
+#include <QDebug>
+
+#define SEG SegmentCache::SEGMENT_SIZE
+#define MAX_HEADER_BYTES 8192
+#define MAX_PENDING_WRITE (256 * 1024)  // socket 里积压超过这么多就等客户端读走
+
+// 一个播放器连接：解析一次 GET (可带 Range)，按段从缓存往外送，缺段时等下载
+class ProxySession : public QObject
+{
+public:
+    ProxySession(QTcpSocket *socket, MediaProxy *proxy);
+
+private:
+    void onReadyRead();
+    void onSegment(const QString &key, int index, bool ok);
+    void pump();
+    void sendHeader(qint64 total);
+    void fail(const char *status);
+
+    QTcpSocket *m_socket;
+    MediaProxy *m_proxy;
+    QByteArray m_request;
+    QString m_key;
+    QString m_name;
+    bool m_started = false;     // 请求头已解析
+    bool m_headerSent = false;
+    bool m_ranged = false;
+    qint64 m_pos = 0;           // 下一个要发的字节
+    qint64 m_end = -1;          // 最后一个要发的字节 (含)，-1 为到结尾
+    int m_waiting = -1;         // 正在等的段
+    QSet<int> m_fetched;        // 本次从网络等来的段
+    int m_cachedSegments = 0;
+    qint64 m_sent = 0;
+    qint64 m_firstByteMs = -1;
+    QElapsedTimer m_timer;
+};
+
+ProxySession::ProxySession(QTcpSocket *socket, MediaProxy *proxy)
+    : QObject(socket), m_socket(socket), m_proxy(proxy)
+{
+    m_timer.start();
+    connect(m_socket, &QTcpSocket::readyRead, this, [=](){ onReadyRead(); });
+    connect(m_socket, &QTcpSocket::bytesWritten, this, [=](qint64){ pump(); });
+    connect(m_socket, &QTcpSocket::disconnected, this, [=](){
+        if (m_started) {
+            qDebug() << "[Media]" << m_name << "served" << m_sent / 1024 << "KB from" << m_cachedSegments
+                     << "cached +" << m_fetched.size() << "fetched segments, first byte" << m_firstByteMs << "ms";
+        }
+        m_socket->deleteLater(); // 会话是 socket 的子对象，一起释放
+    });
+    connect(m_proxy, &MediaProxy::segmentReady, this, [=](const QString &key, int index){ onSegment(key, index, true); });
+    connect(m_proxy, &MediaProxy::segmentFailed, this, [=](const QString &key, int index){ onSegment(key, index, false); });
+}
+
+void ProxySession::fail(const char *status)
+{
+    m_socket->write(QByteArray("HTTP/1.1 ") + status + "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    m_socket->disconnectFromHost();
+}
+
+void ProxySession::onReadyRead()
+{
+    if (m_started) {
+        m_socket->readAll(); // 只处理一个请求，后面的丢弃
+        return;
+    }
+    m_request += m_socket->readAll();
+    int headerEnd = m_request.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (m_request.size() > MAX_HEADER_BYTES) fail("431 Request Header Fields Too Large");
+        return;
+    }
+    m_started = true;
+
+    // "GET /<key>/<文件名> HTTP/1.1"
+    QList<QByteArray> lines = m_request.left(headerEnd).split('\n');
+    QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() < 2 || (requestLine[0] != "GET" && requestLine[0] != "HEAD")) {
+        fail("405 Method Not Allowed");
+        return;
+    }
+    QList<QByteArray> parts = requestLine[1].split('/');
+    m_key = parts.size() > 1 ? QString::fromLatin1(parts[1]) : QString();
+    m_name = parts.size() > 2 ? QUrl::fromPercentEncoding(parts.last()) : m_key;
+    if (!m_proxy->knows(m_key)) {
+        fail("404 Not Found");
+        return;
+    }
+
+    for (int i = 1; i < lines.size(); ++i) {
+        QByteArray line = lines[i].trimmed();
+        if (!line.toLower().startsWith("range:")) continue;
+        // 只支持单个区间 "bytes=a-" / "bytes=a-b"
+        QByteArray spec = line.mid(6).trimmed();
+        if (!spec.startsWith("bytes=")) continue;
+        QList<QByteArray> range = spec.mid(6).split('-');
+        if (range.size() != 2 || range[0].isEmpty()) continue;
+        m_ranged = true;
+        m_pos = range[0].toLongLong();
+        m_end = range[1].isEmpty() ? -1 : range[1].toLongLong();
+    }
+    pump();
+}
+
+void ProxySession::sendHeader(qint64 total)
+{
+    if (m_end < 0 || m_end >= total) m_end = total - 1;
+    QByteArray header;
+    if (m_ranged) {
+        header = "HTTP/1.1 206 Partial Content\r\n";
+        header += "Content-Range: bytes " + QByteArray::number(m_pos) + '-' + QByteArray::number(m_end)
+                + '/' + QByteArray::number(total) + "\r\n";
+    } else {
+        header = "HTTP/1.1 200 OK\r\n";
+    }
+    header += "Content-Length: " + QByteArray::number(m_end - m_pos + 1) + "\r\n";
+    header += "Content-Type: video/mp4\r\nAccept-Ranges: bytes\r\nConnection: close\r\n\r\n";
+    m_socket->write(header);
+    m_headerSent = true;
+    if (m_request.startsWith("HEAD")) m_pos = m_end + 1;
+}
+
+void ProxySession::pump()
+{
+    if (!m_started || m_waiting >= 0 || m_socket->state() != QAbstractSocket::ConnectedState) return;
+    SegmentCache *cache = m_proxy->cache();
+
+    if (!m_headerSent) {
+        // 总长度要从第一次下载的 Content-Range 得到
+        qint64 total = cache->totalSize(m_key);
+        if (total < 0) {
+            m_waiting = (int)(m_pos / SEG);
+            m_proxy->fetch(m_key, m_waiting);
+            return;
+        }
+        if (m_pos >= total) {
+            fail("416 Range Not Satisfiable");
+            return;
+        }
+        sendHeader(total);
+    }
+
+    while (m_pos <= m_end && m_socket->bytesToWrite() < MAX_PENDING_WRITE) {
+        int index = (int)(m_pos / SEG);
+        if (!cache->contains(m_key, index)) {
+            m_waiting = index;
+            m_proxy->fetch(m_key, index);
+            break;
+        }
+        qint64 offset = m_pos % SEG;
+        QByteArray data = cache->read(m_key, index, offset, qMin(SEG - offset, m_end - m_pos + 1));
+        if (data.isEmpty()) {
+            // 段文件没了或不完整，read() 已把它移出索引，重新下载
+            m_waiting = index;
+            m_proxy->fetch(m_key, index);
+            break;
+        }
+        if (offset == 0 && !m_fetched.contains(index)) m_cachedSegments++;
+        if (m_firstByteMs < 0) m_firstByteMs = m_timer.elapsed();
+        m_socket->write(data);
+        m_pos += data.size();
+        m_sent += data.size();
+    }
+
+    // 预取播放位置前面的几段，已有或正在下的 fetch 会直接忽略
+    int count = cache->segmentCount(m_key);
+    int current = (int)(m_pos / SEG);
+    for (int i = 1; i <= MediaProxy::READ_AHEAD_SEGMENTS && current + i < count; ++i) {
+        if (!cache->contains(m_key, current + i)) m_proxy->fetch(m_key, current + i);
+    }
+
+    if (m_pos > m_end) m_socket->disconnectFromHost(); // 写完积压的数据后关闭
+}
+
+void ProxySession::onSegment(const QString &key, int index, bool ok)
+{
+    if (key != m_key || index != m_waiting) return;
+    m_waiting = -1;
+    if (!ok) {
+        // 源站不可用且缓存里没有，只能断开，播放器会报错退出
+        if (m_headerSent) m_socket->abort();
+        else fail("502 Bad Gateway");
+        return;
+    }
+    m_fetched.insert(index);
+    pump();
+}
+
+// --- 代理 ---
+MediaProxy* MediaProxy::m_instance = nullptr;
+
+MediaProxy* MediaProxy::instance()
+{
+    if (m_instance == nullptr) {
+        m_instance = new MediaProxy();
+    }
+    return m_instance;
+}
+
+MediaProxy::MediaProxy(QObject *parent) : QObject(parent), m_networkBytes(0)
+{
+    m_cache = new SegmentCache(MEDIA_CACHE_DIR, (qint64)MEDIA_CACHE_MB * 1024 * 1024);
+    m_net = new QNetworkAccessManager(this);
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &MediaProxy::onNewConnection);
+    // 只监听回环地址，端口由系统分配
+    if (!m_server->listen(QHostAddress::LocalHost, 0)) {
+        qDebug() << "MediaProxy: listen failed" << m_server->errorString();
+    }
+}
+
+bool MediaProxy::isRemote(const QString &path)
+{
+    return path.startsWith("http://") || path.startsWith("https://");
+}
+
+QString MediaProxy::localUrl(const QString &remoteUrl)
+{
+    QString key = SegmentCache::keyFor(remoteUrl);
+    m_remote.insert(key, remoteUrl);
+    // 带上原文件名，播放器靠扩展名猜格式；中文、空格等要先百分号编码
+    QString name = QFileInfo(QUrl(remoteUrl).path()).fileName();
+    return QString("http://127.0.0.1:%1/%2/%3").arg(m_server->serverPort()).arg(key)
+            .arg(QString::fromLatin1(QUrl::toPercentEncoding(name)));
+}
+
+void MediaProxy::prefetch(const QString &remoteUrl, int segments)
+{
+    QString key = SegmentCache::keyFor(remoteUrl);
+    m_remote.insert(key, remoteUrl);
+    for (int i = 0; i < segments; ++i) {
+        int count = m_cache->segmentCount(key);
+        if (count >= 0 && i >= count) break;
+        fetch(key, i);
+    }
+}
+
+void MediaProxy::fetch(const QString &key, int index)
+{
+    QString id = key + '/' + QString::number(index);
+    if (m_inflight.contains(id) || m_cache->contains(key, index)) return;
+    int count = m_cache->segmentCount(key);
+    if (count >= 0 && index >= count) return;
+    if (count < 0) {
+        if (m_probing.contains(key)) {
+            m_deferred[key].insert(index);
+            return;
+        }
+        m_probing.insert(key);
+    }
+
+    QNetworkRequest request(QUrl(m_remote.value(key)));
+    qint64 from = index * SEG;
+    request.setRawHeader("Range", "bytes=" + QByteArray::number(from) + '-' + QByteArray::number(from + SEG - 1));
+    QNetworkReply *reply = m_net->get(request);
+    reply->setProperty("key", key);
+    reply->setProperty("index", index);
+    m_inflight.insert(id);
+    connect(reply, &QNetworkReply::finished, this, &MediaProxy::onFetchFinished);
+}
+
+void MediaProxy::onFetchFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+    if (!reply) return;
+    reply->deleteLater();
+    QString key = reply->property("key").toString();
+    int index = reply->property("index").toInt();
+    m_inflight.remove(key + '/' + QString::number(index));
+    handleReply(reply, key, index);
+
+    // 探测请求回来了：总长度已知时其余的段并行发，仍未知 (失败) 时再挑一个继续探测
+    if (m_probing.remove(key)) {
+        QSet<int> later = m_deferred.take(key);
+        int count = m_cache->segmentCount(key);
+        for (int i : later) {
+            // 超出文件长度的段不会再有回复，直接告诉等它的会话
+            if (count >= 0 && i >= count) emit segmentFailed(key, i);
+            else fetch(key, i);
+        }
+    }
+}
+
+void MediaProxy::handleReply(QNetworkReply *reply, const QString &key, int index)
+{
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError || (status != 200 && status != 206)) {
+        qDebug() << "[Media] fetch failed" << reply->url().toString() << "segment" << index << status << reply->errorString();
+        emit segmentFailed(key, index);
+        return;
+    }
+
+    QByteArray body = reply->readAll();
+    m_networkBytes += body.size();
+    if (status == 206) {
+        // "Content-Range: bytes a-b/total"
+        QByteArray range = reply->rawHeader("Content-Range");
+        int slash = range.lastIndexOf('/');
+        int dash = range.indexOf('-');
+        qint64 from = (qint64)index * SEG;
+        qint64 first = dash > 6 ? range.mid(6, dash - 6).trimmed().toLongLong() : -1;
+        qint64 last = (dash > 0 && slash > dash) ? range.mid(dash + 1, slash - dash - 1).toLongLong() : -1;
+        qint64 total = (slash > 0 && range.mid(slash + 1) != "*") ? range.mid(slash + 1).toLongLong() : -1;
+        // 只接受正好是请求的那一段：不是最后一段就必须满 SEG 字节，且 body 和 Content-Range 一致。
+        // 存了残段的话后面读到段尾会读空，会话就一直等一个不会再来的下载
+        qint64 expected = total >= 0 ? qMin(SEG, total - from) : last - first + 1;
+        if (!range.startsWith("bytes ") || first != from || last != from + expected - 1
+                || expected <= 0 || expected > SEG || body.size() != expected) {
+            qDebug() << "[Media] bad 206 for segment" << index << range << "body" << body.size();
+            emit segmentFailed(key, index);
+            return;
+        }
+        if (total >= 0) m_cache->setTotalSize(key, total);
+        m_cache->store(key, index, body);
+        emit segmentReady(key, index);
+    } else {
+        // 源站不支持 Range，整个文件一次回来了：切成段全部存下
+        m_cache->setTotalSize(key, body.size());
+        for (int i = 0; (qint64)i * SEG < body.size(); ++i) {
+            m_cache->store(key, i, body.mid(i * SEG, SEG));
+        }
+        for (int i = 0; (qint64)i * SEG < body.size(); ++i) {
+            emit segmentReady(key, i);
+        }
+    }
+    qDebug() << "[Media] fetched segment" << index << "of" << reply->url().fileName() << body.size() / 1024 << "KB,"
+             << "network total" << m_networkBytes / 1024 << "KB, cache" << m_cache->usedBytes() / (1024 * 1024) << "MB";
+}
+
+void MediaProxy::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        new ProxySession(socket, this);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef MEDIAPROXY_H
+#define MEDIAPROXY_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+class QTcpServer;
+class QNetworkAccessManager;
+class QNetworkReply;
+class SegmentCache;
+
+// 网络视频本地代理
+// 播放器 (mplayer / libavformat) 只访问 http://127.0.0.1:<端口>/<key>/<文件名>，
+// 代理从 SegmentCache 取数据，缺的段用 Range 请求向源站补，并在播放位置前面预取几段。
+// 这样第一段到了就能开播，看过的片子再播完全不走网络，源站断了也能播缓存里的
+class MediaProxy : public QObject
+{
+    Q_OBJECT
+public:
+    static MediaProxy* instance();
+    static bool isRemote(const QString &path);
+
+    QString localUrl(const QString &remoteUrl);     // 给播放器用的地址
+    void prefetch(const QString &remoteUrl, int segments = 2); // 浏览列表时先拉开头几段
+
+    static const int READ_AHEAD_SEGMENTS = 4;       // 播放时领先客户端的段数
+
+    // 以下供代理会话使用
+    SegmentCache *cache() const { return m_cache; }
+    bool knows(const QString &key) const { return m_remote.contains(key); }
+    void fetch(const QString &key, int index);
+
+signals:
+    void segmentReady(const QString &key, int index);
+    void segmentFailed(const QString &key, int index);
+
+private slots:
+    void onNewConnection();
+    void onFetchFinished();
+
+private:
+    explicit MediaProxy(QObject *parent = nullptr);
+    static MediaProxy* m_instance;
+
+    void handleReply(QNetworkReply *reply, const QString &key, int index);  // 存段并发 segmentReady / segmentFailed
+
+    QTcpServer *m_server;
+    QNetworkAccessManager *m_net;
+    SegmentCache *m_cache;
+    QHash<QString, QString> m_remote;   // key -> 源站 URL
+    QSet<QString> m_inflight;           // "<key>/<段号>" 正在下载
+    // 总长度未知时每个 key 只发一个请求：源站不支持 Range 时每个请求都会回整个文件。
+    // 第一个回复定下总长度前，其余的段记在 m_deferred 里，回复到了再发
+    QSet<QString> m_probing;            // 总长度未知、已有请求在路上的 key
+    QHash<QString, QSet<int> > m_deferred;
+    qint64 m_networkBytes;              // 启动以来从源站下载的字节数
+};
+
+#endif // MEDIAPROXY_H
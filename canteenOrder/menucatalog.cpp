@@ -0,0 +1,152 @@
+#include "menucatalog.h"
+#include <QHash>
+#include <QMutex>
+
+// === 分类 (顺序即左侧列表顺序) ===
+static const struct {
+    const char *name;
+    const char *icon;
+} CATEGORIES[] = {
+    { "热销榜",   ":/res/hot.png" },
+    { "优惠套餐", ":/res/preferential.png" },
+    { "精品寿司", ":/res/sushi.png" },
+    { "日式拉面", ":/res/romen.png" },
+    { "手作饭团", ":/res/rice.png" },
+    { "新鲜刺身", ":/res/cishen.png" },
+    { "特色饮品", ":/res/drink_logo.png" }
+};
+
+// === 菜品 { 分类, 菜名, 价格, 图片 } ===
+static const struct {
+    const char *category;
+    const char *name;
+    const char *price;
+    const char *image;
+} DISHES[] = {
+    { "热销榜", "蛋丝三文鱼包饭", "49", ":/res/sushi1.png" },
+    { "热销榜", "招牌鳗鱼饭", "58", ":/res/sushi2.png" },
+    { "热销榜", "加州卷(4粒)", "22", ":/res/sushi3.png" },
+    { "热销榜", "铁火卷", "667", ":/res/sushi5.png" },
+    { "热销榜", "卷寿司", "345", ":/res/sushi6.png" },
+    { "热销榜", "豪华刺身拼盘", "128", ":/res/sashimi1.png" },
+    { "热销榜", "火腿海苔饭团", "057", ":/res/rice2.png" },
+    { "热销榜", "饭团拼盘", "282", ":/res/rice3.png" },
+    { "优惠套餐", "稻荷寿司", "257", ":/res/sushi8.png" },
+    { "优惠套餐", "茶巾寿司", "267", ":/res/sushi9.png" },
+    { "优惠套餐", "经典日式豚骨拉面", "672", ":/res/romen1.png" },
+    { "优惠套餐", "经典刺身", "355", ":/res/sashimi1.png" },
+    { "优惠套餐", "刺身大拼盘", "456", ":/res/sashimi2.png" },
+    { "优惠套餐", "新鲜三文鱼刺身", "980", ":/res/sashimi3.png" },
+    { "精品寿司", "握寿司", "232", ":/res/sushi1.png" },
+    { "精品寿司", "加州卷(4粒)", "244", ":/res/sushi2.png" },
+    { "精品寿司", "军舰卷", "654", ":/res/sushi3.png" },
+    { "精品寿司", "散寿司", "436", ":/res/sushi4.png" },
+    { "精品寿司", "铁火卷", "667", ":/res/sushi5.png" },
+    { "精品寿司", "卷寿司", "345", ":/res/sushi6.png" },
+    { "精品寿司", "太卷", "279", ":/res/sushi7.png" },
+    { "精品寿司", "稻荷寿司", "257", ":/res/sushi8.png" },
+    { "精品寿司", "茶巾寿司", "267", ":/res/sushi9.png" },
+    { "精品寿司", "押寿司", "837", ":/res/sushi10.png" },
+    { "精品寿司", "手卷", "282", ":/res/sushi11.png" },
+    { "精品寿司", "奶油三文鱼寿司", "134", ":/res/sushi12.png" },
+    { "日式拉面", "经典日式豚骨拉面", "672", ":/res/romen1.png" },
+    { "日式拉面", "日式牛肉拉面", "365", ":/res/romen2.png" },
+    { "日式拉面", "日式清汤拉面", "568", ":/res/romen3.png" },
+    { "手作饭团", "豆芽饭团", "353", ":/res/rice1.png" },
+    { "手作饭团", "火腿海苔饭团", "057", ":/res/rice2.png" },
+    { "手作饭团", "饭团拼盘", "282", ":/res/rice3.png" },
+    { "新鲜刺身", "经典刺身", "355", ":/res/sashimi1.png" },
+    { "新鲜刺身", "刺身大拼盘", "456", ":/res/sashimi2.png" },
+    { "新鲜刺身", "新鲜三文鱼刺身", "980", ":/res/sashimi3.png" },
+    { "特色饮品", "经典可乐", "273", ":/res/drink.png" },
+    { "特色饮品", "日本清酒", "183", ":/res/drink2.png" },
+    { "特色饮品", "鲜榨葡萄汁", "641", ":/res/drink3.png" },
+};
+
+QString MenuCatalog::hotCategory()
+{
+    return QString::fromUtf8(CATEGORIES[0].name);
+}
+
+QStringList MenuCatalog::categories()
+{
+    QStringList list;
+    for (const auto &c : CATEGORIES) list << QString::fromUtf8(c.name);
+    return list;
+}
+
+QString MenuCatalog::categoryIcon(const QString &category)
+{
+    for (const auto &c : CATEGORIES) {
+        if (category == QString::fromUtf8(c.name)) return QString::fromLatin1(c.icon);
+    }
+    return QString();
+}
+
+const QList<DishInfo> &MenuCatalog::allDishes()
+{
+    static const QList<DishInfo> dishes = []() {
+        QList<DishInfo> list;
+        for (const auto &d : DISHES) {
+            DishInfo info;
+            info.category = QString::fromUtf8(d.category);
+            info.name = QString::fromUtf8(d.name);
+            info.price = QString::fromLatin1(d.price);
+            info.image = QString::fromLatin1(d.image);
+            list.append(info);
+        }
+        return list;
+    }();
+    return dishes;
+}
+
+QList<DishInfo> MenuCatalog::dishesIn(const QString &category)
+{
+    QList<DishInfo> list;
+    for (const DishInfo &d : allDishes()) {
+        if (d.category == category) list.append(d);
+    }
+    return list;
+}
+
+const DishInfo *MenuCatalog::find(const QString &name)
+{
+    static const QHash<QString, int> index = []() {
+        QHash<QString, int> h;
+        const QList<DishInfo> &dishes = allDishes();
+        for (int i = 0; i < dishes.size(); ++i) {
+            if (!h.contains(dishes.at(i).name)) h.insert(dishes.at(i).name, i);
+        }
+        return h;
+    }();
+    QHash<QString, int>::const_iterator it = index.constFind(name);
+    return it == index.constEnd() ? nullptr : &allDishes().at(it.value());
+}
+
+static QMutex g_thumbMutex;
+static QHash<QString, QImage> g_thumbs;
+
+QImage MenuCatalog::thumbnail(const QString &imagePath)
+{
+    {
+        QMutexLocker locker(&g_thumbMutex);
+        QHash<QString, QImage>::const_iterator it = g_thumbs.constFind(imagePath);
+        if (it != g_thumbs.constEnd()) return it.value();
+    }
+
+    // 解码和缩放不持锁，两个线程同时做同一张图也只是多算一次
+    QImage image(imagePath);
+    if (!image.isNull()) {
+        image = image.scaled(THUMB_SIZE, THUMB_SIZE, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    }
+    QMutexLocker locker(&g_thumbMutex);
+    g_thumbs.insert(imagePath, image);
+    return image;
+}
+
+void MenuCatalog::warmThumbnails()
+{
+    for (const DishInfo &d : allDishes()) {
+        if (!d.image.isEmpty()) thumbnail(d.image);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef MENUCATALOG_H
+#define MENUCATALOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QImage>
+
+// 菜品信息
+struct DishInfo {
+    QString category;
+    QString name;
+    QString price;   // 界面上原样显示的价格字符串
+    QString image;
+};
+
+// 菜单目录：分类和菜品的静态数据，点餐页和统计模块共用
+class MenuCatalog
+{
+public:
+    // "热销榜" 是动态分类，目录里的这一组只作为销量数据不足时的默认推荐
+    static QString hotCategory();
+
+    static QStringList categories();
+    static QString categoryIcon(const QString &category);
+    static QList<DishInfo> dishesIn(const QString &category);
+    static const QList<DishInfo> &allDishes();
+
+    // 按菜名查找，同名菜品以表中第一次出现的为准，找不到返回 nullptr
+    static const DishInfo *find(const QString &name);
+
+    // 菜品缩略图：解码并缩放到 THUMB_SIZE 后缓存，任何线程都可以调用；图片缺失返回空图
+    static QImage thumbnail(const QString &imagePath);
+    // 启动时在后台线程里把所有菜品缩略图先做好
+    static void warmThumbnails();
+
+    static const int THUMB_SIZE = 80;
+};
+
+#endif // MENUCATALOG_H
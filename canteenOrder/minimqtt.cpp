@@ -7,19 +7,62 @@ MiniMqtt::MiniMqtt(QObject *parent) : QObject(parent)
     m_socket = new QTcpSocket(this);
     connect(m_socket, &QTcpSocket::connected, this, &MiniMqtt::onSocketConnected);
     connect(m_socket, &QTcpSocket::readyRead, this, &MiniMqtt::onSocketReadyRead);
-    connect(m_socket, &QTcpSocket::disconnected, this, &MiniMqtt::disconnected);
+    connect(m_socket, &QTcpSocket::bytesWritten, this, &MiniMqtt::onBytesWritten);
+    connect(m_socket, &QTcpSocket::disconnected, this, &MiniMqtt::onSocketDisconnected);
+    connect(m_socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(onSocketError(QAbstractSocket::SocketError)));
+
+    m_reconnectTimer = new QTimer(this);
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, SIGNAL(timeout()), this, SLOT(reconnect()));
+    m_reconnectDelay = MQTT_RECONNECT_MIN_MS;
+    m_port = 0;
+
+    // 没有别的报文时靠 PINGREQ 保活，否则服务器 1.5 倍保活时间后会断开空闲连接
+    m_pingTimer = new QTimer(this);
+    m_pingTimer->setInterval(MQTT_KEEPALIVE_S * 1000 / 2);
+    connect(m_pingTimer, SIGNAL(timeout()), this, SLOT(onPingTimer()));
+    m_pingPending = false;
+
+    m_sessionUp = false;
+    m_queuedBytes = 0;
+    m_writtenBytes = 0;
+    m_nextId = 0;
 
     qsrand(QTime::currentTime().msec());
 }
 
 void MiniMqtt::connectToHost(const QString &host, quint16 port)
 {
+    m_host = host;
+    m_port = port;
+    m_reconnectTimer->stop();
     if(m_socket->state() == QAbstractSocket::ConnectedState) {
         m_socket->disconnectFromHost();
     }
     m_socket->connectToHost(host, port);
 }
 
+void MiniMqtt::onSocketError(QAbstractSocket::SocketError error)
+{
+    qDebug() << "[MQTT] Socket error:" << error << m_socket->errorString();
+    // 连接失败 (没有 disconnected 信号) 也要重连；已连上后的断开由 onSocketDisconnected 处理
+    if (m_socket->state() == QAbstractSocket::UnconnectedState) scheduleReconnect();
+}
+
+void MiniMqtt::scheduleReconnect()
+{
+    if (m_host.isEmpty() || m_reconnectTimer->isActive()) return;
+    qDebug() << "[MQTT] Reconnect in" << m_reconnectDelay << "ms";
+    m_reconnectTimer->start(m_reconnectDelay);
+    m_reconnectDelay = qMin(m_reconnectDelay * 2, MQTT_RECONNECT_MAX_MS);
+}
+
+void MiniMqtt::reconnect()
+{
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) return;
+    m_socket->connectToHost(m_host, m_port);
+}
+
 void MiniMqtt::onSocketConnected()
 {
     // 构建 MQTT CONNECT 报文 (协议版本 3.1.1)
@@ -28,7 +71,7 @@ void MiniMqtt::onSocketConnected()
     variableHeader.append("MQTT");      // 协议名
     variableHeader.append((char)0x04);  // 协议级别 (3.1.1)
     variableHeader.append((char)0x02);  // 连接标志 (Clean Session)
-    variableHeader.append((char)0x00); variableHeader.append((char)0x3C); // Keep Alive (60秒)
+    variableHeader.append((char)(MQTT_KEEPALIVE_S >> 8)); variableHeader.append((char)(MQTT_KEEPALIVE_S & 0xFF)); // Keep Alive (秒)
 
     QString clientId = "GEC6818_" + QString::number(qrand() % 10000);
     QByteArray payload = encodeString(clientId); // Client ID
@@ -37,27 +80,139 @@ void MiniMqtt::onSocketConnected()
     fixedHeader.append((char)0x10); // 报文类型: CONNECT
     fixedHeader.append(encodeRemainingLength(variableHeader.size() + payload.size()));
 
-    m_socket->write(fixedHeader + variableHeader + payload);
+    // 新连接的写出流从 0 开始计
+    m_queuedBytes = 0;
+    m_writtenBytes = 0;
+    sendPacket(fixedHeader + variableHeader + payload);
 }
 
-void MiniMqtt::publish(const QString &topic, const QString &message)
+void MiniMqtt::publish(const QString &topic, const QString &message, int qos, const PublishCallback &done)
 {
-    if (m_socket->state() != QAbstractSocket::ConnectedState) {
-        qDebug() << "[MQTT Error] Cannot publish, socket not connected.";
-        return;
-    }
+    if (++m_nextId == 0) m_nextId = 1;  // 报文标识符不能为 0
 
-    // 构建 PUBLISH 报文 (QoS 0)
+    // 构建 PUBLISH 报文，QoS 1 时 Topic 后面带 2 字节报文标识符
     QByteArray topicBytes = encodeString(topic);
     QByteArray msgBytes = message.toUtf8();
+    QByteArray idBytes;
+    if (qos > 0) {
+        idBytes.append((char)(m_nextId >> 8));
+        idBytes.append((char)(m_nextId & 0xFF));
+    }
 
     QByteArray fixedHeader;
-    fixedHeader.append((char)0x30); // 报文类型: PUBLISH
-    fixedHeader.append(encodeRemainingLength(topicBytes.size() + msgBytes.size()));
+    fixedHeader.append((char)(qos > 0 ? 0x32 : 0x30)); // 报文类型: PUBLISH
+    fixedHeader.append(encodeRemainingLength(topicBytes.size() + idBytes.size() + msgBytes.size()));
+
+    Pending pending;
+    pending.id = m_nextId;
+    pending.qos = qos > 0 ? 1 : 0;
+    pending.packet = fixedHeader + topicBytes + idBytes + msgBytes;
+    pending.endOffset = 0;
+    pending.sent = false;
+    pending.done = done;
+
+    if (m_sessionUp) {
+        sendPending(pending);
+    } else {
+        qDebug() << "[MQTT] Not connected yet, queue publish to" << topic;
+        m_outbox.append(pending);
+    }
+    qDebug() << "[MQTT] Publish to" << topic << "(Size:" << msgBytes.size() << ", QoS" << pending.qos << ")";
+
+    // 只有 QoS 0 会超时；QoS 1 一直保留到 PUBACK (见头文件说明)
+    if (pending.qos == 0) {
+        quint16 id = pending.id;
+        QTimer::singleShot(MQTT_PUBLISH_TIMEOUT_MS, this, [=](){ finishPublish(id, false); });
+    }
+}
+
+void MiniMqtt::sendPending(Pending &pending)
+{
+    if (pending.sent && pending.qos > 0) pending.packet[0] = pending.packet[0] | 0x08; // DUP
+    pending.sent = true;
+    pending.endOffset = m_queuedBytes + pending.packet.size();
+    // 先登记再写：bytesWritten 可能在 write 里面就同步发出来
+    m_inflight.append(pending);
+    sendPacket(pending.packet);
+}
+
+void MiniMqtt::sendPacket(const QByteArray &packet)
+{
+    m_queuedBytes += packet.size();
+    m_socket->write(packet);
+}
+
+void MiniMqtt::onBytesWritten(qint64 bytes)
+{
+    m_writtenBytes += bytes;
+
+    // QoS 0 的报文整个写出去就算完成
+    QList<quint16> done;
+    foreach (const Pending &p, m_inflight) {
+        if (p.qos == 0 && p.endOffset <= m_writtenBytes) done.append(p.id);
+    }
+    foreach (quint16 id, done) finishPublish(id, true);
+}
 
-    m_socket->write(fixedHeader + topicBytes + msgBytes);
-    m_socket->flush();
-    qDebug() << "[MQTT] Published to" << topic << "(Size:" << msgBytes.size() << ")";
+void MiniMqtt::finishPublish(quint16 id, bool ok)
+{
+    // 回调里可能再次 publish，先从队列里拿出来再调用
+    PublishCallback done;
+    bool found = false;
+    for (int i = 0; i < m_inflight.size() && !found; ++i) {
+        if (m_inflight[i].id == id) {
+            done = m_inflight.takeAt(i).done;
+            found = true;
+        }
+    }
+    for (int i = 0; i < m_outbox.size() && !found; ++i) {
+        if (m_outbox[i].id == id) {
+            done = m_outbox.takeAt(i).done;
+            found = true;
+        }
+    }
+    if (!found) return;     // 已经完成 (超时定时器晚到)
+
+    if (!ok) qDebug() << "[MQTT Error] Publish" << id << "failed (timeout or disconnected)";
+    if (done) done(ok);
+}
+
+void MiniMqtt::onPingTimer()
+{
+    // 上一个 PINGREQ 半个保活周期都没有回应，连接多半已经断了 (拔网线时 TCP 自己察觉不到)，
+    // 主动断开走重连，没确认的 QoS 1 报文随之重发
+    if (m_pingPending) {
+        qDebug() << "[MQTT Error] No PINGRESP, dropping connection";
+        m_socket->abort();
+        return;
+    }
+    QByteArray packet;
+    packet.append((char)0xC0); // 报文类型: PINGREQ
+    packet.append((char)0x00);
+    m_pingPending = true;
+    sendPacket(packet);
+}
+
+void MiniMqtt::onSocketDisconnected()
+{
+    m_buffer.clear();
+    m_sessionUp = false;
+    m_pingTimer->stop();
+    m_pingPending = false;
+
+    // QoS 1 还没收到 PUBACK 的放回待发队列，重连后带 DUP 重发；QoS 0 没写完的直接失败
+    QList<quint16> failed;
+    for (int i = m_inflight.size() - 1; i >= 0; --i) {
+        if (m_inflight[i].qos > 0) {
+            m_outbox.prepend(m_inflight.takeAt(i));
+        } else {
+            failed.append(m_inflight[i].id);
+        }
+    }
+    foreach (quint16 id, failed) finishPublish(id, false);
+
+    scheduleReconnect();
+    emit disconnected();
 }
 
 void MiniMqtt::subscribe(const QString &topic)
@@ -75,39 +230,85 @@ void MiniMqtt::subscribe(const QString &topic)
     fixedHeader.append((char)0x82); // 报文类型: SUBSCRIBE
     fixedHeader.append(encodeRemainingLength(variableHeader.size() + payload.size()));
 
-    m_socket->write(fixedHeader + variableHeader + payload);
+    sendPacket(fixedHeader + variableHeader + payload);
     qDebug() << "[MQTT] Subscribed to" << topic;
 }
 
 void MiniMqtt::onSocketReadyRead()
 {
-    QByteArray data = m_socket->readAll();
+    // TCP 是字节流：一次 readyRead 可能包含半个或多个报文，先拼进缓冲区再逐个拆包
+    m_buffer.append(m_socket->readAll());
+
+    while (m_buffer.size() >= 2) {
+        // 剩余长度为变长编码，最多 4 字节
+        int remainingLength = 0;
+        int multiplier = 1;
+        int pos = 1;
+        bool complete = false;
+        while (pos < m_buffer.size() && pos <= 4) {
+            unsigned char digit = (unsigned char)m_buffer[pos++];
+            remainingLength += (digit & 0x7F) * multiplier;
+            multiplier *= 128;
+            if ((digit & 0x80) == 0) {
+                complete = true;
+                break;
+            }
+        }
+        if (!complete) {
+            if (pos > 4) {
+                qDebug() << "[MQTT Error] Malformed remaining length, dropping buffer.";
+                m_buffer.clear();
+            }
+            return;
+        }
+        if (m_buffer.size() < pos + remainingLength) return; // 报文还没收全
 
-    // 简单的报文解析 (仅处理 CONNACK 和 PUBLISH)
-    if (data.size() < 2) return;
+        handlePacket((unsigned char)m_buffer[0], m_buffer.mid(pos, remainingLength));
+        m_buffer.remove(0, pos + remainingLength);
+    }
+}
 
-    unsigned char type = (unsigned char)data[0] & 0xF0;
+void MiniMqtt::handlePacket(unsigned char header, const QByteArray &body)
+{
+    unsigned char type = header & 0xF0;
 
     if (type == 0x20) { // CONNACK
-        if ((unsigned char)data[3] == 0x00) {
+        if (body.size() >= 2 && (unsigned char)body[1] == 0x00) {
             qDebug() << "[MQTT] Connected Successfully!";
+            m_sessionUp = true;
+            m_reconnectDelay = MQTT_RECONNECT_MIN_MS;
+            m_pingPending = false;
+            m_pingTimer->start();
+
+            // 连上之前排队的发布 (包括断线前没确认的 QoS 1) 现在发出
+            QList<Pending> outbox = m_outbox;
+            m_outbox.clear();
+            for (int i = 0; i < outbox.size(); ++i) sendPending(outbox[i]);
+
             emit connected();
         }
     }
+    else if (type == 0xD0) { // PINGRESP
+        m_pingPending = false;
+    }
+    else if (type == 0x40) { // PUBACK
+        if (body.size() < 2) return;
+        quint16 id = (unsigned char)body[0] * 256 + (unsigned char)body[1];
+        finishPublish(id, true);
+    }
     else if (type == 0x30) { // PUBLISH
-        int remainingLength = (unsigned char)data[1];
-        int varHeaderIndex = 2;
-        if(remainingLength > 127) {
-            return;
-        }
+        if (body.size() < 2) return;
 
         // 解析 Topic
-        int topicLen = (unsigned char)data[varHeaderIndex] * 256 + (unsigned char)data[varHeaderIndex+1];
-        QString topic = QString::fromUtf8(data.mid(varHeaderIndex + 2, topicLen));
+        int topicLen = (unsigned char)body[0] * 256 + (unsigned char)body[1];
+        QString topic = QString::fromUtf8(body.mid(2, topicLen));
+
+        // QoS > 0 时 Topic 后面还有 2 字节报文标识符
+        int payloadIndex = 2 + topicLen;
+        if (header & 0x06) payloadIndex += 2;
 
         // 解析 Payload
-        QByteArray payload = data.mid(varHeaderIndex + 2 + topicLen);
-        QString message = QString::fromUtf8(payload);
+        QString message = QString::fromUtf8(body.mid(payloadIndex));
 
         emit received(topic, message);
         qDebug() << "[MQTT] Received:" << topic << message;
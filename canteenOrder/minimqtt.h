@@ -4,6 +4,13 @@
 #include <QObject>
 #include <QTcpSocket>
 #include <QTimer>
+#include <QList>
+#include <functional>
+
+#define MQTT_PUBLISH_TIMEOUT_MS 5000    // QoS 0 发布超过这个时间还没写出去就回调失败
+#define MQTT_RECONNECT_MIN_MS   1000    // 断线重连间隔，每失败一次翻倍
+#define MQTT_RECONNECT_MAX_MS   30000
+#define MQTT_KEEPALIVE_S        60      // CONNECT 里声明的保活时间，每半个周期发一次 PINGREQ
 
 class MiniMqtt : public QObject
 {
@@ -11,10 +18,21 @@ class MiniMqtt : public QObject
 public:
     explicit MiniMqtt(QObject *parent = nullptr);
 
-    // 连接到服务器
+    // 连接到服务器，之后断线或连不上会自动重连
     void connectToHost(const QString &host, quint16 port);
-    // 发布消息
-    void publish(const QString &topic, const QString &message);
+    bool isConnected() const { return m_sessionUp; }
+    // 发布完成回调：ok 为 false 表示超时或连接断开 (只有 QoS 0 会失败)
+    typedef std::function<void(bool ok)> PublishCallback;
+
+    // 发布消息，立即返回，完成后调用 done：
+    //   QoS 0：报文全部写进内核 (bytesWritten) 算完成，MQTT_PUBLISH_TIMEOUT_MS 内没写出去或断线就失败
+    //   QoS 1：收到服务器的 PUBACK 才算完成，不会超时失败；断线重连后带 DUP 标志重发，直到收到 PUBACK。
+    //          只保证至少一次：连接用 Clean Session，服务器不保留上一个会话，重连后的重发对它来说就是新消息，
+    //          订阅方可能收到两次。需要去重的消息自己带业务 ID (订单带 order_no，后厨按它去重)
+    // 还没连上 (CONNACK 之前) 先排队，连上后依次发出
+    void publish(const QString &topic, const QString &message, int qos = 0,
+                 const PublishCallback &done = PublishCallback());
+    int pendingPublishes() const { return m_outbox.size() + m_inflight.size(); }
     // 订阅主题
     void subscribe(const QString &topic);
 
@@ -26,9 +44,42 @@ signals:
 private slots:
     void onSocketConnected();
     void onSocketReadyRead();
+    void onBytesWritten(qint64 bytes);
+    void onSocketDisconnected();
+    void onSocketError(QAbstractSocket::SocketError error);
+    void reconnect();
+    void onPingTimer();
 
 private:
+    struct Pending {
+        quint16 id;             // QoS 1 时就是报文标识符
+        int qos;
+        QByteArray packet;
+        qint64 endOffset;       // 本报文最后一个字节在本次连接写出流中的位置
+        bool sent;              // 发过一次，重发时置 DUP
+        PublishCallback done;
+    };
+
     QTcpSocket *m_socket;
+    QByteArray m_buffer; // 接收缓冲 (未拼完整的报文)
+    QString m_host;
+    quint16 m_port;
+    QTimer *m_reconnectTimer;
+    QTimer *m_pingTimer;
+    bool m_pingPending;         // PINGREQ 已发，还没收到 PINGRESP
+    int m_reconnectDelay;
+    bool m_sessionUp;           // 收到 CONNACK 之后才能发 PUBLISH
+    qint64 m_queuedBytes;       // 本次连接交给 socket 的字节数
+    qint64 m_writtenBytes;      // 其中已经写进内核的字节数
+    quint16 m_nextId;
+    QList<Pending> m_outbox;    // 等连接
+    QList<Pending> m_inflight;  // 已写出，等 bytesWritten (QoS 0) 或 PUBACK (QoS 1)
+
+    void handlePacket(unsigned char header, const QByteArray &body);
+    void sendPacket(const QByteArray &packet);
+    void sendPending(Pending &pending);
+    void finishPublish(quint16 id, bool ok);
+    void scheduleReconnect();
     QByteArray encodeRemainingLength(int len);
     QByteArray encodeString(const QString &str);
 };
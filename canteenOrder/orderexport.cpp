@@ -0,0 +1,324 @@
+#include "orderexport.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QHash>
+#include <QVector>
+#include <QThread>
+#include <QtEndian>
+#include <QDebug>
+
+static const char FILE_MAGIC[4] = { 'C', 'C', 'O', 'L' };
+static const quint16 FILE_VERSION = 1;
+static const int COLUMN_COUNT = 5;
+
+// === 编码工具 ===
+static void putVarint(QByteArray &out, quint64 v)
+{
+    while (v >= 0x80) {
+        out.append((char)((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.append((char)v);
+}
+
+static bool getVarint(const char *&p, const char *end, quint64 *v)
+{
+    quint64 result = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        unsigned char byte = (unsigned char)*p++;
+        result |= (quint64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static quint64 zigzag(qint64 v) { return ((quint64)v << 1) ^ (quint64)(v >> 63); }
+static qint64 unzigzag(quint64 v) { return (qint64)(v >> 1) ^ -(qint64)(v & 1); }
+
+template <typename T>
+static void putFixed(QByteArray &out, T v)
+{
+    uchar buf[sizeof(T)];
+    qToLittleEndian(v, buf);
+    out.append((const char *)buf, sizeof(T));
+}
+
+template <typename T>
+static T getFixed(const char *p)
+{
+    return qFromLittleEndian<T>((const uchar *)p);
+}
+
+// === 导出 ===
+// 一个数据块的列缓冲
+struct ColumnBlock {
+    QByteArray cols[COLUMN_COUNT];
+    quint32 rows = 0;
+    qint64 lastOrderId = 0;
+    qint64 lastTs = 0;
+
+    void clear() {
+        for (QByteArray &c : cols) c.clear();
+        rows = 0;
+        lastOrderId = 0;
+        lastTs = 0;
+    }
+};
+
+static bool flushBlock(QSaveFile &file, ColumnBlock &block, QVector<QPair<quint64, quint32> > &index)
+{
+    if (block.rows == 0) return true;
+
+    QByteArray out;
+    putFixed<quint32>(out, block.rows);
+    for (const QByteArray &c : block.cols) {
+        putFixed<quint32>(out, (quint32)c.size());
+        out.append(c);
+    }
+    index.append(qMakePair((quint64)file.pos(), block.rows));
+    block.clear();
+    return file.write(out) == out.size();
+}
+
+bool OrderExporter::exportDay(const QString &dbPath, const QDate &date, const QString &outPath)
+{
+    // 每个线程要用自己的连接
+    const QString connName = QString("export_%1").arg((quintptr)QThread::currentThreadId());
+    bool ok = false;
+    quint32 totalRows = 0;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connName);
+        db.setDatabaseName(dbPath);
+        if (!db.open()) {
+            qDebug() << "Export: open failed" << db.lastError();
+        } else {
+            QSqlQuery query(db);
+            query.setForwardOnly(true); // 只向前遍历，QSQLITE 不缓存已读过的行
+            query.prepare("SELECT o.id, o.created_at, i.dish, i.qty, i.unit_cents "
+                          "FROM orders o JOIN order_items i ON i.order_id = o.id "
+                          "WHERE o.created_at >= :from AND o.created_at < :to "
+                          "ORDER BY o.id, i.id");
+            query.bindValue(":from", QDateTime(date).toMSecsSinceEpoch());
+            query.bindValue(":to", QDateTime(date.addDays(1)).toMSecsSinceEpoch());
+
+            QSaveFile file(outPath);
+            if (!query.exec()) {
+                qDebug() << "Export: query failed" << query.lastError();
+            } else if (!file.open(QIODevice::WriteOnly)) {
+                qDebug() << "Export: cannot write" << outPath;
+            } else {
+                QByteArray header(FILE_MAGIC, 4);
+                putFixed<quint16>(header, FILE_VERSION);
+                ok = file.write(header) == header.size();
+
+                QHash<QString, quint32> dictIndex;
+                QStringList dict;
+                QVector<QPair<quint64, quint32> > blockIndex;
+                ColumnBlock block;
+
+                while (ok && query.next()) {
+                    qint64 orderId = query.value(0).toLongLong();
+                    qint64 ts = query.value(1).toLongLong();
+                    QString dish = query.value(2).toString();
+
+                    QHash<QString, quint32>::const_iterator it = dictIndex.constFind(dish);
+                    quint32 dishId;
+                    if (it == dictIndex.constEnd()) {
+                        dishId = (quint32)dict.size();
+                        dictIndex.insert(dish, dishId);
+                        dict.append(dish);
+                    } else {
+                        dishId = it.value();
+                    }
+
+                    putVarint(block.cols[0], zigzag(orderId - block.lastOrderId));
+                    putVarint(block.cols[1], zigzag(ts - block.lastTs));
+                    putVarint(block.cols[2], dishId);
+                    putVarint(block.cols[3], (quint64)qMax(0, query.value(3).toInt()));
+                    putVarint(block.cols[4], (quint64)qMax<qint64>(0, query.value(4).toLongLong()));
+                    block.lastOrderId = orderId;
+                    block.lastTs = ts;
+                    ++totalRows;
+
+                    if (++block.rows >= (quint32)BLOCK_ROWS) {
+                        ok = flushBlock(file, block, blockIndex);
+                    }
+                }
+                if (ok) ok = flushBlock(file, block, blockIndex);
+
+                if (ok) {
+                    QByteArray footer;
+                    quint64 footerOffset = (quint64)file.pos();
+                    putFixed<quint32>(footer, (quint32)dict.size());
+                    for (const QString &name : dict) {
+                        QByteArray utf8 = name.toUtf8().left(0xFFFF);
+                        putFixed<quint16>(footer, (quint16)utf8.size());
+                        footer.append(utf8);
+                    }
+                    putFixed<quint32>(footer, (quint32)blockIndex.size());
+                    for (const QPair<quint64, quint32> &b : blockIndex) {
+                        putFixed<quint64>(footer, b.first);
+                        putFixed<quint32>(footer, b.second);
+                    }
+                    putFixed<quint64>(footer, footerOffset);
+                    footer.append(FILE_MAGIC, 4);
+                    ok = file.write(footer) == footer.size() && file.commit();
+                }
+            }
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connName);
+
+    qDebug() << "Export" << date.toString("yyyy-MM-dd") << (ok ? "OK:" : "FAILED:") << totalRows << "lines ->" << outPath;
+    return ok;
+}
+
+QString OrderExporter::fileNameFor(const QDate &date)
+{
+    return QString("orders-%1.ccol").arg(date.toString("yyyyMMdd"));
+}
+
+int OrderExporter::exportMissingDays(const QString &dbPath, const QString &outDir, int lookbackDays)
+{
+    QDir().mkpath(outDir);
+    int exported = 0;
+    QDate today = QDate::currentDate();
+    for (int i = 1; i <= lookbackDays; ++i) {
+        QDate day = today.addDays(-i);
+        QString path = QDir(outDir).filePath(fileNameFor(day));
+        if (QFileInfo::exists(path)) continue;
+        if (exportDay(dbPath, day, path)) ++exported;
+    }
+    return exported;
+}
+
+// === 读取 ===
+bool OrderReportReader::read(const QString &path, Report *report)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < 6 + 12) {
+        qDebug() << "Report: cannot open" << path;
+        return false;
+    }
+
+    // 1. 校验头尾，找到尾部
+    QByteArray header = file.read(6);
+    if (!header.startsWith(QByteArray(FILE_MAGIC, 4)) || getFixed<quint16>(header.constData() + 4) != FILE_VERSION) {
+        qDebug() << "Report: bad header" << path;
+        return false;
+    }
+    file.seek(file.size() - 12);
+    QByteArray trailer = file.read(12);
+    if (!trailer.endsWith(QByteArray(FILE_MAGIC, 4))) {
+        qDebug() << "Report: bad trailer" << path;
+        return false;
+    }
+    quint64 footerOffset = getFixed<quint64>(trailer.constData());
+    if (footerOffset < 6 || footerOffset > (quint64)file.size() - 12) return false;
+
+    // 2. 读字典和块索引
+    file.seek((qint64)footerOffset);
+    QByteArray footer = file.read(file.size() - 12 - (qint64)footerOffset);
+    const char *p = footer.constData();
+    const char *end = p + footer.size();
+
+    if (end - p < 4) return false;
+    quint32 dictSize = getFixed<quint32>(p);
+    p += 4;
+    QStringList dict;
+    for (quint32 i = 0; i < dictSize; ++i) {
+        if (end - p < 2) return false;
+        quint16 len = getFixed<quint16>(p);
+        p += 2;
+        if (end - p < len) return false;
+        dict.append(QString::fromUtf8(p, len));
+        p += len;
+    }
+    if (end - p < 4) return false;
+    quint32 blockCount = getFixed<quint32>(p);
+    p += 4;
+    QVector<QPair<quint64, quint32> > blocks;
+    for (quint32 i = 0; i < blockCount; ++i) {
+        if (end - p < 12) return false;
+        blocks.append(qMakePair(getFixed<quint64>(p), getFixed<quint32>(p + 8)));
+        p += 12;
+    }
+
+    // 3. 逐块解码，只保留按字典编号累加的统计数组
+    QVector<DishTotal> totals(dict.size());
+    qint64 lastOrderSeen = -1;
+    for (int b = 0; b < blocks.size(); ++b) {
+        quint64 start = blocks[b].first;
+        quint64 stop = (b + 1 < blocks.size()) ? blocks[b + 1].first : footerOffset;
+        if (stop <= start) return false;
+        file.seek((qint64)start);
+        QByteArray data = file.read((qint64)(stop - start));
+        if ((quint64)data.size() != stop - start || data.size() < 4) return false;
+
+        const char *q = data.constData();
+        const char *qend = q + data.size();
+        quint32 rows = getFixed<quint32>(q);
+        q += 4;
+
+        const char *col[COLUMN_COUNT];
+        const char *colEnd[COLUMN_COUNT];
+        for (int c = 0; c < COLUMN_COUNT; ++c) {
+            if (qend - q < 4) return false;
+            quint32 len = getFixed<quint32>(q);
+            q += 4;
+            if ((quint64)(qend - q) < len) return false;
+            col[c] = q;
+            colEnd[c] = q + len;
+            q += len;
+        }
+
+        qint64 orderId = 0;
+        for (quint32 r = 0; r < rows; ++r) {
+            quint64 v[COLUMN_COUNT];
+            for (int c = 0; c < COLUMN_COUNT; ++c) {
+                if (!getVarint(col[c], colEnd[c], &v[c])) return false;
+            }
+            orderId += unzigzag(v[0]);
+            if (v[2] >= (quint64)totals.size()) return false;
+
+            if (orderId != lastOrderSeen) {
+                ++report->orders; // 行按订单号排序，订单号变化即新订单
+                lastOrderSeen = orderId;
+            }
+            qint64 cents = (qint64)v[3] * (qint64)v[4];
+            totals[(int)v[2]].qty += (qint64)v[3];
+            totals[(int)v[2]].cents += cents;
+            report->revenueCents += cents;
+            ++report->lines;
+        }
+    }
+
+    for (int i = 0; i < dict.size(); ++i) {
+        DishTotal &t = report->dishes[dict.at(i)];
+        t.qty += totals[i].qty;
+        t.cents += totals[i].cents;
+    }
+    return true;
+}
+
+void OrderReportReader::print(const Report &report)
+{
+    qDebug().noquote() << QString("[Report] orders %1, lines %2, revenue %3 元")
+                          .arg(report.orders).arg(report.lines).arg(report.revenueCents / 100.0, 0, 'f', 2);
+    QMapIterator<QString, DishTotal> i(report.dishes);
+    while (i.hasNext()) {
+        i.next();
+        qDebug().noquote() << QString("  %1  x%2  %3 元")
+                              .arg(i.key()).arg(i.value().qty).arg(i.value().cents / 100.0, 0, 'f', 2);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef ORDEREXPORT_H
+#define ORDEREXPORT_H
+
+#include <QString>
+#include <QDate>
+#include <QMap>
+
+// 日结导出：把一天的订单明细流式写成紧凑的列式文件，供报表使用
+//
+// 文件格式 (整数均为小端)：
+//   头部   "CCOL" + u16 版本
+//   数据块 u32 行数，随后 5 列，每列 [u32 字节数][数据]：
+//          order_id    与上一行的差值，zigzag 变长整数
+//          created_at  与上一行的差值 (毫秒)，zigzag 变长整数
+//          dish        字典编号，变长整数
+//          qty         变长整数
+//          unit_cents  单价 (分)，变长整数
+//          差值在每个块开头清零，块之间可以独立解码
+//   尾部   字典 [u32 个数]{[u16 长度][UTF-8 菜名]}，块索引 [u32 个数]{[u64 偏移][u32 行数]}
+//   结尾   u64 尾部偏移 + "CCOL"
+//
+// 导出和读取都是逐块进行，内存占用只和块大小、菜名字典大小有关，与当天订单量无关。
+class OrderExporter
+{
+public:
+    static const int BLOCK_ROWS = 4096;
+
+    // 导出 date 当天的订单明细，使用独立的数据库连接，可以在任意线程调用
+    static bool exportDay(const QString &dbPath, const QDate &date, const QString &outPath);
+    // 补导最近 lookbackDays 天 (不含今天) 中还没有导出文件的日期
+    static int exportMissingDays(const QString &dbPath, const QString &outDir, int lookbackDays = 7);
+    static QString fileNameFor(const QDate &date);
+};
+
+// 报表读取：逐块解码，统计营业额和每道菜的销量
+class OrderReportReader
+{
+public:
+    struct DishTotal {
+        qint64 qty = 0;
+        qint64 cents = 0;
+    };
+    struct Report {
+        qint64 revenueCents = 0;
+        int orders = 0;
+        int lines = 0;
+        QMap<QString, DishTotal> dishes;
+    };
+
+    static bool read(const QString &path, Report *report);
+    static void print(const Report &report);
+};
+
+#endif // ORDEREXPORT_H
@@ -0,0 +1,93 @@
+#include "orderpublisher.h"
+#include "dbmanager.h"
+#include "toastmanager.h"
+#include <QCoreApplication>
+#include <QTimer>
+#include <QUuid>
+#include <QDebug>
+
+OrderPublisher* OrderPublisher::m_instance = nullptr;
+
+OrderPublisher* OrderPublisher::instance()
+{
+    if (m_instance == nullptr) {
+        m_instance = new OrderPublisher(qApp);
+    }
+    return m_instance;
+}
+
+OrderPublisher::OrderPublisher(QObject *parent) : QObject(parent)
+{
+    m_warned = false;
+    m_hintTimer = new QTimer(this);
+    connect(m_hintTimer, SIGNAL(timeout()), this, SLOT(onSendSlow()));
+
+    m_mqtt = new MiniMqtt(this);
+    connect(m_mqtt, &MiniMqtt::connected, [=](){
+        qDebug() << "OrderPublisher: MQTT Connected!";
+    });
+
+    // 上次没送达的订单排在最前面，MiniMqtt 连上之前先排队
+    QList<OutboxMessage> backlog = DBManager::instance().loadOutbox();
+    if (!backlog.isEmpty()) qDebug() << "OrderPublisher: resend" << backlog.size() << "order(s) left in outbox";
+    foreach (const OutboxMessage &message, backlog) {
+        send(message.orderNo, message.topic, message.payload);
+    }
+
+    m_mqtt->connectToHost(MQTT_IP, MQTT_PORT);
+}
+
+void OrderPublisher::submit(const QString &orderNo, const QString &json)
+{
+    QString key = orderNo;
+    if (key.isEmpty()) {
+        // 正常不会出现：订单 JSON 都带 order_no。没有的话后厨没法去重，但单子照样要发
+        qDebug() << "OrderPublisher: order without order_no";
+        key = QUuid::createUuid().toString();
+    }
+    if (m_pending.contains(key)) return;
+
+    // 落库失败 (存储卡满 / 坏) 也照样发，只是这一单不能跨重启补发
+    if (!DBManager::instance().queueOutbox(key, ORDER_TOPIC, json)) {
+        qDebug() << "OrderPublisher: outbox write failed, sending" << key << "from memory only";
+    }
+    qDebug() << "MQTT Sending:" << json;
+    send(key, ORDER_TOPIC, json);
+}
+
+void OrderPublisher::send(const QString &orderNo, const QString &topic, const QString &payload)
+{
+    m_pending.insert(orderNo);
+    if (!m_hintTimer->isActive()) m_hintTimer->start(MQTT_PUBLISH_TIMEOUT_MS);
+    emit pendingChanged(m_pending.size());
+
+    // QoS 1 不会失败，只会一直重发直到 PUBACK (见 MiniMqtt::publish)
+    m_mqtt->publish(topic, payload, 1, [=](bool){
+        DBManager::instance().dropOutbox(orderNo);
+        m_pending.remove(orderNo);
+        qDebug() << "OrderPublisher: order" << orderNo << "delivered";
+        emit delivered(orderNo);
+        emit pendingChanged(m_pending.size());
+
+        if (m_pending.isEmpty()) {
+            m_hintTimer->stop();
+            if (m_warned) {
+                ToastManager::instance()->show(QStringLiteral("网络已恢复，订单已全部送达后厨"),
+                                               ToastManager::Info, "order-send");
+                m_warned = false;
+            }
+        }
+    });
+}
+
+void OrderPublisher::onSendSlow()
+{
+    if (m_pending.isEmpty()) {
+        m_hintTimer->stop();
+        return;
+    }
+    m_warned = true;
+    ToastManager::instance()->show(QStringLiteral("网络连接中断，%1 张订单已保存，恢复后会自动发给后厨").arg(m_pending.size()),
+                                   ToastManager::Warning, "order-send");
+    m_hintTimer->start(ORDER_SEND_HINT_MS);
+}
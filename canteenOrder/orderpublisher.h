@@ -0,0 +1,50 @@
+#ifndef ORDERPUBLISHER_H
+#define ORDERPUBLISHER_H
+
+#include <QObject>
+#include <QSet>
+#include "minimqtt.h"
+
+class QTimer;
+
+#define ORDER_TOPIC         "canteen/order/new"
+#define ORDER_SEND_HINT_MS  30000   // 订单积压时重复提示的间隔 (第一次提示在 MQTT_PUBLISH_TIMEOUT_MS 之后)
+
+// 订单发布
+// 整个程序一个实例、一条长连接，不随支付对话框创建销毁。
+// 订单先写进数据库的 order_outbox，再用 QoS 1 发出，收到 PUBACK 才删除；
+// 断网时支付照常完成，连上后自动补发，掉电重启后也会把 outbox 里剩下的重新发出。
+// 补发 / 重发可能让后厨收到同一张单两次，后厨按订单 JSON 里的 order_no 去重
+class OrderPublisher : public QObject
+{
+    Q_OBJECT
+public:
+    static OrderPublisher* instance();
+
+    // 写进 outbox 后立即返回，不等服务器确认
+    void submit(const QString &orderNo, const QString &json);
+    int pendingCount() const { return m_pending.size(); }
+    // 程序共用的 MQTT 会话：页面在上面订阅 / 发布，不再各自连接。
+    // 会话比页面活得久，页面连它的信号时必须带 context 对象
+    MiniMqtt *session() const { return m_mqtt; }
+
+signals:
+    void pendingChanged(int count);     // 还没送达后厨的订单数
+    void delivered(const QString &orderNo);
+
+private slots:
+    void onSendSlow();          // 订单迟迟没有确认，提示正在重连
+
+private:
+    explicit OrderPublisher(QObject *parent = nullptr);
+    static OrderPublisher* m_instance;
+
+    void send(const QString &orderNo, const QString &topic, const QString &payload);
+
+    MiniMqtt *m_mqtt;
+    QSet<QString> m_pending;    // 已发出、等 PUBACK 的订单号
+    QTimer *m_hintTimer;
+    bool m_warned;              // 提示过积压，全部送达后再提示一次
+};
+
+#endif // ORDERPUBLISHER_H
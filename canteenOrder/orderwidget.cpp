@@ -1,39 +1,71 @@
 #include "orderwidget.h"
 #include "hardwarecontrol.h"
 #include "paywidget.h"
-#include <QMessageBox>
+#include "menucatalog.h"
+#include "salesstats.h"
+#include "brandstyle.h"
+#include "toastmanager.h"
+#include "orderpublisher.h"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QScroller>
 #include <QDebug>
 #include <QRegExp>
+#include <QSet>
+#include <QUuid>
+
+#define DISH_ROWS_FIRST 4       // 一屏 (330px) 能看到的菜品行数
+#define DISH_ROWS_PER_STEP 2    // 之后每轮事件循环补的行数
 
 OrderWidget::OrderWidget(QWidget *parent) : QWidget(parent)
 {
-    this->setStyleSheet("background-color: #FFFFFF;");
+    BrandStyle::setPanel(this, BrandStyle::Look(Qt::white));
 
     m_isOrderCompleted = false;
+    m_active = false;
+    m_dishTimer = new QTimer(this);
+    m_dishTimer->setSingleShot(true);
+    m_dishTimer->setInterval(0);
+    connect(m_dishTimer, SIGNAL(timeout()), this, SLOT(addPendingDishes()));
     m_haveOrderedPage = new HaveOrdered(this);
     m_haveOrderedPage->hide();
-    m_mqtt = new MiniMqtt(this);
+    m_mqtt = OrderPublisher::instance()->session();
 
     initUI();
-    updateDishList(QStringLiteral("热销榜"));
+    updateDishList(MenuCatalog::hotCategory());
+
+    // 热销榜变化时，如果当前正在看热销榜就刷新
+    connect(SalesStats::instance(), &SalesStats::hotListChanged, this, [=](){
+        QListWidgetItem *current = listCategories->currentItem();
+        if (current && current->text() == MenuCatalog::hotCategory()) {
+            updateDishList(current->text());
+        }
+    });
+    // MQTT 订阅和硬件催单在 activate() 里接上：主界面在登录界面空闲时就会构造本页
+}
+
+void OrderWidget::activate()
+{
+    if (m_active) return;
+    m_active = true;
 
     connect(HardwareControl::instance(), &HardwareControl::urgeOrderTriggered,
             this, &OrderWidget::handleUrgeOrder);
-    connect(m_mqtt, &MiniMqtt::connected, this, [=](){
-        m_mqtt->subscribe("canteen/kitchen/status");
-    });
+    // 共用会话可能早就连上了：先订阅一次，之后每次重连 (Clean Session 不保留订阅) 再订阅
+    connect(m_mqtt, &MiniMqtt::connected, this, &OrderWidget::subscribeTopics);
+    if (m_mqtt->isConnected()) subscribeTopics();
 
-    // 处理收到消息
-    connect(m_mqtt, &MiniMqtt::connected, [=](){
-        qDebug() << "OrderWidget: MQTT Connected!";
-        // 订阅通知主题
-        m_mqtt->subscribe("canteen/service/notify");
+    // 本机销量增量广播给其他点餐机
+    connect(SalesStats::instance(), &SalesStats::localSalesRecorded, this, [=](const QString &json){
+        m_mqtt->publish("canteen/sales/delta", json);
     });
     connect(m_mqtt, &MiniMqtt::received, this, [=](QString topic, QString message){
 
+        if (topic == "canteen/sales/delta") {
+            SalesStats::instance()->mergeRemote(message);
+            return;
+        }
+
         // 过滤主题
         if(topic == "canteen/service/notify") {
             qDebug() << "Received Notification:" << message;
@@ -43,20 +75,21 @@ OrderWidget::OrderWidget(QWidget *parent) : QWidget(parent)
                 isForMe = true;
             }
             if (isForMe) {
-                QMessageBox msgBox;
-                msgBox.setWindowTitle("取餐提醒");
-                msgBox.setText("您的餐点已经准备好！\n请前往柜台取餐。");
-                msgBox.setIcon(QMessageBox::Information);
-                msgBox.setStandardButtons(QMessageBox::Ok);
-
-                msgBox.setStyleSheet("QLabel{font-size: 20px; font-weight: bold;} QPushButton{width: 100px; height: 40px; font-size: 18px;}");
-
-                msgBox.exec();
+                // 不能在网络回调里开模态框：重复推送会合并成一条
+                ToastManager::instance()->show(QStringLiteral("您的餐点已经准备好！\n请前往柜台取餐。"),
+                                               ToastManager::Urgent, "meal-ready");
             }
         }
     });
+}
 
-    m_mqtt->connectToHost(MQTT_IP, MQTT_PORT);
+void OrderWidget::subscribeTopics()
+{
+    m_mqtt->subscribe("canteen/kitchen/status");
+    // 订阅通知主题
+    m_mqtt->subscribe("canteen/service/notify");
+    // 其他点餐机的销量增量
+    m_mqtt->subscribe("canteen/sales/delta");
 }
 
 void OrderWidget::initUI()
@@ -72,19 +105,19 @@ void OrderWidget::initUI()
     listCategories->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     QScroller::grabGesture(listCategories, QScroller::LeftMouseButtonGesture);
     listCategories->setIconSize(QSize(32, 32));
-    listCategories->setStyleSheet(
-                "QListWidget { background-color: #F2F4F7; border: none; outline: none; }"
-                "QListWidget::item { height: 65px; padding-left: 5px; color: #666; font-size: 14px; border-bottom: 1px solid #E5E5E5; }"
-                "QListWidget::item:selected { background-color: #FFFFFF; color: #333; font-weight: bold; border-left: 4px solid #FFD161; }"
-                );
-
-    addCategory(QStringLiteral("热销榜"),   ":/res/hot.png");
-    addCategory(QStringLiteral("优惠套餐"), ":/res/preferential.png");
-    addCategory(QStringLiteral("精品寿司"), ":/res/sushi.png");
-    addCategory(QStringLiteral("日式拉面"), ":/res/romen.png");
-    addCategory(QStringLiteral("手作饭团"), ":/res/rice.png");
-    addCategory(QStringLiteral("新鲜刺身"), ":/res/cishen.png");
-    addCategory(QStringLiteral("特色饮品"), ":/res/drink_logo.png");
+    listCategories->setFrameShape(QFrame::NoFrame);
+    QPalette categoryPal = listCategories->palette();
+    categoryPal.setColor(QPalette::Base, QColor("#F2F4F7"));
+    listCategories->setPalette(categoryPal);
+    BrandItemDelegate *categoryDelegate = new BrandItemDelegate(65, 14, QColor("#666666"), listCategories);
+    categoryDelegate->setPadding(5, 0);
+    categoryDelegate->setDivider(QColor("#E5E5E5"));
+    categoryDelegate->setSelected(Qt::white, QColor("#333333"), QColor("#FFD161"), 4);
+    listCategories->setItemDelegate(categoryDelegate);
+
+    for (const QString &category : MenuCatalog::categories()) {
+        addCategory(category, MenuCatalog::categoryIcon(category));
+    }
 
     listCategories->setCurrentRow(0);
     connect(listCategories, SIGNAL(itemClicked(QListWidgetItem*)), this, SLOT(onCategoryClicked(QListWidgetItem*)));
@@ -93,7 +126,7 @@ void OrderWidget::initUI()
     listDishes = new QListWidget(this);
     listDishes->setFocusPolicy(Qt::NoFocus);
     listDishes->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    listDishes->setStyleSheet("QListWidget { background-color: #FFFFFF; border: none; outline: none; }");
+    listDishes->setFrameShape(QFrame::NoFrame);
     listDishes->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
     QScroller::grabGesture(listDishes, QScroller::LeftMouseButtonGesture);
 
@@ -116,60 +149,49 @@ void OrderWidget::onCategoryClicked(QListWidgetItem *item)
 void OrderWidget::updateDishList(const QString &category)
 {
     listDishes->clear();
-
-    // 【关键】判断字符串时也使用 QStringLiteral
-    if (category.contains(QStringLiteral("热销榜"))) {
-        addDishItem(QStringLiteral("蛋丝三文鱼包饭"), "49", ":/res/sushi1.png", 214);
-        addDishItem(QStringLiteral("招牌鳗鱼饭"), "58", ":/res/sushi2.png", 500);
-        addDishItem(QStringLiteral("加州卷(4粒)"), "22", ":/res/sushi3.png", 120);
-        addDishItem(QStringLiteral("铁火卷"), "667", ":/res/sushi5.png", 73);
-        addDishItem(QStringLiteral("卷寿司"), "345", ":/res/sushi6.png", 37);
-        addDishItem(QStringLiteral("豪华刺身拼盘"), "128", ":/res/sashimi1.png", 50);
-        addDishItem(QStringLiteral("火腿海苔饭团"), "057", ":/res/rice2.png", 90);
-        addDishItem(QStringLiteral("饭团拼盘"), "282", ":/res/rice3.png", 87);
-    }
-    else if (category.contains(QStringLiteral("优惠套餐"))) {
-        addDishItem(QStringLiteral("稻荷寿司"), "257", ":/res/sushi8.png", 78);
-        addDishItem(QStringLiteral("茶巾寿司"), "267", ":/res/sushi9.png", 89);
-         addDishItem(QStringLiteral("经典日式豚骨拉面"), "672", ":/res/romen1.png", 120);
-         addDishItem(QStringLiteral("经典刺身"), "355", ":/res/sashimi1.png", 120);
-         addDishItem(QStringLiteral("刺身大拼盘"), "456", ":/res/sashimi2.png", 90);
-         addDishItem(QStringLiteral("新鲜三文鱼刺身"), "980", ":/res/sashimi3.png", 87);
-    }
-    else if(category.contains(QStringLiteral("精品寿司"))){
-        addDishItem(QStringLiteral("握寿司"), "232", ":/res/sushi1.png", 120);
-        addDishItem(QStringLiteral("加州卷(4粒)"), "244", ":/res/sushi2.png", 90);
-        addDishItem(QStringLiteral("军舰卷"), "654", ":/res/sushi3.png", 87);
-        addDishItem(QStringLiteral("散寿司"), "436", ":/res/sushi4.png", 69);
-        addDishItem(QStringLiteral("铁火卷"), "667", ":/res/sushi5.png", 73);
-        addDishItem(QStringLiteral("卷寿司"), "345", ":/res/sushi6.png", 37);
-        addDishItem(QStringLiteral("太卷"), "279", ":/res/sushi7.png", 34);
-        addDishItem(QStringLiteral("稻荷寿司"), "257", ":/res/sushi8.png", 78);
-        addDishItem(QStringLiteral("茶巾寿司"), "267", ":/res/sushi9.png", 89);
-        addDishItem(QStringLiteral("押寿司"), "837", ":/res/sushi10.png", 27);
-        addDishItem(QStringLiteral("手卷"), "282", ":/res/sushi11.png", 82);
-        addDishItem(QStringLiteral("奶油三文鱼寿司"), "134", ":/res/sushi12.png", 81);
-    }
-    else if(category.contains(QStringLiteral("日式拉面"))){
-        addDishItem(QStringLiteral("经典日式豚骨拉面"), "672", ":/res/romen1.png", 120);
-        addDishItem(QStringLiteral("日式牛肉拉面"), "365", ":/res/romen2.png", 90);
-        addDishItem(QStringLiteral("日式清汤拉面"), "568", ":/res/romen3.png", 87);
-    }
-    else if(category.contains(QStringLiteral("手作饭团"))){
-        addDishItem(QStringLiteral("豆芽饭团"), "353", ":/res/rice1.png", 120);
-        addDishItem(QStringLiteral("火腿海苔饭团"), "057", ":/res/rice2.png", 90);
-        addDishItem(QStringLiteral("饭团拼盘"), "282", ":/res/rice3.png", 87);
+    m_pendingDishes.clear();
+
+    if (category == MenuCatalog::hotCategory()) {
+        // 热销榜：按最近 30 天销量取前 k 名，数据不足时用默认推荐补齐
+        QVector<QPair<QString, int> > hot = SalesStats::instance()->hotList();
+        QSet<QString> shown;
+        for (const QPair<QString, int> &entry : hot) {
+            const DishInfo *dish = MenuCatalog::find(entry.first);
+            if (!dish) continue;
+            PendingDish row = { dish->name, dish->price, dish->image, entry.second };
+            m_pendingDishes.append(row);
+            shown.insert(dish->name);
+        }
+        for (const DishInfo &dish : MenuCatalog::dishesIn(category)) {
+            if (shown.size() >= SalesStats::HOT_LIST_SIZE) break;
+            if (shown.contains(dish.name)) continue;
+            PendingDish row = { dish.name, dish.price, dish.image, SalesStats::instance()->monthlySales(dish.name) };
+            m_pendingDishes.append(row);
+            shown.insert(dish.name);
+        }
+    } else {
+        for (const DishInfo &dish : MenuCatalog::dishesIn(category)) {
+            PendingDish row = { dish.name, dish.price, dish.image, SalesStats::instance()->monthlySales(dish.name) };
+            m_pendingDishes.append(row);
+        }
     }
-    else if(category.contains(QStringLiteral("新鲜刺身"))){
-        addDishItem(QStringLiteral("经典刺身"), "355", ":/res/sashimi1.png", 120);
-        addDishItem(QStringLiteral("刺身大拼盘"), "456", ":/res/sashimi2.png", 90);
-        addDishItem(QStringLiteral("新鲜三文鱼刺身"), "980", ":/res/sashimi3.png", 87);
+
+    // 首屏的几行马上建好，其余的交给定时器分批
+    for (int i = 0; i < DISH_ROWS_FIRST && !m_pendingDishes.isEmpty(); ++i) {
+        PendingDish row = m_pendingDishes.takeFirst();
+        addDishItem(row.name, row.price, row.image, row.sales);
     }
-    else if(category.contains(QStringLiteral("特色饮品"))){
-        addDishItem(QStringLiteral("经典可乐"), "273", ":/res/drink.png", 120);
-        addDishItem(QStringLiteral("日本清酒"), "183", ":/res/drink2.png", 90);
-        addDishItem(QStringLiteral("鲜榨葡萄汁"), "641", ":/res/drink3.png", 87);
+    if (!m_pendingDishes.isEmpty()) m_dishTimer->start();
+}
+
+// 每轮事件循环只建 DISH_ROWS_PER_STEP 行，中间能处理触摸和重绘
+void OrderWidget::addPendingDishes()
+{
+    for (int i = 0; i < DISH_ROWS_PER_STEP && !m_pendingDishes.isEmpty(); ++i) {
+        PendingDish row = m_pendingDishes.takeFirst();
+        addDishItem(row.name, row.price, row.image, row.sales);
     }
+    if (!m_pendingDishes.isEmpty()) m_dishTimer->start();
 }
 
 void OrderWidget::addDishItem(const QString &name, const QString &priceStr, const QString &imagePath, int sales)
@@ -188,7 +210,7 @@ void OrderWidget::addDishItem(const QString &name, const QString &priceStr, cons
     // --- 界面绘制 ---
     QWidget *itemWidget = new QWidget(this);
     itemWidget->setFixedHeight(125);
-    itemWidget->setStyleSheet("background-color: white; border-bottom: 1px solid #F0F0F0;");
+    BrandStyle::setPanel(itemWidget, BrandStyle::Look(Qt::white).border(QColor("#F0F0F0"), 1, Qt::BottomEdge));
 
     QHBoxLayout *layout = new QHBoxLayout(itemWidget);
     layout->setContentsMargins(10, 10, 10, 10);
@@ -196,11 +218,12 @@ void OrderWidget::addDishItem(const QString &name, const QString &priceStr, cons
 
     QLabel *imgLabel = new QLabel(itemWidget);
     imgLabel->setFixedSize(80, 80);
-    imgLabel->setStyleSheet("border: 1px solid #EEE; border-radius: 4px;");
+    BrandStyle::setPanel(imgLabel, BrandStyle::Look(QColor(), 4).border(QColor("#EEEEEE")));
     if(!imagePath.isEmpty()) {
-        QPixmap pix(imagePath);
-        if(!pix.isNull()){
-            imgLabel->setPixmap(pix.scaled(80, 80, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation));
+        // 启动时已在后台解码缩放好，这里只是上传
+        QImage thumb = MenuCatalog::thumbnail(imagePath);
+        if(!thumb.isNull()){
+            imgLabel->setPixmap(QPixmap::fromImage(thumb));
             imgLabel->setScaledContents(true);
         } else {
             imgLabel->setText(QStringLiteral("无图"));
@@ -213,43 +236,39 @@ void OrderWidget::addDishItem(const QString &name, const QString &priceStr, cons
     infoLayout->setContentsMargins(0, 2, 0, 2);
 
     QLabel *lblName = new QLabel(name, itemWidget);
-    lblName->setStyleSheet("font-size: 16px; color: #222; border: none; font-weight: bold;");
+    BrandStyle::setText(lblName, QColor("#222222"), 16, true);
     lblName->setWordWrap(true);
 
     QLabel *lblDesc = new QLabel(QStringLiteral("主厨推荐 | 现点现做"), itemWidget);
-    lblDesc->setStyleSheet("font-size: 12px; color: #888; border: none;");
+    BrandStyle::setText(lblDesc, QColor("#888888"), 12);
 
     QLabel *lblSales = new QLabel(QStringLiteral("月售 %1").arg(sales), itemWidget);
-    lblSales->setStyleSheet("font-size: 11px; color: #999; border: none;");
+    BrandStyle::setText(lblSales, QColor("#999999"), 11);
 
     QHBoxLayout *bottomLayout = new QHBoxLayout();
     bottomLayout->setSpacing(4);
 
     QLabel *lblPriceNum = new QLabel(priceStr, itemWidget);
-    lblPriceNum->setStyleSheet("font-size: 24px; color: #FF4D4F; font-weight: bold; border: none; font-family: 'Arial';");
+    BrandStyle::setText(lblPriceNum, QColor("#FF4D4F"), 24, true, "Arial");
 
     QLabel *lblUnit = new QLabel(QStringLiteral("元"), itemWidget);
-    lblUnit->setStyleSheet("font-size: 14px; color: #FF4D4F; padding-bottom: 3px; border: none;");
+    BrandStyle::setText(lblUnit, QColor("#FF4D4F"), 14);
+    lblUnit->setContentsMargins(0, 0, 0, 3);
 
     QPushButton *btnMinus = new QPushButton("－", itemWidget);
     btnMinus->setFixedSize(28, 28);
-    btnMinus->setStyleSheet(
-                "QPushButton { border: 1px solid #DDD; background: white; color: #888; font-size: 18px; border-radius: 14px; font-weight: bold; }"
-                "QPushButton:pressed { background: #EEE; }"
-                );
+    BrandStyle::setButton(btnMinus, BrandStyle::Look(Qt::white, 14).pressed(QColor("#EEEEEE")).border(QColor("#DDDDDD")),
+                          QColor("#888888"), 18, true);
 
     int currentCount = m_cart.value(name, 0);
     QLabel *lblCount = new QLabel(QString::number(currentCount), itemWidget);
     lblCount->setFixedWidth(30);
     lblCount->setAlignment(Qt::AlignCenter);
-    lblCount->setStyleSheet("color: #333; font-size: 16px; border: none; font-weight: bold;");
+    BrandStyle::setText(lblCount, QColor("#333333"), 16, true);
 
     QPushButton *btnAdd = new QPushButton("＋", itemWidget);
     btnAdd->setFixedSize(28, 28);
-    btnAdd->setStyleSheet(
-                "QPushButton { border: none; background-color: #FFD161; color: #333; font-size: 18px; border-radius: 14px; font-weight: bold; }"
-                "QPushButton:pressed { background-color: #FBC02D; }"
-                );
+    BrandStyle::setButton(btnAdd, BrandStyle::Look(QColor("#FFD161"), 14).pressed(QColor("#FBC02D")), QColor("#333333"), 18, true);
 
     connect(btnAdd, &QPushButton::clicked, [=](){
         int count = m_cart.value(name, 0);
@@ -294,10 +313,11 @@ void OrderWidget::addDishItem(const QString &name, const QString &priceStr, cons
 void OrderWidget::clearCart()
 {
     m_cart.clear();
+    m_orderNo.clear();
     m_isOrderCompleted = false;
     QListWidgetItem *currentItem = listCategories->currentItem();
     if(currentItem) updateDishList(currentItem->text());
-    else updateDishList(QStringLiteral("热销榜"));
+    else updateDishList(MenuCatalog::hotCategory());
 }
 
 void OrderWidget::setOrderCompleted(bool completed)
@@ -332,16 +352,10 @@ void OrderWidget::handleUrgeOrder()
         return;
     }
 
-    HardwareControl::instance()->flashLedSuccess();
-    HardwareControl::instance()->playSuccessSound();
-
-    QMessageBox box(QMessageBox::Information, QStringLiteral("催单成功"),
-                    QStringLiteral("我们要加急了！\n厨师正在飞速制作中！"));
-    box.setStandardButtons(QMessageBox::Ok);
-    box.setButtonText(QMessageBox::Ok, QStringLiteral("知道了"));
+    HardwareControl::instance()->signalSuccess();
 
-    QTimer::singleShot(2000, &box, SLOT(accept()));
-    box.exec();
+    ToastManager::instance()->show(QStringLiteral("我们要加急了！\n厨师正在飞速制作中！"),
+                                   ToastManager::Info, "urge");
 }
 
 void OrderWidget::processPaymentSuccess()
@@ -359,6 +373,7 @@ void OrderWidget::processPaymentSuccess()
 
     // 2. 清空当前购物车
     m_cart.clear();
+    m_orderNo.clear();
     m_haveOrderedPage->show();
 }
 
@@ -393,10 +408,20 @@ QString OrderWidget::getOrderJson()
         firstItem = false;
     }
 
-    // 组合最终 JSON
-    QString finalJson = QString("{\"table\":1, \"total\":%1, \"items\":[%2]}")
+    // 组合最终 JSON。order_no 在支付二维码里出现，后厨也按它去重 (断线重发的同一张单)
+    QString finalJson = QString("{\"order_no\":\"%1\", \"table\":1, \"total\":%2, \"items\":[%3]}")
+            .arg(orderNo())
             .arg(totalAmount)
             .arg(jsonItems);
 
     return finalJson;
 }
+
+QString OrderWidget::orderNo()
+{
+    // 同一份购物车反复进出结算页时订单号不变，支付二维码也就能命中缓存
+    if (m_orderNo.isEmpty()) {
+        m_orderNo = QUuid::createUuid().toString().mid(1, 36);  // 去掉花括号 (Qt 5.7 没有 WithoutBraces)
+    }
+    return m_orderNo;
+}
@@ -6,7 +6,7 @@
 #include <QMap>
 #include <QLabel>
 #include <QPushButton>
-#include <QMessageBox>
+#include <QTimer>
 #include "haveordered.h"
 #include "minimqtt.h"
 
@@ -24,6 +24,9 @@ public:
     void processPaymentSuccess();
     bool canUrgeOrder() { return m_haveOrderedPage && m_haveOrderedPage->hasOrders(); }
     QString getOrderJson();
+    QString orderNo();          // 当前购物车的订单号，第一次取时生成，清空购物车后换新
+    // 登录后才接上 MQTT 订阅 / 收发和硬件催单，重复调用无效
+    void activate();
 
 signals:
     void cartUpdated(int totalCount); // 购物车变化信号（可选，用于更新主页红点等）
@@ -39,18 +42,32 @@ private:
 private slots:
     void onCategoryClicked(QListWidgetItem *item);
     void handleUrgeOrder();
+    void addPendingDishes();    // 分批补上列表剩下的菜品行
+    void subscribeTopics();
 
 
 private:
     QListWidget *listCategories;
     QListWidget *listDishes;
 
+    // 首屏放不下的菜品行在之后几轮事件循环里分批构造
+    struct PendingDish {
+        QString name;
+        QString price;
+        QString image;
+        int sales;
+    };
+    QList<PendingDish> m_pendingDishes;
+    QTimer *m_dishTimer;
+
     // 数据成员
     QMap<QString, int> m_cart;      // <菜名, 数量>
     QMap<QString, double> m_prices; // <菜名, 单价>
+    QString m_orderNo;
     bool m_isOrderCompleted;
+    bool m_active;
     HaveOrdered *m_haveOrderedPage;
-    MiniMqtt *m_mqtt;
+    MiniMqtt *m_mqtt;           // OrderPublisher 的共用会话，不归本页所有
 };
 
 #endif // ORDERWIDGET_H
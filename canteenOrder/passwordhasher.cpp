@@ -0,0 +1,83 @@
+#include "passwordhasher.h"
+#include <QCryptographicHash>
+#include <QFile>
+#include <QTime>
+#include <QtEndian>
+
+QByteArray PasswordHasher::generateSalt(int bytes)
+{
+    QByteArray salt;
+    QFile urandom("/dev/urandom");
+    if (urandom.open(QIODevice::ReadOnly)) {
+        salt = urandom.read(bytes);
+        urandom.close();
+    }
+    // 读不到 /dev/urandom 时退化为 qrand，仍能保证每个用户的盐不同
+    if (salt.size() != bytes) {
+        qsrand(QTime::currentTime().msecsSinceStartOfDay());
+        salt.resize(bytes);
+        for (int i = 0; i < bytes; ++i) salt[i] = (char)(qrand() & 0xFF);
+    }
+    return salt;
+}
+
+QByteArray PasswordHasher::hash(const QString &password, const QByteArray &salt, int iterations)
+{
+    return pbkdf2Sha256(password.toUtf8(), salt, iterations, KEY_BYTES);
+}
+
+bool PasswordHasher::verify(const QString &password, const QByteArray &salt, int iterations, const QByteArray &expected)
+{
+    if (salt.isEmpty() || iterations <= 0 || expected.isEmpty()) return false;
+    return constantTimeEquals(hash(password, salt, iterations), expected);
+}
+
+bool PasswordHasher::constantTimeEquals(const QByteArray &a, const QByteArray &b)
+{
+    if (a.size() != b.size()) return false;
+    unsigned char diff = 0;
+    for (int i = 0; i < a.size(); ++i) {
+        diff |= (unsigned char)(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+// RFC 8018 PBKDF2，PRF 为 HMAC-SHA256
+// ipad/opad 与密钥异或的结果在整个计算中不变，提前算好，每轮只需两次 SHA256
+QByteArray PasswordHasher::pbkdf2Sha256(const QByteArray &password, const QByteArray &salt, int iterations, int keyLen)
+{
+    const int blockSize = 64;
+    QByteArray key = password;
+    if (key.size() > blockSize) key = QCryptographicHash::hash(key, QCryptographicHash::Sha256);
+    key = key.leftJustified(blockSize, '\0');
+
+    QByteArray ipad(blockSize, 0), opad(blockSize, 0);
+    for (int i = 0; i < blockSize; ++i) {
+        ipad[i] = (char)(key[i] ^ 0x36);
+        opad[i] = (char)(key[i] ^ 0x5c);
+    }
+
+    auto hmac = [&](const QByteArray &msg) {
+        QCryptographicHash inner(QCryptographicHash::Sha256);
+        inner.addData(ipad);
+        inner.addData(msg);
+        QCryptographicHash outer(QCryptographicHash::Sha256);
+        outer.addData(opad);
+        outer.addData(inner.result());
+        return outer.result();
+    };
+
+    QByteArray derived;
+    for (quint32 block = 1; derived.size() < keyLen; ++block) {
+        uchar be[4];
+        qToBigEndian(block, be);
+        QByteArray u = hmac(salt + QByteArray((const char *)be, 4));
+        QByteArray t = u;
+        for (int n = 1; n < iterations; ++n) {
+            u = hmac(u);
+            for (int k = 0; k < t.size(); ++k) t[k] = (char)(t[k] ^ u[k]);
+        }
+        derived.append(t);
+    }
+    return derived.left(keyLen);
+}
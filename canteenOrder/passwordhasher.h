@@ -0,0 +1,27 @@
+#ifndef PASSWORDHASHER_H
+#define PASSWORDHASHER_H
+
+#include <QByteArray>
+#include <QString>
+
+// 口令哈希工具：PBKDF2-HMAC-SHA256 + 随机盐
+// 计算量与迭代次数成正比，开发板上一次约数百毫秒，不要在 GUI 线程调用 hash/verify
+class PasswordHasher
+{
+public:
+    static const int DEFAULT_ITERATIONS = 20000;
+    static const int SALT_BYTES = 16;
+    static const int KEY_BYTES = 32;
+
+    static QByteArray generateSalt(int bytes = SALT_BYTES);
+    static QByteArray hash(const QString &password, const QByteArray &salt, int iterations);
+    static bool verify(const QString &password, const QByteArray &salt, int iterations, const QByteArray &expected);
+
+    // 等长比较，耗时与内容无关，避免按位泄露
+    static bool constantTimeEquals(const QByteArray &a, const QByteArray &b);
+
+private:
+    static QByteArray pbkdf2Sha256(const QByteArray &password, const QByteArray &salt, int iterations, int keyLen);
+};
+
+#endif // PASSWORDHASHER_H
@@ -1,33 +1,29 @@
 #include "paywidget.h"
 #include "hardwarecontrol.h" // [Important] Must include this header to use hardware control
+#include "brandstyle.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QPainter>
-#include <QTime>
+#include "qrcode.h"
+#include "orderpublisher.h"
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QDebug>
 
-PayWidget::PayWidget(int amount, QWidget *parent) : QDialog(parent), m_amount(amount)
+PayWidget::PayWidget(int amount, QWidget *parent) : QDialog(parent), m_amount(amount), m_qrDirty(true)
 {
     this->setWindowFlags(Qt::FramelessWindowHint | Qt::Dialog);
     this->setAttribute(Qt::WA_TranslucentBackground);
     this->setFixedSize(360, 420);
-    qsrand(QTime::currentTime().msec());
     initUI();
-
-    // [1. 初始化 MQTT]
-    m_mqtt = new MiniMqtt(this);
-
-    // 连接成功时的调试信息
-    connect(m_mqtt, &MiniMqtt::connected, [=](){
-        qDebug() << "PayWidget: MQTT Connected!";
-    });
-    m_mqtt->connectToHost
-            (MQTT_IP, MQTT_PORT);
 }
 
 void PayWidget::setOrderData(const QString &json)
 {
     m_jsonOrder = json;
+    m_orderNo = QJsonDocument::fromJson(json.toUtf8()).object().value("order_no").toString();
+    if (!json.isEmpty() && m_orderNo.isEmpty()) qDebug() << "PayWidget: order data has no order_no";
+    m_qrDirty = true;
+    if (isVisible()) updateQRCode();
     qDebug() << "PayWidget received order data:" << m_jsonOrder;
 }
 
@@ -35,7 +31,7 @@ void PayWidget::initUI()
 {
     QWidget *bgWidget = new QWidget(this);
     bgWidget->setGeometry(0, 0, 360, 420);
-    bgWidget->setStyleSheet("background-color: white; border-radius: 12px; border: 1px solid #DDD;");
+    BrandStyle::setPanel(bgWidget, BrandStyle::Look(Qt::white, 12).border(QColor("#DDDDDD")));
 
     QVBoxLayout *mainLayout = new QVBoxLayout(bgWidget);
     mainLayout->setContentsMargins(20, 30, 20, 20);
@@ -43,38 +39,31 @@ void PayWidget::initUI()
 
     QLabel *lblTitle = new QLabel("扫码支付", bgWidget);
     lblTitle->setAlignment(Qt::AlignCenter);
-    lblTitle->setStyleSheet("font-size: 22px; font-weight: bold; color: #333; border: none;");
+    BrandStyle::setText(lblTitle, QColor("#333333"), 22, true);
 
     lblAmount = new QLabel(QStringLiteral("支付金额: %1 元").arg(m_amount), bgWidget);
     lblAmount->setAlignment(Qt::AlignCenter);
-    lblAmount->setStyleSheet("font-size: 18px; color: #FF5339; font-weight: bold; border: none;");
+    BrandStyle::setText(lblAmount, QColor("#FF5339"), 18, true);
 
     lblQRCode = new QLabel(bgWidget);
     lblQRCode->setFixedSize(200, 200);
-    lblQRCode->setStyleSheet("border: 1px solid #EEE;");
+    BrandStyle::setPanel(lblQRCode, BrandStyle::Look().border(QColor("#EEEEEE")));
     lblQRCode->setAlignment(Qt::AlignCenter);
 
-    generateRandomQRCode();
-
     QHBoxLayout *btnLayout = new QHBoxLayout();
     btnLayout->setSpacing(20);
 
-    QPushButton *btnCancel = new QPushButton("取消支付", bgWidget);
+    btnCancel = new QPushButton("取消支付", bgWidget);
     btnCancel->setFixedHeight(45);
     btnCancel->setCursor(Qt::PointingHandCursor);
-    btnCancel->setStyleSheet(
-                "QPushButton { background-color: #F5F5F5; color: #666; font-size: 16px; border-radius: 22px; border: 1px solid #DDD; }"
-                "QPushButton:pressed { background-color: #E0E0E0; }"
-                );
+    BrandStyle::setButton(btnCancel, BrandStyle::Look(QColor("#F5F5F5"), 22).pressed(QColor("#E0E0E0")).border(QColor("#DDDDDD")),
+                          QColor("#666666"), 16);
     connect(btnCancel, SIGNAL(clicked()), this, SLOT(onCancelClicked()));
 
-    QPushButton *btnConfirm = new QPushButton("确认支付", bgWidget);
+    btnConfirm = new QPushButton("确认支付", bgWidget);
     btnConfirm->setFixedHeight(45);
     btnConfirm->setCursor(Qt::PointingHandCursor);
-    btnConfirm->setStyleSheet(
-                "QPushButton { background-color: #26C28D; color: white; font-size: 16px; border-radius: 22px; font-weight: bold; }"
-                "QPushButton:pressed { background-color: #1E946A; }"
-                );
+    BrandStyle::setButton(btnConfirm, BrandStyle::Look(QColor("#26C28D"), 22).pressed(QColor("#1E946A")), Qt::white, 16, true);
     connect(btnConfirm, SIGNAL(clicked()), this, SLOT(onConfirmClicked()));
 
     btnLayout->addWidget(btnCancel);
@@ -87,56 +76,33 @@ void PayWidget::initUI()
     mainLayout->addLayout(btnLayout);
 }
 
-void PayWidget::generateRandomQRCode()
+void PayWidget::showEvent(QShowEvent *event)
 {
-    QPixmap pix(200, 200);
-    pix.fill(Qt::white);
-
-    QPainter painter(&pix);
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(Qt::black);
-
-    int gridSize = 25;
-    int cellSize = 8;
-
-    for (int i = 0; i < gridSize; ++i) {
-        for (int j = 0; j < gridSize; ++j) {
-            if ((i < 7 && j < 7) || (i < 7 && j > 17) || (i > 17 && j < 7)) {
-                continue;
-            }
-            if (qrand() % 2 == 0) {
-                painter.drawRect(i * cellSize, j * cellSize, cellSize, cellSize);
-            }
-        }
-    }
-
-    auto drawFinderPattern = [&](int x, int y) {
-        painter.setBrush(Qt::black);
-        painter.drawRect(x, y, 7*cellSize, 7*cellSize);
-        painter.setBrush(Qt::white);
-        painter.drawRect(x + cellSize, y + cellSize, 5*cellSize, 5*cellSize);
-        painter.setBrush(Qt::black);
-        painter.drawRect(x + 2*cellSize, y + 2*cellSize, 3*cellSize, 3*cellSize);
-    };
+    QDialog::showEvent(event);
+    // 订单快照是 open() 之前才 setOrderData 进来的，所以在显示时生成
+    if (m_qrDirty) updateQRCode();
+}
 
-    drawFinderPattern(0, 0);
-    drawFinderPattern((gridSize - 7) * cellSize, 0);
-    drawFinderPattern(0, (gridSize - 7) * cellSize);
+void PayWidget::updateQRCode()
+{
+    // 二维码内容：订单号 + 金额，订单号就是落库和发给后厨的那个。同一份购物车反复进出支付页时直接用缓存的图
+    QByteArray payload = QString("canteen://pay?order=%1&amount=%2").arg(m_orderNo).arg(m_amount).toLatin1();
 
-    lblQRCode->setPixmap(pix);
+    QImage image = QrCode::cachedImage(QString::fromLatin1(payload), payload, lblQRCode->width() - 4);
+    lblQRCode->setPixmap(QPixmap::fromImage(image));
+    m_qrDirty = false;
 }
 
 void PayWidget::onConfirmClicked()
 {
-    HardwareControl::instance()->playSuccessSound();
-    HardwareControl::instance()->flashLedSuccess();
-
-    if (m_mqtt && !m_jsonOrder.isEmpty()) {
-        m_mqtt->publish("canteen/order/new", m_jsonOrder);
-        qDebug() << "MQTT Sending:" << m_jsonOrder;
-        QThread::msleep(50);
+    // 订单交给程序级的 OrderPublisher：先落库再发，连不上服务器时它自己补发，
+    // 对话框不用等 PUBACK，送达情况由 OrderPublisher 另行提示
+    if (m_jsonOrder.isEmpty()) {
+        qDebug() << "PayWidget: no order data, nothing to send";
+    } else {
+        OrderPublisher::instance()->submit(m_orderNo, m_jsonOrder);
     }
-
+    HardwareControl::instance()->signalSuccess();
     accept();
 }
 
@@ -5,7 +5,6 @@
 #include <QLabel>
 #include <QPushButton>
 #include "hardwarecontrol.h"
-#include "minimqtt.h"
 
 class PayWidget : public QDialog
 {
@@ -17,7 +16,10 @@ public:
 
 private:
     void initUI();
-    void generateRandomQRCode(); // 模拟生成随机二维码
+    void updateQRCode();        // 按订单号和金额生成支付二维码
+
+protected:
+    void showEvent(QShowEvent *event) override;
 
 private slots:
     void onConfirmClicked();
@@ -26,9 +28,12 @@ private slots:
 private:
     QLabel *lblAmount;
     QLabel *lblQRCode; // 用于显示二维码图片
+    QPushButton *btnConfirm;
+    QPushButton *btnCancel;
     int m_amount;
     QString m_jsonOrder; // 存储订单JSON字符串
-    MiniMqtt *m_mqtt;
+    QString m_orderNo;   // 订单 JSON 里的 order_no
+    bool m_qrDirty;      // 订单数据变了，下次显示时重新生成二维码
 };
 
 #endif // PAYWIDGET_H
@@ -0,0 +1,89 @@
+#include "playbackposition.h"
+#include <string.h>
+#include <stdlib.h>
+
+PlaybackPosition::PlaybackPosition()
+{
+    reset();
+}
+
+void PlaybackPosition::reset()
+{
+    m_reportedMs = 0;
+    m_durationMs = 0;
+    m_paused = false;
+    m_since.start();
+}
+
+void PlaybackPosition::report(qint64 ms)
+{
+    m_reportedMs = ms;
+    m_since.restart();
+}
+
+void PlaybackPosition::setPaused(bool paused)
+{
+    if (paused == m_paused) return;
+    m_reportedMs = positionMs(); // 暂停时冻结在当前外推值上，恢复时从这里继续
+    m_since.restart();
+    m_paused = paused;
+}
+
+qint64 PlaybackPosition::positionMs() const
+{
+    qint64 ms = m_reportedMs;
+    if (!m_paused) ms += qMin<qint64>(m_since.elapsed(), MAX_EXTRAPOLATE_MS);
+    if (m_durationMs > 0 && ms > m_durationMs) ms = m_durationMs;
+    return ms;
+}
+
+int PlaybackPosition::permille() const
+{
+    if (m_durationMs <= 0) return 0;
+    return (int)(positionMs() * 1000 / m_durationMs);
+}
+
+void MplayerOutputParser::feed(const char *data, int len)
+{
+    for (int i = 0; i < len; ++i) {
+        char c = data[i];
+        if (c == '\n' || c == '\r') {
+            if (m_len > 0) {
+                m_line[m_len] = '\0';
+                parseLine();
+            }
+            m_len = 0;
+        } else if (m_len < MAX_LINE) {
+            m_line[m_len++] = c;
+        }
+    }
+}
+
+// 秒 (小数) 转毫秒
+static qint64 secondsToMs(const char *text)
+{
+    return (qint64)(strtod(text, nullptr) * 1000.0 + 0.5);
+}
+
+#define STARTS_WITH(s, prefix) (strncmp((s), prefix, sizeof(prefix) - 1) == 0)
+
+void MplayerOutputParser::parseLine()
+{
+    const char *line = m_line;
+    while (*line == ' ') ++line;
+
+    // 状态行："A:   1.2 V:   1.2 A-V: ..." 或纯视频 "V:   1.2 ..."，纯音频只有 "A:"
+    // 有画面时以 V 为准 (第一个 "V:" 一定在 "A-V:" 前面)
+    if (STARTS_WITH(line, "A:") || STARTS_WITH(line, "V:")) {
+        const char *v = strstr(line, "V:");
+        m_handler(Status, secondsToMs((v ? v : line) + 2));
+    } else if (STARTS_WITH(line, "Starting playback")) {
+        m_handler(PlaybackStarted, 0);
+    } else if (STARTS_WITH(line, "ANS_LENGTH=")) {
+        const char *value = line + sizeof("ANS_LENGTH=") - 1;
+        if (*value == '\'' || *value == '"') ++value;
+        m_handler(Length, secondsToMs(value));
+    } else if (STARTS_WITH(line, "EOF code:")) {
+        m_handler(Eof, atoi(line + sizeof("EOF code:") - 1));
+    }
+}
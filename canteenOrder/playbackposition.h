@@ -0,0 +1,61 @@
+#ifndef PLAYBACKPOSITION_H
+#define PLAYBACKPOSITION_H
+
+#include <QElapsedTimer>
+#include <functional>
+
+// 播放位置模型
+// 播放器 (mplayer 状态行 / 进程内解码器) 把位置推进来，界面按显示帧率来取；
+// 两次上报之间按本地时钟外推，进度条走得平滑，不需要再向播放器发查询命令
+class PlaybackPosition
+{
+public:
+    PlaybackPosition();
+
+    void reset();
+    void setDuration(qint64 ms) { m_durationMs = ms; }
+    void report(qint64 ms);         // 播放器给出的当前位置
+    void setPaused(bool paused);
+
+    qint64 durationMs() const { return m_durationMs; }
+    qint64 positionMs() const;
+    int permille() const;           // 0..1000，时长未知时为 0
+
+    static const int MAX_EXTRAPOLATE_MS = 500; // 超过这么久没上报 (卡顿、缓冲) 就停在原地，不往前猜
+
+private:
+    QElapsedTimer m_since;          // 距上次上报
+    qint64 m_reportedMs;
+    qint64 m_durationMs;
+    bool m_paused;
+};
+
+// mplayer 输出解析
+// 数据按块喂进来，在固定缓冲里拼行 (状态行以 \r 结尾)，逐行用 C 字符串比较解析，不产生 QString
+class MplayerOutputParser
+{
+public:
+    enum Event {
+        Status,             // 状态行 "A: .. V: .."，value 为位置 ms
+        PlaybackStarted,    // "Starting playback..."
+        Length,             // ANS_LENGTH，value 为时长 ms
+        Eof                 // "EOF code: n"，value 为 n
+    };
+    typedef std::function<void(Event event, qint64 value)> Handler;
+
+    explicit MplayerOutputParser(const Handler &handler) : m_handler(handler), m_len(0) {}
+
+    void feed(const char *data, int len);
+    void reset() { m_len = 0; }
+
+    static const int MAX_LINE = 256; // 更长的行截断，我们关心的内容都在行首
+
+private:
+    void parseLine();
+
+    Handler m_handler;
+    char m_line[MAX_LINE + 1];
+    int m_len;
+};
+
+#endif // PLAYBACKPOSITION_H
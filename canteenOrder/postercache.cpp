@@ -0,0 +1,218 @@
+#include "postercache.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QProcess>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// 抽帧失败的视频隔这么久再试 (可能是还没拷完，或者临时没有 ffmpeg / mplayer)
+#define POSTER_RETRY_MS (5 * 60 * 1000)
+#define EXTRACT_POLL_MS 100     // 等子进程时隔这么久看一次是否要退出
+
+// 缓存文件名：<路径哈希>-<大小>-<修改时间>-<宽>x<高>.jpg
+static QString pathKey(const QString &path)
+{
+    return QString::number(qHash(QFileInfo(path).absoluteFilePath()), 16);
+}
+
+void PosterThread::enqueue(const QString &path, bool urgent)
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue.removeAll(path);
+    if (urgent) m_queue.prepend(path);
+    else m_queue.append(path);
+    m_cond.wakeOne();
+}
+
+void PosterThread::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stop = true;
+    m_cond.wakeOne();
+}
+
+bool PosterThread::stopping()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stop;
+}
+
+QString PosterThread::cacheFileFor(const QString &path) const
+{
+    QFileInfo info(path);
+    QString name = QString("%1-%2-%3-%4x%5.jpg").arg(pathKey(path)).arg(info.size())
+            .arg(info.lastModified().toMSecsSinceEpoch() / 1000)
+            .arg(thumbSize.width()).arg(thumbSize.height());
+    return QDir(cacheDir).filePath(name);
+}
+
+// 同一个视频的旧缓存 (视频被替换过，或缩略图尺寸变了) 删掉
+void PosterThread::pruneStale(const QString &path, const QString &keep)
+{
+    QDir dir(cacheDir);
+    QString keepName = QFileInfo(keep).fileName();
+    for (const QString &name : dir.entryList(QStringList() << pathKey(path) + "-*.jpg", QDir::Files)) {
+        if (name != keepName) dir.remove(name);
+    }
+}
+
+// 用外部工具抽一帧：优先 ffmpeg，没有就用 mplayer -vo jpeg
+// 在本线程里同步等待子进程，不影响界面
+QImage PosterThread::extract(const QString &path)
+{
+    QString tmpDir = QDir(cacheDir).filePath(".extract");
+    QDir(tmpDir).removeRecursively();
+    QDir().mkpath(tmpDir);
+    QString frameFile = QDir(tmpDir).filePath("00000001.jpg");
+    QString seek = QString::number(seekSeconds);
+
+    QProcess proc;
+    proc.setProcessChannelMode(QProcess::MergedChannels);
+    proc.start("ffmpeg", QStringList() << "-v" << "error" << "-ss" << seek << "-i" << path
+               << "-frames:v" << "1" << "-y" << frameFile);
+    if (!proc.waitForStarted(2000)) {
+        QString mplayer = QFile::exists("/workdir/mplayer") ? "/workdir/mplayer" : "mplayer";
+        proc.start(mplayer, QStringList() << "-really-quiet" << "-nosound" << "-ss" << seek << "-frames" << "1"
+                   << "-vo" << QString("jpeg:outdir=%1").arg(tmpDir) << path);
+        if (!proc.waitForStarted(2000)) {
+            qDebug() << "PosterThread: neither ffmpeg nor mplayer available";
+            return QImage();
+        }
+    }
+    // 分段等待，退出程序时不用等满 extractTimeoutMs
+    QElapsedTimer waited;
+    waited.start();
+    while (proc.state() != QProcess::NotRunning && !proc.waitForFinished(EXTRACT_POLL_MS)) {
+        if (stopping() || waited.elapsed() > extractTimeoutMs) {
+            proc.kill();
+            proc.waitForFinished(1000);
+            break;
+        }
+    }
+
+    QImage frame(frameFile);
+    QDir(tmpDir).removeRecursively();
+    if (frame.isNull()) return QImage();
+    // 保持宽高比缩到缩略图大小，并转成界面直接能画的格式
+    return frame.scaled(thumbSize, Qt::KeepAspectRatio, Qt::SmoothTransformation)
+            .convertToFormat(QImage::Format_RGB32);
+}
+
+void PosterThread::run()
+{
+    QDir().mkpath(cacheDir);
+    forever {
+        QString path;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_stop) m_cond.wait(&m_mutex);
+            if (m_stop) return;
+            path = m_queue.takeFirst();
+        }
+        if (!QFile::exists(path)) {
+            emit posterFailed(path);
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        QString cacheFile = cacheFileFor(path);
+        QImage poster(cacheFile);
+        bool fromCache = !poster.isNull();
+        if (!fromCache) {
+            poster = extract(path);
+            if (poster.isNull()) {
+                qDebug() << "PosterThread: no poster for" << path;
+                emit posterFailed(path);
+                continue;
+            }
+            // 先写临时文件再改名，断电也不会留下半张图
+            QString tmp = cacheFile + ".part";
+            if (poster.save(tmp, "JPG", 85) && QFile::rename(tmp, cacheFile)) {
+                pruneStale(path, cacheFile);
+            } else {
+                QFile::remove(tmp);
+            }
+        }
+        emit posterReady(path, poster, fromCache, timer.elapsed());
+    }
+}
+
+// --- 管理 ---
+PosterCache* PosterCache::m_instance = nullptr;
+
+PosterCache* PosterCache::instance()
+{
+    if (m_instance == nullptr) {
+        m_instance = new PosterCache();
+    }
+    return m_instance;
+}
+
+PosterCache::PosterCache(QObject *parent) : QObject(parent)
+{
+    m_thread = new PosterThread();
+    m_thread->cacheDir = POSTER_CACHE_DIR;
+    connect(m_thread, &PosterThread::posterReady, this, &PosterCache::onPosterReady);
+    connect(m_thread, &PosterThread::posterFailed, this, &PosterCache::onPosterFailed);
+    // 解码抽帧很吃 CPU，让给界面
+    m_thread->start(QThread::LowestPriority);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &PosterCache::onAboutToQuit);
+}
+
+// 退出前停下线程并等它结束，不能让 QThread 在运行中随进程析构
+void PosterCache::onAboutToQuit()
+{
+    m_thread->stop();
+    m_thread->wait();
+}
+
+// 还没有图、没在排队、也不在失败冷却期内
+bool PosterCache::shouldRequest(const QString &path) const
+{
+    if (m_images.contains(path) || m_pending.contains(path)) return false;
+    QHash<QString, qint64>::const_iterator failed = m_failedAt.constFind(path);
+    return failed == m_failedAt.constEnd()
+            || QDateTime::currentMSecsSinceEpoch() - failed.value() >= POSTER_RETRY_MS;
+}
+
+QImage PosterCache::poster(const QString &path)
+{
+    QHash<QString, QImage>::const_iterator it = m_images.constFind(path);
+    if (it != m_images.constEnd()) return it.value();
+    if (shouldRequest(path)) {
+        m_pending.insert(path);
+        m_thread->enqueue(path, true);
+    }
+    return QImage();
+}
+
+void PosterCache::prefetchDir(const QString &dir)
+{
+    QStringList filters;
+    filters << "*.mp4" << "*.avi" << "*.mkv" << "*.mov" << "*.flv";
+    for (const QFileInfo &info : QDir(dir).entryInfoList(filters, QDir::Files, QDir::Name)) {
+        QString path = info.filePath();
+        if (!shouldRequest(path)) continue;
+        m_pending.insert(path);
+        m_thread->enqueue(path, false);
+    }
+}
+
+void PosterCache::onPosterReady(const QString &path, const QImage &poster, bool fromCache, qint64 elapsedMs)
+{
+    qDebug() << "[Poster]" << QFileInfo(path).fileName() << (fromCache ? "cache hit" : "extracted") << elapsedMs << "ms";
+    m_pending.remove(path);
+    m_failedAt.remove(path);
+    m_images.insert(path, poster);
+    emit posterReady(path, poster);
+}
+
+void PosterCache::onPosterFailed(const QString &path)
+{
+    m_pending.remove(path);
+    m_failedAt.insert(path, QDateTime::currentMSecsSinceEpoch());
+}
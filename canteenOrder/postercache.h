@@ -0,0 +1,78 @@
+#ifndef POSTERCACHE_H
+#define POSTERCACHE_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QImage>
+#include <QSize>
+
+// 海报帧提取线程：每个视频取一帧缩成缩略图，存到磁盘缓存
+// 缓存文件名带上视频的大小和修改时间，视频换了就自然失效；命中缓存时只读一张小 JPEG
+class PosterThread : public QThread
+{
+    Q_OBJECT
+public:
+    QString cacheDir;
+    QSize thumbSize = QSize(112, 63);  // 16:9，放得进 100px 高的列表行
+    int seekSeconds = 1;         // 跳过片头黑场
+    int extractTimeoutMs = 15000;
+
+    void enqueue(const QString &path, bool urgent); // urgent 插到队首 (用户正看着的行)
+    void stop();                                    // 正在抽帧时会杀掉子进程，调用后 wait() 很快返回
+
+protected:
+    void run() override;
+
+signals:
+    void posterReady(const QString &path, const QImage &poster, bool fromCache, qint64 elapsedMs);
+    void posterFailed(const QString &path);         // 文件不存在或抽帧失败
+
+private:
+    bool stopping();
+    QString cacheFileFor(const QString &path) const;
+    QImage extract(const QString &path);
+    void pruneStale(const QString &path, const QString &keep);
+
+    QMutex m_mutex;
+    QWaitCondition m_cond;
+    QStringList m_queue;
+    bool m_stop = false;
+};
+
+// 海报缓存：界面只跟它打交道
+// poster() 命中内存直接返回，否则排队给后台线程，做好后发 posterReady
+class PosterCache : public QObject
+{
+    Q_OBJECT
+public:
+    static PosterCache* instance();
+
+    QImage poster(const QString &path);      // 可能为空，稍后收到 posterReady
+    void prefetchDir(const QString &dir);    // 后台把目录下的视频都做一遍
+    QSize thumbSize() const { return m_thread->thumbSize; }
+
+signals:
+    void posterReady(const QString &path, const QImage &poster);
+
+private slots:
+    void onPosterReady(const QString &path, const QImage &poster, bool fromCache, qint64 elapsedMs);
+    void onPosterFailed(const QString &path);
+    void onAboutToQuit();
+
+private:
+    explicit PosterCache(QObject *parent = nullptr);
+    bool shouldRequest(const QString &path) const;
+    static PosterCache* m_instance;
+
+    PosterThread *m_thread;
+    QHash<QString, QImage> m_images;
+    QSet<QString> m_pending;        // 已交给线程、还没做好的
+    QHash<QString, qint64> m_failedAt;  // 抽帧失败的时间 (ms since epoch)，过了 POSTER_RETRY_MS 才重试
+};
+
+#endif // POSTERCACHE_H
@@ -0,0 +1,498 @@
+#include "qrcode.h"
+#include <QHash>
+#include <QList>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <cstdlib>
+#include <cstring>
+
+#define QR_CACHE_MAX 8      // 支付页同时只会用到一两张，留几张给反复进出结算页的情况
+
+// 每个纠错块的纠错码字数、纠错块个数，按 [纠错等级][版本] 查 (标准表 9)，下标 0 不用
+static const signed char ECC_CODEWORDS_PER_BLOCK[4][41] = {
+    {-1,  7, 10, 15, 20, 26, 18, 20, 24, 30, 18, 20, 24, 26, 30, 22, 24, 28, 30, 28, 28, 28, 28, 30, 30, 26, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 10, 16, 26, 18, 24, 16, 18, 22, 22, 26, 30, 22, 22, 24, 24, 28, 28, 26, 26, 26, 26, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28},
+    {-1, 13, 22, 18, 26, 18, 24, 18, 22, 20, 24, 28, 26, 24, 20, 30, 24, 28, 28, 26, 30, 28, 30, 30, 30, 30, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 17, 28, 22, 16, 22, 28, 26, 26, 24, 28, 24, 28, 22, 24, 24, 30, 28, 28, 26, 28, 30, 24, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+};
+static const signed char NUM_ERROR_CORRECTION_BLOCKS[4][41] = {
+    {-1, 1, 1, 1, 1, 1, 2, 2, 2, 2,  4,  4,  4,  4,  4,  6,  6,  6,  6,  7,  8,  8,  9,  9, 10, 12, 12, 12, 13, 14, 15, 16, 17, 18, 19, 19, 20, 21, 22, 24, 25},
+    {-1, 1, 1, 1, 2, 2, 4, 4, 4, 5,  5,  5,  8,  9,  9, 10, 10, 11, 13, 14, 16, 17, 17, 18, 20, 21, 23, 25, 26, 28, 29, 31, 33, 35, 37, 38, 40, 43, 45, 47, 49},
+    {-1, 1, 1, 2, 2, 4, 4, 6, 6, 8,  8,  8, 10, 12, 16, 12, 17, 16, 18, 21, 20, 23, 23, 25, 27, 29, 34, 34, 35, 38, 40, 43, 45, 48, 51, 53, 56, 59, 62, 65, 68},
+    {-1, 1, 1, 2, 4, 4, 4, 5, 6, 8,  8, 11, 11, 16, 16, 18, 16, 19, 21, 25, 25, 25, 34, 30, 32, 35, 37, 40, 42, 45, 48, 51, 54, 57, 60, 63, 66, 70, 74, 77, 81},
+};
+// 格式信息里的纠错等级编码 (L=01 M=00 Q=11 H=10)
+static const int ECC_FORMAT_BITS[4] = {1, 0, 3, 2};
+
+// 掩码评分的罚分权重 (标准 7.8.3)
+static const int PENALTY_N1 = 3;
+static const int PENALTY_N2 = 3;
+static const int PENALTY_N3 = 40;
+static const int PENALTY_N4 = 10;
+
+// ================== Reed-Solomon (GF(256)，本原多项式 0x11D) ==================
+
+static quint8 gfMultiply(quint8 x, quint8 y)
+{
+    int z = 0;
+    for (int i = 7; i >= 0; --i) {
+        z = (z << 1) ^ ((z >> 7) * 0x11D);
+        z ^= ((y >> i) & 1) * x;
+    }
+    return (quint8)z;
+}
+
+static QByteArray rsDivisor(int degree)
+{
+    QByteArray result(degree, 0);
+    result[degree - 1] = 1;
+    quint8 root = 1;
+    for (int i = 0; i < degree; ++i) {
+        for (int j = 0; j < degree; ++j) {
+            result[j] = gfMultiply((quint8)result[j], root);
+            if (j + 1 < degree) result[j] = result[j] ^ result[j + 1];
+        }
+        root = gfMultiply(root, 0x02);
+    }
+    return result;
+}
+
+static QByteArray rsRemainder(const QByteArray &data, const QByteArray &divisor)
+{
+    int degree = divisor.size();
+    QByteArray result(degree, 0);
+    for (int n = 0; n < data.size(); ++n) {
+        quint8 factor = (quint8)data[n] ^ (quint8)result[0];
+        memmove(result.data(), result.constData() + 1, degree - 1);
+        result[degree - 1] = 0;
+        for (int i = 0; i < degree; ++i) {
+            result[i] = result[i] ^ gfMultiply((quint8)divisor[i], factor);
+        }
+    }
+    return result;
+}
+
+// ================== 编码 ==================
+
+QrCode::QrCode() : m_version(0), m_size(0), m_ecc(EccMedium), m_mask(0)
+{
+}
+
+int QrCode::rawDataModules(int version)
+{
+    // 除去功能图形后能放码字的模块数 (含剩余位)
+    int result = (16 * version + 128) * version + 64;
+    if (version >= 2) {
+        int numAlign = version / 7 + 2;
+        result -= (25 * numAlign - 10) * numAlign - 55;
+        if (version >= 7) result -= 36;
+    }
+    return result;
+}
+
+int QrCode::dataCodewords(int version, Ecc ecc)
+{
+    return rawDataModules(version) / 8
+            - ECC_CODEWORDS_PER_BLOCK[ecc][version] * NUM_ERROR_CORRECTION_BLOCKS[ecc][version];
+}
+
+QrCode QrCode::encode(const QByteArray &data, Ecc ecc, bool boostEcc)
+{
+    // 1. 选版本：模式 4 位 + 长度 (版本 1-9 为 8 位，10 以上 16 位) + 数据
+    int version = 0;
+    int dataBits = 0;
+    for (int v = 1; v <= 40; ++v) {
+        int bits = 4 + (v < 10 ? 8 : 16) + data.size() * 8;
+        if (bits <= dataCodewords(v, ecc) * 8) {
+            version = v;
+            dataBits = bits;
+            break;
+        }
+    }
+    if (version == 0) {
+        qDebug() << "[QR] data too long:" << data.size() << "bytes";
+        return QrCode();
+    }
+    if (boostEcc) {
+        for (int e = ecc + 1; e <= EccHigh; ++e) {
+            if (dataBits <= dataCodewords(version, (Ecc)e) * 8) ecc = (Ecc)e;
+        }
+    }
+
+    // 2. 拼位流
+    int capacity = dataCodewords(version, ecc);
+    QByteArray codewords(capacity, 0);
+    int bitPos = 0;
+    auto appendBits = [&](quint32 value, int count) {
+        for (int i = count - 1; i >= 0; --i, ++bitPos) {
+            if ((value >> i) & 1) codewords[bitPos >> 3] = codewords[bitPos >> 3] | (char)(0x80 >> (bitPos & 7));
+        }
+    };
+    appendBits(0x4, 4);                                 // 字节模式
+    appendBits(data.size(), version < 10 ? 8 : 16);
+    for (int i = 0; i < data.size(); ++i) appendBits((quint8)data[i], 8);
+
+    // 终止符最多 4 个 0，补齐到字节 (缓冲区本来就是 0，只需移动位置)，剩下的交替填 0xEC 0x11
+    bitPos += qMin(4, capacity * 8 - bitPos);
+    bitPos = (bitPos + 7) / 8 * 8;
+    for (int i = bitPos / 8, pad = 0; i < capacity; ++i, pad ^= 1) {
+        codewords[i] = pad ? (char)0x11 : (char)0xEC;
+    }
+
+    return QrCode(version, ecc, codewords);
+}
+
+QrCode::QrCode(int version, Ecc ecc, const QByteArray &dataCodewords)
+    : m_version(version), m_size(version * 4 + 17), m_ecc(ecc), m_mask(0)
+{
+    m_modules.fill(0, m_size * m_size);
+    m_isFunction.fill(0, m_size * m_size);
+
+    drawFunctionPatterns();
+    drawCodewords(addEccAndInterleave(dataCodewords));
+
+    // 8 种掩码都试一遍，取罚分最低的
+    int best = 0;
+    int bestPenalty = -1;
+    for (int mask = 0; mask < 8; ++mask) {
+        applyMask(mask);
+        drawFormatBits(mask);
+        int p = penalty();
+        if (bestPenalty < 0 || p < bestPenalty) {
+            best = mask;
+            bestPenalty = p;
+        }
+        applyMask(mask);    // 异或两次还原
+    }
+    m_mask = best;
+    applyMask(best);
+    drawFormatBits(best);
+    m_isFunction.clear();
+}
+
+QByteArray QrCode::addEccAndInterleave(const QByteArray &data) const
+{
+    int numBlocks = NUM_ERROR_CORRECTION_BLOCKS[m_ecc][m_version];
+    int blockEccLen = ECC_CODEWORDS_PER_BLOCK[m_ecc][m_version];
+    int rawCodewords = rawDataModules(m_version) / 8;
+    int numShortBlocks = numBlocks - rawCodewords % numBlocks;
+    int shortBlockLen = rawCodewords / numBlocks;
+
+    // 前 numShortBlocks 块的数据少一个码字，先补一个占位，交织时跳过
+    QByteArray divisor = rsDivisor(blockEccLen);
+    QList<QByteArray> blocks;
+    for (int i = 0, k = 0; i < numBlocks; ++i) {
+        int len = shortBlockLen - blockEccLen + (i < numShortBlocks ? 0 : 1);
+        QByteArray block = data.mid(k, len);
+        k += len;
+        QByteArray ecc = rsRemainder(block, divisor);
+        if (i < numShortBlocks) block.append((char)0);
+        block.append(ecc);
+        blocks.append(block);
+    }
+
+    QByteArray result;
+    result.reserve(rawCodewords);
+    for (int i = 0; i < blocks.first().size(); ++i) {
+        for (int j = 0; j < blocks.size(); ++j) {
+            if (i != shortBlockLen - blockEccLen || j >= numShortBlocks) result.append(blocks[j][i]);
+        }
+    }
+    return result;
+}
+
+// ================== 画功能图形 ==================
+
+void QrCode::setFunction(int x, int y, bool dark)
+{
+    m_modules[y * m_size + x] = dark ? 1 : 0;
+    m_isFunction[y * m_size + x] = 1;
+}
+
+QVector<int> QrCode::alignmentPositions() const
+{
+    QVector<int> result;
+    if (m_version == 1) return result;
+    int numAlign = m_version / 7 + 2;
+    int step = (m_version * 8 + numAlign * 3 + 5) / (numAlign * 4 - 4) * 2;
+    result.resize(numAlign);
+    result[0] = 6;
+    for (int i = numAlign - 1, pos = m_size - 7; i >= 1; --i, pos -= step) result[i] = pos;
+    return result;
+}
+
+void QrCode::drawFunctionPatterns()
+{
+    // 时序线
+    for (int i = 0; i < m_size; ++i) {
+        setFunction(6, i, i % 2 == 0);
+        setFunction(i, 6, i % 2 == 0);
+    }
+
+    // 三个定位图形 (含白色分隔带)
+    drawFinder(3, 3);
+    drawFinder(m_size - 4, 3);
+    drawFinder(3, m_size - 4);
+
+    // 校正图形，和定位图形重叠的三个角不画
+    QVector<int> pos = alignmentPositions();
+    int n = pos.size();
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            if ((i == 0 && j == 0) || (i == 0 && j == n - 1) || (i == n - 1 && j == 0)) continue;
+            drawAlignment(pos[i], pos[j]);
+        }
+    }
+
+    // 先占住格式和版本信息的位置，选好掩码后再写
+    drawFormatBits(0);
+    drawVersion();
+}
+
+void QrCode::drawFinder(int x, int y)
+{
+    for (int dy = -4; dy <= 4; ++dy) {
+        for (int dx = -4; dx <= 4; ++dx) {
+            int dist = qMax(std::abs(dx), std::abs(dy));
+            int xx = x + dx, yy = y + dy;
+            if (xx >= 0 && xx < m_size && yy >= 0 && yy < m_size) {
+                setFunction(xx, yy, dist != 2 && dist != 4);
+            }
+        }
+    }
+}
+
+void QrCode::drawAlignment(int x, int y)
+{
+    for (int dy = -2; dy <= 2; ++dy) {
+        for (int dx = -2; dx <= 2; ++dx) {
+            setFunction(x + dx, y + dy, qMax(std::abs(dx), std::abs(dy)) != 1);
+        }
+    }
+}
+
+void QrCode::drawFormatBits(int mask)
+{
+    // 5 位数据 + 10 位 BCH 校验，再和 0x5412 异或
+    int data = ECC_FORMAT_BITS[m_ecc] << 3 | mask;
+    int rem = data;
+    for (int i = 0; i < 10; ++i) rem = (rem << 1) ^ ((rem >> 9) * 0x537);
+    int bits = (data << 10 | rem) ^ 0x5412;
+    auto bit = [bits](int i) { return ((bits >> i) & 1) != 0; };
+
+    // 第一份：左上定位图形周围
+    for (int i = 0; i <= 5; ++i) setFunction(8, i, bit(i));
+    setFunction(8, 7, bit(6));
+    setFunction(8, 8, bit(7));
+    setFunction(7, 8, bit(8));
+    for (int i = 9; i < 15; ++i) setFunction(14 - i, 8, bit(i));
+
+    // 第二份：分在右上和左下
+    for (int i = 0; i < 8; ++i) setFunction(m_size - 1 - i, 8, bit(i));
+    for (int i = 8; i < 15; ++i) setFunction(8, m_size - 15 + i, bit(i));
+    setFunction(8, m_size - 8, true);   // 固定的深色模块
+}
+
+void QrCode::drawVersion()
+{
+    if (m_version < 7) return;
+
+    // 6 位版本号 + 12 位 BCH 校验，两份
+    int rem = m_version;
+    for (int i = 0; i < 12; ++i) rem = (rem << 1) ^ ((rem >> 11) * 0x1F25);
+    int bits = m_version << 12 | rem;
+    for (int i = 0; i < 18; ++i) {
+        bool dark = ((bits >> i) & 1) != 0;
+        int a = m_size - 11 + i % 3;
+        int b = i / 3;
+        setFunction(a, b, dark);
+        setFunction(b, a, dark);
+    }
+}
+
+void QrCode::drawCodewords(const QByteArray &codewords)
+{
+    // 从右下角开始，两列一组上下蛇形排，跳过第 6 列的竖时序线
+    int i = 0;
+    int totalBits = codewords.size() * 8;
+    for (int right = m_size - 1; right >= 1; right -= 2) {
+        if (right == 6) right = 5;
+        for (int vert = 0; vert < m_size; ++vert) {
+            for (int j = 0; j < 2; ++j) {
+                int x = right - j;
+                bool upward = ((right + 1) & 2) == 0;
+                int y = upward ? m_size - 1 - vert : vert;
+                int idx = y * m_size + x;
+                if (!m_isFunction[idx] && i < totalBits) {
+                    m_modules[idx] = ((quint8)codewords[i >> 3] >> (7 - (i & 7))) & 1;
+                    ++i;
+                }
+                // 剩余位保持浅色 (加掩码后可能变深)
+            }
+        }
+    }
+}
+
+void QrCode::applyMask(int mask)
+{
+    for (int y = 0; y < m_size; ++y) {
+        for (int x = 0; x < m_size; ++x) {
+            bool invert;
+            switch (mask) {
+            case 0:  invert = (x + y) % 2 == 0; break;
+            case 1:  invert = y % 2 == 0; break;
+            case 2:  invert = x % 3 == 0; break;
+            case 3:  invert = (x + y) % 3 == 0; break;
+            case 4:  invert = (x / 3 + y / 2) % 2 == 0; break;
+            case 5:  invert = x * y % 2 + x * y % 3 == 0; break;
+            case 6:  invert = (x * y % 2 + x * y % 3) % 2 == 0; break;
+            default: invert = ((x + y) % 2 + x * y % 3) % 2 == 0; break;
+            }
+            int idx = y * m_size + x;
+            if (invert && !m_isFunction[idx]) m_modules[idx] ^= 1;
+        }
+    }
+}
+
+// 一行 (或一列) 的罚分：连续同色、类定位图形
+static int linePenalty(const quint8 *line, int size, int stride)
+{
+    int result = 0;
+
+    int run = 1;
+    for (int i = 1; i <= size; ++i) {
+        if (i < size && line[i * stride] == line[(i - 1) * stride]) {
+            ++run;
+            continue;
+        }
+        if (run >= 5) result += PENALTY_N1 + (run - 5);
+        run = 1;
+    }
+
+    // 1:1:3:1:1 的深浅比例，一侧带 4 个浅色模块 (10111010000 / 00001011101)，超出边界按浅色算
+    static const quint8 PATTERN[11] = {1, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0};
+    for (int start = -4; start <= size - 7; ++start) {
+        bool forward = true, backward = true;
+        for (int k = 0; k < 11 && (forward || backward); ++k) {
+            int p = start + k;
+            quint8 v = (p >= 0 && p < size) ? line[p * stride] : 0;
+            if (v != PATTERN[k]) forward = false;
+            if (v != PATTERN[10 - k]) backward = false;
+        }
+        if (forward) result += PENALTY_N3;
+        if (backward) result += PENALTY_N3;
+    }
+    return result;
+}
+
+int QrCode::penalty() const
+{
+    int result = 0;
+    const quint8 *m = m_modules.constData();
+
+    for (int i = 0; i < m_size; ++i) {
+        result += linePenalty(m + i * m_size, m_size, 1);   // 行
+        result += linePenalty(m + i, m_size, m_size);       // 列
+    }
+
+    // 2×2 同色块
+    for (int y = 0; y < m_size - 1; ++y) {
+        for (int x = 0; x < m_size - 1; ++x) {
+            quint8 c = m[y * m_size + x];
+            if (c == m[y * m_size + x + 1] && c == m[(y + 1) * m_size + x] && c == m[(y + 1) * m_size + x + 1]) {
+                result += PENALTY_N2;
+            }
+        }
+    }
+
+    // 深浅比例偏离 50% 每 5% 罚一次
+    int dark = 0;
+    for (int i = 0; i < m_modules.size(); ++i) dark += m[i];
+    int total = m_size * m_size;
+    int k = (std::abs(dark * 20 - total * 10) + total - 1) / total - 1;
+    result += k * PENALTY_N4;
+    return result;
+}
+
+// ================== 渲染 ==================
+
+QImage QrCode::toImage(int maxPixels, int border) const
+{
+    if (isNull()) return QImage();
+
+    int modules = m_size + 2 * border;
+    int scale = qMax(1, maxPixels / modules);
+    int dim = modules * scale;
+
+    QImage image(dim, dim, QImage::Format_Mono);
+    image.setColorTable(QVector<QRgb>() << qRgb(255, 255, 255) << qRgb(0, 0, 0));
+    image.fill(0);
+
+    // 每个模块行只拼一条扫描线 (MSB 在左)，其余 scale-1 行整行拷贝
+    int bytesPerLine = image.bytesPerLine();
+    for (int y = 0; y < m_size; ++y) {
+        uchar *line = image.scanLine((y + border) * scale);
+        const quint8 *row = m_modules.constData() + y * m_size;
+        for (int x = 0; x < m_size; ++x) {
+            if (!row[x]) continue;
+            int px = (x + border) * scale;
+            for (int s = 0; s < scale; ++s, ++px) line[px >> 3] |= 0x80 >> (px & 7);
+        }
+        for (int s = 1; s < scale; ++s) {
+            memcpy(image.scanLine((y + border) * scale + s), line, bytesPerLine);
+        }
+    }
+    return image;
+}
+
+// ================== 缓存 ==================
+
+QImage QrCode::cachedImage(const QString &key, const QByteArray &data, int maxPixels, Ecc ecc)
+{
+    static QHash<QString, QImage> cache;
+    static QList<QString> order;    // 最近使用的在后
+
+    QString fullKey = key + QLatin1Char('@') + QString::number(maxPixels);
+    if (cache.contains(fullKey)) {
+        order.removeOne(fullKey);
+        order.append(fullKey);
+        return cache.value(fullKey);
+    }
+
+    QImage image = encode(data, ecc).toImage(maxPixels);
+    cache.insert(fullKey, image);
+    order.append(fullKey);
+    while (order.size() > QR_CACHE_MAX) cache.remove(order.takeFirst());
+    return image;
+}
+
+// ================== 性能测试 ==================
+
+void QrCode::runBenchmark(int rounds)
+{
+    // 和支付页一样的内容长度：订单摘要 + 金额
+    QByteArray payload = "canteen://pay?order=3f9a1c7e2b40&amount=128";
+
+    QElapsedTimer timer;
+    timer.start();
+    QrCode code;
+    for (int i = 0; i < rounds; ++i) code = encode(payload, EccMedium);
+    qint64 encodeNs = timer.nsecsElapsed();
+
+    timer.restart();
+    QImage image;
+    for (int i = 0; i < rounds; ++i) image = code.toImage(200);
+    qint64 renderNs = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < rounds; ++i) image = cachedImage("bench", payload, 200);
+    qint64 cachedNs = timer.nsecsElapsed();
+
+    qDebug().noquote() << QString("[QR] version %1, ecc %2, mask %3, %4x%4 modules -> %5x%5 px")
+                          .arg(code.version()).arg("LMQH"[code.ecc()]).arg(code.mask())
+                          .arg(code.size()).arg(image.width());
+    qDebug().noquote() << QString("[QR] encode %1 us, render %2 us, cached %3 us (avg of %4)")
+                          .arg(encodeNs / 1e3 / rounds, 0, 'f', 1)
+                          .arg(renderNs / 1e3 / rounds, 0, 'f', 1)
+                          .arg(cachedNs / 1e3 / rounds, 0, 'f', 2).arg(rounds);
+}
@@ -0,0 +1,64 @@
+#ifndef QRCODE_H
+#define QRCODE_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QImage>
+#include <QString>
+
+// QR 码编码器 (ISO/IEC 18004，字节模式，版本 1-40，纠错等级 L/M/Q/H，自动选掩码)
+// 原来支付页画的是随机格子，扫不出来，每次打开还要重画 625 个 drawRect。
+// 这里编出真正的模块矩阵，再按行直接写进 1 位深的 QImage；同一个订单快照的图缓存起来重复用
+class QrCode
+{
+public:
+    enum Ecc { EccLow = 0, EccMedium, EccQuartile, EccHigh };  // 约可恢复 7% / 15% / 25% / 30%
+
+    // 选能装下数据的最小版本；boostEcc 为 true 时版本不变的前提下尽量提高纠错等级
+    // 数据太长 (超过版本 40) 返回 isNull() 的对象
+    static QrCode encode(const QByteArray &data, Ecc ecc = EccMedium, bool boostEcc = true);
+
+    // 编码并渲染，按 key 缓存 (只在 GUI 线程用)。key 一般是订单快照的摘要
+    static QImage cachedImage(const QString &key, const QByteArray &data, int maxPixels, Ecc ecc = EccMedium);
+
+    // 性能测试：编码 + 渲染到支付页的 200px 尺寸 (启动参数 --bench-qr)
+    static void runBenchmark(int rounds = 200);
+
+    QrCode();
+    bool isNull() const { return m_version == 0; }
+    int version() const { return m_version; }
+    int size() const { return m_size; }
+    int mask() const { return m_mask; }
+    Ecc ecc() const { return m_ecc; }
+    bool module(int x, int y) const { return m_modules[y * m_size + x] != 0; }
+
+    // 渲染成 Format_Mono：每个模块 scale×scale 像素，scale 取能放进 maxPixels 的最大整数，四周留 border 个模块的白边
+    QImage toImage(int maxPixels, int border = 4) const;
+
+private:
+    QrCode(int version, Ecc ecc, const QByteArray &dataCodewords);
+
+    void setFunction(int x, int y, bool dark);
+    void drawFunctionPatterns();
+    void drawFinder(int x, int y);
+    void drawAlignment(int x, int y);
+    void drawFormatBits(int mask);
+    void drawVersion();
+    void drawCodewords(const QByteArray &codewords);
+    void applyMask(int mask);
+    int penalty() const;
+    QByteArray addEccAndInterleave(const QByteArray &data) const;
+    QVector<int> alignmentPositions() const;
+
+    static int rawDataModules(int version);
+    static int dataCodewords(int version, Ecc ecc);
+
+    int m_version;
+    int m_size;
+    Ecc m_ecc;
+    int m_mask;
+    QVector<quint8> m_modules;      // 1 = 深色，行优先
+    QVector<quint8> m_isFunction;   // 定位、时序、格式等功能图形，不放数据也不加掩码
+};
+
+#endif // QRCODE_H
@@ -1,6 +1,6 @@
 #include "register.h"
 #include "dbmanager.h"
-#include <QMessageBox>
+#include "toastmanager.h"
 
 Register::Register(QWidget *parent) : QWidget(parent)
 {
@@ -41,6 +41,7 @@ Register::Register(QWidget *parent) : QWidget(parent)
 
     connect(btnRegister, SIGNAL(clicked()), this, SLOT(onRegisterClicked()));
     connect(btnCancel, SIGNAL(clicked()), this, SIGNAL(goBackToLogin()));
+    connect(&DBManager::instance(), &DBManager::registerFinished, this, &Register::onRegisterFinished);
 
     userEdit->installEventFilter(SoftKeyboard::instance());
     passEdit->installEventFilter(SoftKeyboard::instance());
@@ -61,7 +62,7 @@ void Register::onRegisterClicked()
     QString confirm = confirmPassEdit->text();
 
     if(name.isEmpty() || pass.isEmpty()){
-        QMessageBox::warning(this, "提示", "用户名或密码不能为空");
+        ToastManager::instance()->show("用户名或密码不能为空", ToastManager::Warning);
         userEdit->clear();
         passEdit->clear();
         confirmPassEdit->clear();
@@ -69,21 +70,41 @@ void Register::onRegisterClicked()
     }
 
     if(pass != confirm){
-        QMessageBox::warning(this, "提示", "两次输入的密码不一致");
+        ToastManager::instance()->show("两次输入的密码不一致", ToastManager::Warning);
         clearEdit();
         return;
     }
 
     SoftKeyboard::instance()->hide();
 
-    // 调用数据库保存
-    if(DBManager::instance().registerUser(name, pass)){
-        QMessageBox::information(this, "成功", "注册成功！");
+    // 调用数据库保存 (口令哈希在后台计算，结果在 onRegisterFinished 中处理)
+    setBusy(true);
+    DBManager::instance().registerUserAsync(name, pass);
+}
+
+void Register::onRegisterFinished(const QString &username, bool ok)
+{
+    Q_UNUSED(username);
+    setBusy(false);
+
+    if(ok){
+        ToastManager::instance()->show("注册成功！");
         clearEdit();
 
         emit goBackToLogin();
     } else {
-        QMessageBox::warning(this, "失败", "注册失败，用户名可能已存在");
+        ToastManager::instance()->show("注册失败，用户名可能已存在", ToastManager::Warning);
         clearEdit();
     }
 }
+
+// 计算口令哈希期间锁住输入，防止重复提交
+void Register::setBusy(bool busy)
+{
+    btnRegister->setEnabled(!busy);
+    btnCancel->setEnabled(!busy);
+    userEdit->setEnabled(!busy);
+    passEdit->setEnabled(!busy);
+    confirmPassEdit->setEnabled(!busy);
+    btnRegister->setText(busy ? "注册中..." : "确认注册");
+}
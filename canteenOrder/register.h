@@ -21,8 +21,11 @@ signals:
 private slots:
     void onRegisterClicked();
     void clearEdit();
+    void onRegisterFinished(const QString &username, bool ok);
 
 private:
+    void setBusy(bool busy);
+
     QLineEdit *userEdit;
     QLineEdit *passEdit;
     QLineEdit *confirmPassEdit;
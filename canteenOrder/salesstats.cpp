@@ -0,0 +1,202 @@
+#include "salesstats.h"
+#include "dbmanager.h"
+#include <QDate>
+#include <QSysInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTime>
+#include <QDateTime>
+#include <QTimer>
+#include <QDebug>
+
+SalesStats* SalesStats::m_instance = nullptr;
+
+SalesStats* SalesStats::instance()
+{
+    if (m_instance == nullptr) {
+        m_instance = new SalesStats();
+        m_instance->load();
+    }
+    return m_instance;
+}
+
+SalesStats::SalesStats(QObject *parent) : QObject(parent)
+{
+    qsrand(QTime::currentTime().msec());
+    m_kioskId = QSysInfo::machineHostName() + "_" + QString::number(qrand() % 10000);
+    m_windowStart = today() - WINDOW_DAYS + 1;
+
+    // 过零点时主动滚动窗口并通知，不等下一次读取
+    m_dayTimer = new QTimer(this);
+    m_dayTimer->setSingleShot(true);
+    connect(m_dayTimer, SIGNAL(timeout()), this, SLOT(onDayChanged()));
+    scheduleDayChange();
+}
+
+void SalesStats::scheduleDayChange()
+{
+    QDateTime now = QDateTime::currentDateTime();
+    QDateTime midnight(now.date().addDays(1), QTime(0, 0, 1));
+    m_dayTimer->start((int)qMax<qint64>(1000, now.msecsTo(midnight)));
+}
+
+void SalesStats::onDayChanged()
+{
+    rollWindow();
+    scheduleDayChange();
+}
+
+int SalesStats::today()
+{
+    return (int)QDate::currentDate().toJulianDay();
+}
+
+void SalesStats::load()
+{
+    m_buckets.clear();
+    m_window.clear();
+    m_windowStart = today() - WINDOW_DAYS + 1;
+
+    QList<DishSalesBucket> rows = DBManager::instance().loadDishSales(m_windowStart);
+    for (const DishSalesBucket &b : rows) {
+        m_buckets[b.day][b.dish] += b.qty;
+        m_window[b.dish] += b.qty;
+    }
+    rebuildTopK();
+    qDebug() << "SalesStats loaded" << rows.size() << "buckets," << m_window.size() << "dishes";
+}
+
+// 窗口向前滚动：减掉过期桶的销量。销量只会减少，top-k 需要整体重建 (每天一次)
+// 读取接口里也会调用，所以通知排队发出：监听者 (OrderWidget::updateDishList) 正在读榜单时不能重入
+void SalesStats::rollWindow()
+{
+    int newStart = today() - WINDOW_DAYS + 1;
+    if (newStart <= m_windowStart) return;
+
+    while (!m_buckets.isEmpty() && m_buckets.firstKey() < newStart) {
+        QHashIterator<QString, int> i(m_buckets.first());
+        while (i.hasNext()) {
+            i.next();
+            int left = m_window.value(i.key()) - i.value();
+            if (left > 0) m_window.insert(i.key(), left);
+            else m_window.remove(i.key());
+        }
+        m_buckets.erase(m_buckets.begin());
+    }
+    m_windowStart = newStart;
+    rebuildTopK();
+    QMetaObject::invokeMethod(this, "hotListChanged", Qt::QueuedConnection);
+}
+
+void SalesStats::applyDelta(int day, const QMap<QString, int> &counts)
+{
+    rollWindow();
+    if (day < m_windowStart) return;   // 已经滑出窗口的增量只落库，不计入月售
+
+    bool topChanged = false;
+    QMapIterator<QString, int> i(counts);
+    while (i.hasNext()) {
+        i.next();
+        if (i.value() <= 0) continue;
+        m_buckets[day][i.key()] += i.value();
+        int total = (m_window[i.key()] += i.value());
+        if (bumpTopK(i.key(), total)) topChanged = true;
+    }
+    if (topChanged) emit hotListChanged();
+}
+
+void SalesStats::recordSale(const QMap<QString, int> &cart)
+{
+    if (cart.isEmpty()) return;
+
+    int day = today();
+    DBManager::instance().addDishSales(day, cart);
+    applyDelta(day, cart);
+
+    // 广播增量
+    QJsonObject items;
+    QMapIterator<QString, int> i(cart);
+    while (i.hasNext()) {
+        i.next();
+        items.insert(i.key(), i.value());
+    }
+    QJsonObject msg;
+    msg.insert("kiosk", m_kioskId);
+    msg.insert("day", day);
+    msg.insert("items", items);
+    emit localSalesRecorded(QString::fromUtf8(QJsonDocument(msg).toJson(QJsonDocument::Compact)));
+}
+
+bool SalesStats::mergeRemote(const QString &json)
+{
+    QJsonObject msg = QJsonDocument::fromJson(json.toUtf8()).object();
+    if (msg.isEmpty() || msg.value("kiosk").toString() == m_kioskId) return false;
+
+    // 各点餐机时钟可能有偏差，未来日期按今天计
+    int day = qMin(msg.value("day").toInt(), today());
+    QMap<QString, int> counts;
+    QJsonObject items = msg.value("items").toObject();
+    for (QJsonObject::const_iterator it = items.constBegin(); it != items.constEnd(); ++it) {
+        int qty = it.value().toInt();
+        if (qty > 0) counts.insert(it.key(), qty);
+    }
+    if (counts.isEmpty()) return false;
+
+    DBManager::instance().addDishSales(day, counts);
+    applyDelta(day, counts);
+    qDebug() << "SalesStats merged" << counts.size() << "dishes from" << msg.value("kiosk").toString();
+    return true;
+}
+
+int SalesStats::monthlySales(const QString &dish)
+{
+    rollWindow();
+    return m_window.value(dish, 0);
+}
+
+QVector<QPair<QString, int> > SalesStats::hotList()
+{
+    rollWindow();
+    return m_topK;
+}
+
+// 某道菜的销量增加到 count 后调整 top-k，返回榜单是否变化
+// 只处理增加：榜外的菜只有超过榜尾才能进榜
+bool SalesStats::bumpTopK(const QString &dish, int count)
+{
+    int pos = -1;
+    for (int i = 0; i < m_topK.size(); ++i) {
+        if (m_topK[i].first == dish) {
+            pos = i;
+            break;
+        }
+    }
+
+    if (pos >= 0) {
+        m_topK[pos].second = count;
+    } else if (m_topK.size() < HOT_LIST_SIZE) {
+        m_topK.append(qMakePair(dish, count));
+        pos = m_topK.size() - 1;
+    } else if (count > m_topK.last().second) {
+        m_topK.last() = qMakePair(dish, count);
+        pos = m_topK.size() - 1;
+    } else {
+        return false;
+    }
+
+    while (pos > 0 && m_topK[pos - 1].second < m_topK[pos].second) {
+        qSwap(m_topK[pos - 1], m_topK[pos]);
+        --pos;
+    }
+    return true;
+}
+
+void SalesStats::rebuildTopK()
+{
+    m_topK.clear();
+    QHashIterator<QString, int> i(m_window);
+    while (i.hasNext()) {
+        i.next();
+        bumpTopK(i.key(), i.value());
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef SALESSTATS_H
+#define SALESSTATS_H
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QVector>
+
+class QTimer;
+
+// 菜品销量统计
+// 销量按天分桶保存在 dish_sales_daily 表中，内存里只维护最近 30 天的桶和窗口合计；
+// 订单支付时增量更新，跨天时淘汰最旧的桶，全程不扫描订单明细。
+// 热销榜是一个按销量降序的 top-k 数组，读取为 O(k)。
+class SalesStats : public QObject
+{
+    Q_OBJECT
+public:
+    static const int WINDOW_DAYS = 30;   // "月售" 滚动窗口
+    static const int HOT_LIST_SIZE = 8;  // 热销榜长度
+
+    static SalesStats* instance();
+
+    void load();                                    // 从数据库载入窗口内的分桶
+    void recordSale(const QMap<QString, int> &cart); // 本机订单支付成功
+    bool mergeRemote(const QString &json);          // 合并其他点餐机通过 MQTT 发布的增量
+
+    int monthlySales(const QString &dish);
+    QVector<QPair<QString, int> > hotList();        // <菜名, 月售>，按销量降序
+
+signals:
+    void hotListChanged();
+    void localSalesRecorded(const QString &json);   // 本机增量，由持有 MQTT 连接的页面负责发布
+
+private slots:
+    void onDayChanged();
+
+private:
+    explicit SalesStats(QObject *parent = nullptr);
+    static SalesStats* m_instance;
+
+    static int today();
+    void applyDelta(int day, const QMap<QString, int> &counts);
+    void rollWindow();
+    void scheduleDayChange();
+    bool bumpTopK(const QString &dish, int count);
+    void rebuildTopK();
+
+    QString m_kioskId;                        // 本机标识，用于过滤自己发出的增量
+    int m_windowStart;                        // 窗口第一天 (儒略日)
+    QMap<int, QHash<QString, int> > m_buckets; // 日 -> <菜名, 销量>
+    QHash<QString, int> m_window;             // 窗口内每道菜的合计
+    QVector<QPair<QString, int> > m_topK;     // 热销榜
+    QTimer *m_dayTimer;                       // 下一个零点触发
+};
+
+#endif // SALESSTATS_H
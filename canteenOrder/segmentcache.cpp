@@ -0,0 +1,166 @@
+#include "segmentcache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+#include <QDebug>
+#include <algorithm>
+#include <sys/time.h>
+
+#define SIZE_FILE "size"
+#define SEGMENT_SUFFIX ".seg"
+// 读的时候隔这么久才把使用时间写回文件 mtime，重启后 LRU 顺序还在
+#define TOUCH_INTERVAL_MS (10 * 60 * 1000)
+
+// 类内初始化的常量被 qMin 等按引用使用时需要这里的定义，否则 -O0 下链接失败
+const qint64 SegmentCache::SEGMENT_SIZE;
+
+SegmentCache::SegmentCache(const QString &dir, qint64 capacityBytes)
+    : m_dir(dir), m_capacity(capacityBytes), m_used(0)
+{
+    QDir().mkpath(m_dir);
+    load();
+}
+
+QString SegmentCache::keyFor(const QString &url)
+{
+    return QCryptographicHash::hash(url.toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+}
+
+QString SegmentCache::entryId(const QString &key, int index)
+{
+    return key + '/' + QString::number(index);
+}
+
+QString SegmentCache::segmentPath(const QString &key, int index) const
+{
+    return m_dir + '/' + key + '/' + QString::number(index) + SEGMENT_SUFFIX;
+}
+
+// 启动时扫一遍目录建索引，使用时间取文件 mtime
+void SegmentCache::load()
+{
+    QDir root(m_dir);
+    for (const QString &key : root.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QDir sub(root.filePath(key));
+        QFile sizeFile(sub.filePath(SIZE_FILE));
+        if (sizeFile.open(QIODevice::ReadOnly)) {
+            bool ok = false;
+            qint64 size = sizeFile.readAll().trimmed().toLongLong(&ok);
+            if (ok) m_sizes.insert(key, size);
+        }
+        for (const QFileInfo &info : sub.entryInfoList(QStringList() << "*" SEGMENT_SUFFIX, QDir::Files)) {
+            bool ok = false;
+            int index = info.completeBaseName().toInt(&ok);
+            if (!ok) continue;
+            Entry entry = { info.size(), info.lastModified().toMSecsSinceEpoch() };
+            m_entries.insert(entryId(key, index), entry);
+            m_used += entry.bytes;
+        }
+    }
+    qDebug() << "SegmentCache:" << m_entries.size() << "segments," << m_used / (1024 * 1024) << "MB in" << m_dir;
+}
+
+qint64 SegmentCache::totalSize(const QString &key) const
+{
+    return m_sizes.value(key, -1);
+}
+
+void SegmentCache::setTotalSize(const QString &key, qint64 size)
+{
+    if (m_sizes.value(key, -1) == size) return;
+    m_sizes.insert(key, size);
+    QDir().mkpath(m_dir + '/' + key);
+    QFile file(m_dir + '/' + key + '/' + SIZE_FILE);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) file.write(QByteArray::number(size));
+}
+
+int SegmentCache::segmentCount(const QString &key) const
+{
+    qint64 size = totalSize(key);
+    if (size < 0) return -1;
+    return (int)((size + SEGMENT_SIZE - 1) / SEGMENT_SIZE);
+}
+
+bool SegmentCache::contains(const QString &key, int index) const
+{
+    return m_entries.contains(entryId(key, index));
+}
+
+QByteArray SegmentCache::read(const QString &key, int index, qint64 offset, qint64 maxLen)
+{
+    QHash<QString, Entry>::iterator it = m_entries.find(entryId(key, index));
+    if (it == m_entries.end()) return QByteArray();
+
+    QString path = segmentPath(key, index);
+    QFile file(path);
+    QByteArray data;
+    if (file.open(QIODevice::ReadOnly) && file.seek(offset)) data = file.read(maxLen);
+    if (data.isEmpty() || data.size() < qMin(maxLen, it->bytes - offset)) {
+        // 文件被外部删了或被截断，索引跟着删，否则 contains() 一直为真，这段永远不会重新下载
+        qDebug() << "SegmentCache: short read, dropping" << path << data.size() << "of" << qMin(maxLen, it->bytes - offset);
+        file.close();
+        QFile::remove(path);
+        m_used -= it->bytes;
+        m_entries.erase(it);
+        return QByteArray();
+    }
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - it->lastUse > TOUCH_INTERVAL_MS) ::utimes(QFile::encodeName(path).constData(), nullptr);
+    it->lastUse = now;
+    return data;
+}
+
+void SegmentCache::store(const QString &key, int index, const QByteArray &data)
+{
+    if (data.isEmpty()) return;
+    QDir().mkpath(m_dir + '/' + key);
+    QString path = segmentPath(key, index);
+    QString tmp = path + ".part";
+    QFile file(tmp);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size()) {
+        qDebug() << "SegmentCache: write failed" << tmp;
+        file.remove();
+        return;
+    }
+    file.close();
+    QFile::remove(path);
+    if (!QFile::rename(tmp, path)) {
+        QFile::remove(tmp);
+        return;
+    }
+
+    QString id = entryId(key, index);
+    m_used -= m_entries.value(id, Entry{0, 0}).bytes;
+    Entry entry = { data.size(), QDateTime::currentMSecsSinceEpoch() };
+    m_entries.insert(id, entry);
+    m_used += entry.bytes;
+    if (m_used > m_capacity) evict();
+}
+
+// 按使用时间从旧到新删，删到容量的 90%，免得每存一段都要排一次序
+void SegmentCache::evict()
+{
+    QVector<QPair<qint64, QString> > order;
+    order.reserve(m_entries.size());
+    for (QHash<QString, Entry>::const_iterator it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        order.append(qMakePair(it->lastUse, it.key()));
+    }
+    std::sort(order.begin(), order.end());
+
+    qint64 target = m_capacity / 10 * 9;
+    int removed = 0;
+    for (const QPair<qint64, QString> &item : order) {
+        if (m_used <= target) break;
+        const QString &id = item.second;
+        int slash = id.indexOf('/');
+        QFile::remove(segmentPath(id.left(slash), id.mid(slash + 1).toInt()));
+        m_used -= m_entries.value(id).bytes;
+        m_entries.remove(id);
+        ++removed;
+    }
+    qDebug() << "SegmentCache: evicted" << removed << "segments, now" << m_used / (1024 * 1024) << "MB";
+}
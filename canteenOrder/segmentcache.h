@@ -0,0 +1,50 @@
+#ifndef SEGMENTCACHE_H
+#define SEGMENTCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QByteArray>
+
+// 网络视频的磁盘分段缓存
+// 每个 URL 一个子目录，文件按 SEGMENT_SIZE 切段，每段一个文件 (<段号>.seg)，总长度记在 size 文件里；
+// 超过容量时按最近使用时间淘汰整段 (LRU)。只在 GUI 线程使用
+class SegmentCache
+{
+public:
+    static const qint64 SEGMENT_SIZE = 512 * 1024;
+
+    SegmentCache(const QString &dir, qint64 capacityBytes);
+
+    static QString keyFor(const QString &url);
+
+    qint64 totalSize(const QString &key) const;    // 未知时返回 -1
+    void setTotalSize(const QString &key, qint64 size);
+    int segmentCount(const QString &key) const;    // 总长度未知时返回 -1
+
+    bool contains(const QString &key, int index) const;
+    // 读一段中的一部分，同时刷新这段的使用时间；失败返回空。
+    // 读不到或读不满 (段文件被删 / 截断) 时把这段从索引里删掉，调用方重新下载即可
+    QByteArray read(const QString &key, int index, qint64 offset, qint64 maxLen);
+    void store(const QString &key, int index, const QByteArray &data);
+
+    qint64 usedBytes() const { return m_used; }
+
+private:
+    struct Entry {
+        qint64 bytes;
+        qint64 lastUse;     // ms since epoch
+    };
+
+    QString segmentPath(const QString &key, int index) const;
+    static QString entryId(const QString &key, int index);
+    void load();
+    void evict();
+
+    QString m_dir;
+    qint64 m_capacity;
+    qint64 m_used;
+    QHash<QString, Entry> m_entries;    // "<key>/<段号>"
+    QHash<QString, qint64> m_sizes;     // key -> 总长度
+};
+
+#endif // SEGMENTCACHE_H
@@ -1,23 +1,17 @@
 #include "settlewidget.h"
 #include "paywidget.h"
+#include "brandstyle.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
-#include <QMessageBox>
+#include "toastmanager.h"
 #include <QDebug>
 
 SettleWidget::SettleWidget(QWidget *parent) : QWidget(parent)
 {
-    this->setStyleSheet("QWidget { background-color: #F0F2F5; }");
+    BrandStyle::setPanel(this, BrandStyle::Look(QColor("#F0F2F5")));
     currentTotalPrice = 0;
     initUI();
-    m_mqtt = new MiniMqtt(this);
-
-    // 打印连接状态
-    connect(m_mqtt, &MiniMqtt::connected, [=](){
-        qDebug() << "SettlePage: MQTT Connected!";
-    });
-    m_mqtt->connectToHost(MQTT_IP, MQTT_PORT);
 }
 
 void SettleWidget::initUI()
@@ -28,13 +22,15 @@ void SettleWidget::initUI()
 
     // 1. 左侧：账单
     QWidget *billWidget = new QWidget(this);
-    billWidget->setStyleSheet("background-color: white; border-radius: 10px;");
+    BrandStyle::setPanel(billWidget, BrandStyle::Look(Qt::white, 10));
     QVBoxLayout *billLayout = new QVBoxLayout(billWidget);
     billLayout->setContentsMargins(15, 15, 15, 15);
 
     QLabel *lblBillTitle = new QLabel(QStringLiteral("购物小票"), billWidget);
     lblBillTitle->setAlignment(Qt::AlignCenter);
-    lblBillTitle->setStyleSheet("font-size: 20px; font-weight: bold; color: #333; padding-bottom: 10px; border-bottom: 2px dashed #EEE;");
+    BrandStyle::setText(lblBillTitle, QColor("#333333"), 20, true);
+    BrandStyle::setPanel(lblBillTitle, BrandStyle::Look().border(QColor("#EEEEEE"), 2, Qt::BottomEdge, Qt::DashLine));
+    lblBillTitle->setContentsMargins(0, 0, 0, 10);
 
     tableCart = new QTableWidget(billWidget);
     tableCart->setColumnCount(3);
@@ -43,10 +39,9 @@ void SettleWidget::initUI()
     tableCart->setEditTriggers(QAbstractItemView::NoEditTriggers);
     tableCart->setSelectionMode(QAbstractItemView::NoSelection);
     tableCart->setFocusPolicy(Qt::NoFocus);
-    tableCart->setStyleSheet(
-                "QTableWidget { border: none; gridline-color: #F0F0F0; background: white; }"
-                "QHeaderView::section { background: white; color: #999; border: none; font-weight: bold; font-size: 14px; }"
-                );
+    tableCart->setFrameShape(QFrame::NoFrame);
+    // 网格线颜色由 BrandStyle 统一给出，表头平铺白底
+    BrandStyle::setText(tableCart->horizontalHeader(), QColor("#999999"), 14, true);
     tableCart->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
     tableCart->setColumnWidth(1, 60);
     tableCart->setColumnWidth(2, 80);
@@ -57,7 +52,7 @@ void SettleWidget::initUI()
     // 2. 右侧：支付面板
     QWidget *payControlWidget = new QWidget(this);
     payControlWidget->setFixedWidth(280);
-    payControlWidget->setStyleSheet("background-color: white; border-radius: 10px;");
+    BrandStyle::setPanel(payControlWidget, BrandStyle::Look(Qt::white, 10));
 
     QVBoxLayout *payLayout = new QVBoxLayout(payControlWidget);
     payLayout->setContentsMargins(20, 40, 20, 40);
@@ -66,19 +61,17 @@ void SettleWidget::initUI()
 
     QLabel *lblTotalTitle = new QLabel(QStringLiteral("应付总额"), payControlWidget);
     lblTotalTitle->setAlignment(Qt::AlignCenter);
-    lblTotalTitle->setStyleSheet("color: #666; font-size: 18px;");
+    BrandStyle::setText(lblTotalTitle, QColor("#666666"), 18);
 
     lblFinalPrice = new QLabel(QStringLiteral("0 元"), payControlWidget);
     lblFinalPrice->setAlignment(Qt::AlignCenter);
-    lblFinalPrice->setStyleSheet("color: #FF5339; font-size: 48px; font-weight: bold; font-family: 'Arial';");
+    BrandStyle::setText(lblFinalPrice, QColor("#FF5339"), 48, true, "Arial");
 
     btnConfirmPay = new QPushButton(QStringLiteral("立即支付"), payControlWidget);
     btnConfirmPay->setFixedHeight(60);
     btnConfirmPay->setCursor(Qt::PointingHandCursor);
-    btnConfirmPay->setStyleSheet(
-                "QPushButton { background-color: #26C28D; color: white; font-size: 20px; font-weight: bold; border-radius: 30px; border: 2px solid #20A576; }"
-                "QPushButton:pressed { background-color: #1E946A; border-color: #1E946A; }"
-                );
+    BrandStyle::setButton(btnConfirmPay, BrandStyle::Look(QColor("#26C28D"), 30).pressed(QColor("#1E946A")).border(QColor("#20A576"), 2),
+                          Qt::white, 20, true);
     connect(btnConfirmPay, SIGNAL(clicked()), this, SLOT(onPayClicked()));
 
     payLayout->addWidget(lblTotalTitle);
@@ -148,27 +141,30 @@ void SettleWidget::updateOrderInfo(const QMap<QString, int> &cart, const QMap<QS
 void SettleWidget::onPayClicked()
 {
     if (currentTotalPrice <= 0) {
-        QMessageBox::warning(this, QStringLiteral("提示"), QStringLiteral("购物车是空的，快去选购心仪的美食吧！"));
+        ToastManager::instance()->show(QStringLiteral("购物车是空的，快去选购心仪的美食吧！"), ToastManager::Warning);
         return;
     }
 
-    PayWidget payDialog(currentTotalPrice, this);
+    // 用 open() 代替 exec()：对话框照样挡住底下的界面，但不开嵌套事件循环，结果在 onPayFinished 里处理
+    PayWidget *payDialog = new PayWidget(currentTotalPrice, this);
+    payDialog->setAttribute(Qt::WA_DeleteOnClose);
+    payDialog->setOrderData(m_jsonOrder);   // 二维码按订单号生成，确认支付时交给 OrderPublisher 发布
+    connect(payDialog, SIGNAL(finished(int)), this, SLOT(onPayFinished(int)));
+    btnConfirmPay->setEnabled(false);
+    payDialog->open();
+}
+
+void SettleWidget::onPayFinished(int result)
+{
+    btnConfirmPay->setEnabled(true);
 
-    if (payDialog.exec() == QDialog::Accepted) {
-        QMessageBox::information(this, QStringLiteral("支付成功"),
-                                 QStringLiteral("支付成功！\n共消费 %1 元。\n\n正在为您制作美食，请稍候...").arg(currentTotalPrice));
+    if (result == QDialog::Accepted) {
+        ToastManager::instance()->show(QStringLiteral("支付成功！共消费 %1 元。\n正在为您制作美食，请稍候...").arg(currentTotalPrice));
 
         currentTotalPrice = 0;
         lblFinalPrice->setText(QStringLiteral("0 元"));
         tableCart->setRowCount(0);
 
-        if (m_mqtt && !m_jsonOrder.isEmpty()) {
-            m_mqtt->publish("canteen/order/new", m_jsonOrder);
-            qDebug() << "MQTT Published: " << m_jsonOrder;
-        } else {
-            qDebug() << "Error: MQTT not ready or JSON is empty";
-        }
-
         emit paySuccess();
     }
     else {
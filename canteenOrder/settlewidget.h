@@ -6,7 +6,6 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QMap>
-#include "minimqtt.h"
 
 class SettleWidget : public QWidget
 {
@@ -23,6 +22,7 @@ signals:
 
 private slots:
     void onPayClicked();
+    void onPayFinished(int result);  // 支付对话框关闭 (QDialog::Accepted 表示已支付)
 
 private:
     void initUI();
@@ -33,7 +33,6 @@ private:
     QPushButton *btnConfirmPay;
     int currentTotalPrice;
     QString m_jsonOrder;  // 存储从 MainInterface 传来的 JSON
-        MiniMqtt *m_mqtt;
 };
 
 #endif // SETTLEWIDGET_H
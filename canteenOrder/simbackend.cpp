@@ -0,0 +1,177 @@
+#include "simbackend.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QList>
+#include <QMap>
+#include <QTextStream>
+#include <QDebug>
+#include <time.h>
+#include <errno.h>
+
+static void sleepUntilNs(qint64 ns)
+{
+    struct timespec ts;
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+}
+
+bool SimBackend::open()
+{
+    m_tracePath = QString::fromLocal8Bit(qgetenv("CANTEEN_HAL_TRACE"));
+
+    QString script = QString::fromLocal8Bit(qgetenv("CANTEEN_HAL_SCRIPT"));
+    if (!script.isEmpty() && !loadScript(script, nowNs())) {
+        qDebug() << "HAL sim: cannot read script" << script;
+    }
+    qDebug() << "HAL sim:" << m_script.size() << "scripted steps";
+    return true;
+}
+
+bool SimBackend::loadScript(const QString &path, qint64 startNs)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+
+    qint64 at = startNs;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        QList<QByteArray> parts = line.simplified().split(' ');
+        bool ok = false;
+        int delayMs = parts.value(0).toInt(&ok);
+        QByteArray action = parts.value(1);
+        int key = parts.size() > 2 ? parts.at(2).toInt() : KEY_URGE;
+        if (!ok || (action != "press" && action != "report" && action != "quit")
+                || key < 0 || key >= KEY_COUNT) {
+            qDebug() << "HAL sim: bad script line" << line;
+            continue;
+        }
+        at += (qint64)delayMs * 1000000LL;
+        m_script.append(Step{at, action, key});
+    }
+    return true;
+}
+
+void SimBackend::record(const QByteArray &name, int value, qint64 ns)
+{
+    QMutexLocker locker(&m_mutex);
+    m_events.append(Event{ns ? ns : nowNs(), name, value});
+}
+
+void SimBackend::setLed(int brightness)
+{
+    record("led", brightness);
+}
+
+void SimBackend::setBuzzer(bool high)
+{
+    record("buzzer", high ? 1 : 0);
+}
+
+void SimBackend::startTone(int freqHz)
+{
+    record("tone", freqHz);
+}
+
+void SimBackend::stopTone()
+{
+    record("tone", 0);
+}
+
+void SimBackend::trace(const char *event)
+{
+    record(event, 0);
+}
+
+bool SimBackend::scanKeys(int timeoutMs, quint32 *pressed)
+{
+    // 睡到超时或下一个按下 / 松开时刻，再按脚本更新按键状态
+    qint64 wake = nowNs() + (qint64)timeoutMs * 1000000LL;
+    if (m_next < m_script.size()) wake = qMin(wake, m_script.at(m_next).atNs);
+    for (int k = 0; k < KEY_COUNT; ++k) {
+        if (m_releaseAt[k]) wake = qMin(wake, m_releaseAt[k]);
+    }
+    sleepUntilNs(wake);
+    qint64 now = nowNs();
+
+    while (m_next < m_script.size() && m_script.at(m_next).atNs <= now) {
+        Step step = m_script.at(m_next++);
+        if (step.action == "press") {
+            m_down |= 1u << step.key;
+            m_releaseAt[step.key] = step.atNs + SIM_PRESS_MS * 1000000LL;
+            record("key", step.key, step.atNs); // 按下的物理时刻，延迟统计包含消抖
+            continue;
+        }
+        report();
+        if (step.action == "quit") {
+            QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
+        }
+    }
+    for (int k = 0; k < KEY_COUNT; ++k) {
+        if (m_releaseAt[k] && m_releaseAt[k] <= now) {
+            m_down &= ~(1u << k);
+            m_releaseAt[k] = 0;
+        }
+    }
+    *pressed = m_down;
+    return true;
+}
+
+void SimBackend::report()
+{
+    struct Stat {
+        int count;
+        qint64 sumNs;
+        qint64 maxNs;
+    };
+    QMap<QByteArray, Stat> stats;
+    int keys = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        qint64 keyNs = 0;
+        QList<QByteArray> seen; // 本次按键之后已经出现过的事件
+        for (const Event &ev : m_events) {
+            if (ev.name == "key") {
+                keyNs = ev.ns;
+                seen.clear();
+                ++keys;
+                continue;
+            }
+            if (!keyNs || seen.contains(ev.name)) continue;
+            seen << ev.name;
+
+            Stat &s = stats[ev.name];
+            qint64 lat = ev.ns - keyNs;
+            s.count++;
+            s.sumNs += lat;
+            if (lat > s.maxNs) s.maxNs = lat;
+        }
+    }
+
+    qDebug().noquote() << QString("[HAL sim] %1 key presses").arg(keys);
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        qDebug().noquote() << QString("[HAL sim] key -> %1: n=%2 avg %3 us max %4 us")
+                              .arg(QString::fromLatin1(it.key())).arg(it.value().count)
+                              .arg(it.value().sumNs / it.value().count / 1000)
+                              .arg(it.value().maxNs / 1000);
+    }
+    writeTrace();
+}
+
+// 事件记录：每行 "<单调时钟 ns> <事件> <值>"
+void SimBackend::writeTrace()
+{
+    if (m_tracePath.isEmpty()) return;
+    QFile file(m_tracePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qDebug() << "HAL sim: cannot write trace" << m_tracePath;
+        return;
+    }
+    QTextStream out(&file);
+    QMutexLocker locker(&m_mutex);
+    for (const Event &ev : m_events) {
+        out << ev.ns << ' ' << ev.name << ' ' << ev.value << '\n';
+    }
+}
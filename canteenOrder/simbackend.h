@@ -0,0 +1,66 @@
+#ifndef SIMBACKEND_H
+#define SIMBACKEND_H
+
+#include "hardwarebackend.h"
+#include <QMutex>
+#include <QVector>
+#include <QByteArray>
+#include <QString>
+
+// 仿真后端：没有真实硬件时使用 (x86 CI、开发机)
+// 所有输出 (LED、蜂鸣器) 和应用层 trace 都带单调时间戳记录下来；
+// 按键由脚本注入，环境变量 CANTEEN_HAL_SCRIPT 指向脚本文件，每行 "<延时ms> <动作>"：
+//     press [键号]  模拟按一次按键 (按住 SIM_PRESS_MS)，键号见 KeyId，默认催单键
+//     report  打印按键到各事件的延迟统计，并把事件记录写到 CANTEEN_HAL_TRACE
+//     quit    先 report 再退出程序
+// 延时相对上一行，# 开头为注释
+class SimBackend : public HardwareBackend
+{
+public:
+    const char *name() const override { return "sim"; }
+    bool open() override;
+
+    void setLed(int brightness) override;
+    bool hasBuzzer() const override { return true; }
+    bool hasToneGenerator() const override { return true; } // 当作硬件 PWM，不做软件翻转
+    void setBuzzer(bool high) override;
+    void startTone(int freqHz) override;
+    void stopTone() override;
+
+    quint32 keyMask() const override { return m_script.isEmpty() ? 0 : (1u << KEY_COUNT) - 1; }
+    bool scanKeys(int timeoutMs, quint32 *pressed) override;
+
+    void trace(const char *event) override;
+
+    void report(); // 统计每次按键到其后各类事件首次出现的延迟
+
+private:
+    struct Event {
+        qint64 ns;
+        QByteArray name;
+        int value;
+    };
+    struct Step {
+        qint64 atNs;     // 绝对时间 (CLOCK_MONOTONIC)
+        QByteArray action;
+        int key;
+    };
+
+    void record(const QByteArray &name, int value, qint64 ns = 0);
+    bool loadScript(const QString &path, qint64 startNs);
+    void writeTrace();
+
+    QMutex m_mutex;          // 保护 m_events：GUI、蜂鸣器、按键线程都会写
+    QVector<Event> m_events;
+    QVector<Step> m_script;
+    QString m_tracePath;
+
+    // 以下只在按键线程访问
+    int m_next = 0;          // 下一个脚本步骤
+    quint32 m_down = 0;      // 当前按下的按键
+    qint64 m_releaseAt[KEY_COUNT] = {0};
+
+    static const int SIM_PRESS_MS = 80;
+};
+
+#endif // SIMBACKEND_H
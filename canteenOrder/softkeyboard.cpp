@@ -1,4 +1,5 @@
 #include "softkeyboard.h"
+#include "brandstyle.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QApplication>
@@ -13,6 +14,11 @@ const QStringList CHARS_LOWER = QStringList() << "q"<<"w"<<"e"<<"r"<<"t"<<"y"<<"
 const QStringList CHARS_UPPER = QStringList() << "Q"<<"W"<<"E"<<"R"<<"T"<<"Y"<<"U"<<"I"<<"O"<<"P"<<"A"<<"S"<<"D"<<"F"<<"G"<<"H"<<"J"<<"K"<<"L"<<"Z"<<"X"<<"C"<<"V"<<"B"<<"N"<<"M";
 const QStringList CHARS_SYMBOL= QStringList() << "1"<<"2"<<"3"<<"4"<<"5"<<"6"<<"7"<<"8"<<"9"<<"0"<<"-"<<"/"<<":"<<";"<<"("<<")"<<"$"<<"&&"<<"@"<<"\""<<"."<<","<<"?"<<"!"<<"'"<<"_";
 
+// 【修改点 3】功能键 (Shift, Del, 123)：牛奶咖啡色，白色文字，深色阴影
+static BrandStyle::Look funcKeyLook() {
+    return BrandStyle::Look(QColor("#8D6E63"), 6).pressed(QColor("#6D4C41")).edge(QColor("#5D4037"), 3);
+}
+
 SoftKeyboard* SoftKeyboard::instance() {
     if (!m_instance) m_instance = new SoftKeyboard();
     return m_instance;
@@ -27,13 +33,8 @@ SoftKeyboard::SoftKeyboard(QWidget *parent) : QDialog(parent) {
     this->setWindowFlags(Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::Tool);
     this->setFixedSize(800, 260);
 
-    // 【修改点 1】背景色：深咖啡色底座 (像木质托盘)
-    this->setStyleSheet(
-        "SoftKeyboard { "
-        "   background-color: #4E342E; " // 深咖啡色
-        "   border-top: 4px solid #8D6E63; " // 顶部亮一点的咖啡色边框
-        "}"
-    );
+    // 【修改点 1】背景色：深咖啡色底座 (像木质托盘)，顶部亮一点的咖啡色边框
+    BrandStyle::setPanel(this, BrandStyle::Look(QColor("#4E342E")).border(QColor("#8D6E63"), 4, Qt::TopEdge));
 
     initUI();
 }
@@ -43,39 +44,10 @@ void SoftKeyboard::initUI() {
     mainLayout->setSpacing(6); // 稍微增加间距
     mainLayout->setContentsMargins(10, 15, 10, 10);
 
-    // 【修改点 2】普通按键样式：奶油白/米白色 (像白巧克力)
-    QString btnStyle =
-            "QPushButton { "
-            "   background-color: #FFF8E1; " // 米白色
-            "   color: #5D4037; "            // 咖啡色文字
-            "   border: none; "
-            "   border-radius: 6px; "
-            "   border-bottom: 3px solid #D7CCC8; " // 底部阴影，增加立体感
-            "   font-family: 'Microsoft YaHei'; "   // 或者 WenQuanYi
-            "   font-size: 22px; "
-            "   font-weight: bold; "
-            "}"
-            "QPushButton:pressed { "
-            "   background-color: #FFE0B2; " // 按下变淡橙色
-            "   border-bottom: 0px; "        // 阴影消失
-            "   margin-top: 3px; "           // 产生下压位移
-            "}";
-
-    // 【修改点 3】功能键样式 (Shift, Del, 123)：牛奶咖啡色
-    QString funcBtnStyle =
-            "QPushButton { "
-            "   background-color: #8D6E63; " // 浅咖啡色
-            "   color: white; "              // 白色文字
-            "   border: none; "
-            "   border-radius: 6px; "
-            "   border-bottom: 3px solid #5D4037; " // 深色阴影
-            "   font-size: 18px; "
-            "   font-weight: bold; "
-            "}"
-            "QPushButton:pressed { "
-            "   background-color: #6D4C41; "
-            "   border-bottom: 0px; margin-top: 3px; "
-            "}";
+    // 【修改点 2】普通按键：奶油白/米白色 (像白巧克力)，咖啡色文字，底部阴影增加立体感；
+    // 按下变淡橙色、阴影消失并下压
+    BrandStyle::Look keyLook = BrandStyle::Look(QColor("#FFF8E1"), 6).pressed(QColor("#FFE0B2")).edge(QColor("#D7CCC8"), 3);
+    auto styleKey = [=](QPushButton *btn) { BrandStyle::setButton(btn, keyLook, QColor("#5D4037"), 22, true); };
 
     // --- 第一行 (q-p) ---
     QHBoxLayout *row1 = new QHBoxLayout();
@@ -83,7 +55,7 @@ void SoftKeyboard::initUI() {
     for(int i=0; i<10; i++) {
         QPushButton *btn = new QPushButton();
         btn->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-        btn->setStyleSheet(btnStyle);
+        styleKey(btn);
         connect(btn, SIGNAL(clicked()), this, SLOT(onButtonClicked()));
         m_letterButtons.append(btn);
         row1->addWidget(btn);
@@ -97,7 +69,7 @@ void SoftKeyboard::initUI() {
     for(int i=0; i<9; i++) {
         QPushButton *btn = new QPushButton();
         btn->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-        btn->setStyleSheet(btnStyle);
+        styleKey(btn);
         connect(btn, SIGNAL(clicked()), this, SLOT(onButtonClicked()));
         m_letterButtons.append(btn);
         row2->addWidget(btn);
@@ -110,14 +82,14 @@ void SoftKeyboard::initUI() {
 
     btnShift = new QPushButton("Shift");
     btnShift->setFixedSize(100, 50);
-    btnShift->setStyleSheet(funcBtnStyle);
+    BrandStyle::setButton(btnShift, funcKeyLook(), Qt::white, 18, true);
     connect(btnShift, SIGNAL(clicked()), this, SLOT(onButtonClicked()));
     row3->addWidget(btnShift);
 
     for(int i=0; i<7; i++) {
         QPushButton *btn = new QPushButton();
         btn->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-        btn->setStyleSheet(btnStyle);
+        styleKey(btn);
         connect(btn, SIGNAL(clicked()), this, SLOT(onButtonClicked()));
         m_letterButtons.append(btn);
         row3->addWidget(btn);
@@ -125,7 +97,7 @@ void SoftKeyboard::initUI() {
 
     QPushButton *btnDel = new QPushButton("Del");
     btnDel->setFixedSize(100, 50);
-    btnDel->setStyleSheet(funcBtnStyle);
+    BrandStyle::setButton(btnDel, funcKeyLook(), Qt::white, 18, true);
     connect(btnDel, SIGNAL(clicked()), this, SLOT(onButtonClicked()));
     row3->addWidget(btnDel);
     mainLayout->addLayout(row3);
@@ -136,7 +108,7 @@ void SoftKeyboard::initUI() {
 
     btnMode = new QPushButton("123");
     btnMode->setFixedSize(110, 50);
-    btnMode->setStyleSheet(funcBtnStyle);
+    BrandStyle::setButton(btnMode, funcKeyLook(), Qt::white, 18, true);
     connect(btnMode, SIGNAL(clicked()), this, SLOT(onButtonClicked()));
     row4->addWidget(btnMode);
 
@@ -144,36 +116,16 @@ void SoftKeyboard::initUI() {
     btnSpace->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
     btnSpace->setFixedHeight(50);
     // 空格键稍微特殊一点，用纯白
-    btnSpace->setStyleSheet(
-        "QPushButton { "
-        "   background-color: #FFFFFF; "
-        "   color: #5D4037; "
-        "   border-radius: 6px; "
-        "   border-bottom: 3px solid #CFD8DC; "
-        "   font-size: 18px; "
-        "}"
-        "QPushButton:pressed { background-color: #ECEFF1; border-bottom: 0px; margin-top: 3px; }"
-    );
+    BrandStyle::setButton(btnSpace, BrandStyle::Look(Qt::white, 6).pressed(QColor("#ECEFF1")).edge(QColor("#CFD8DC"), 3),
+                          QColor("#5D4037"), 18);
     connect(btnSpace, SIGNAL(clicked()), this, SLOT(onButtonClicked()));
     row4->addWidget(btnSpace);
 
     // 【修改点 4】完成键：亮橙色 (品牌主色调)
     QPushButton *btnEnter = new QPushButton("完成");
     btnEnter->setFixedSize(130, 50);
-    btnEnter->setStyleSheet(
-                "QPushButton { "
-                "   background-color: #FF8C00; " // 亮橙色
-                "   color: white; "
-                "   font-weight: bold; "
-                "   border-radius: 6px; "
-                "   border-bottom: 3px solid #E65100; " // 深橙色阴影
-                "   font-size: 20px; "
-                "}"
-                "QPushButton:pressed { "
-                "   background-color: #F57C00; "
-                "   border-bottom: 0px; margin-top: 3px; "
-                "}"
-                );
+    BrandStyle::setButton(btnEnter, BrandStyle::Look(QColor("#FF8C00"), 6).pressed(QColor("#F57C00")).edge(QColor("#E65100"), 3),
+                          Qt::white, 20, true);
     connect(btnEnter, SIGNAL(clicked()), this, SLOT(onButtonClicked()));
     row4->addWidget(btnEnter);
 
@@ -200,16 +152,17 @@ void SoftKeyboard::updateKeyLabels() {
         btnMode->setText("ABC");
         btnShift->setEnabled(false);
         // 数字模式下，Shift变灰
-        btnShift->setStyleSheet("QPushButton { background-color: #5D4037; color: #8D6E63; border:none; border-radius: 6px;}");
+        BrandStyle::setButton(btnShift, BrandStyle::Look(QColor("#5D4037"), 6), QColor("#8D6E63"), 18);
     } else {
         btnMode->setText("123");
         btnShift->setEnabled(true);
         if(isCapital) {
             // Shift 激活：变成亮橙色，提示正在大写模式
-            btnShift->setStyleSheet("QPushButton { background-color: #FF8C00; color: white; border-radius: 6px; border-bottom: 3px solid #E65100; font-weight: bold;}");
+            BrandStyle::setButton(btnShift, BrandStyle::Look(QColor("#FF8C00"), 6).pressed(QColor("#E65100")).edge(QColor("#E65100"), 3),
+                                  Qt::white, 18, true);
         } else {
             // Shift 普通：恢复咖啡色
-            btnShift->setStyleSheet("QPushButton { background-color: #8D6E63; color: white; border-radius: 6px; border-bottom: 3px solid #5D4037; font-weight: bold;}");
+            BrandStyle::setButton(btnShift, funcKeyLook(), Qt::white, 18, true);
         }
     }
 }
@@ -0,0 +1,45 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <stddef.h>
+
+// 单生产者 / 单消费者无锁环形队列
+// 生产者只写 m_head，消费者只写 m_tail，两边都不需要加锁；
+// 容量 N 必须是 2 的幂，队列满时 push 返回 false，由生产者决定丢弃还是重试
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() : m_head(0), m_tail(0) {}
+
+    // 只能在生产者线程调用
+    bool push(const T &item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == N) return false;
+        m_items[head & (N - 1)] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能在消费者线程调用
+    bool pop(T *item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) return false;
+        *item = m_items[tail & (N - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T m_items[N];
+    // 头尾分在不同缓存行，避免两个线程互相打脏
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+#endif // SPSCRING_H
@@ -0,0 +1,100 @@
+#include "startup.h"
+#include "boottrace.h"
+#include <QEventLoop>
+#include <QtConcurrent>
+#include <QDebug>
+
+StartupSequencer::StartupSequencer(QObject *parent) : QObject(parent)
+{
+    m_clock.start();
+}
+
+void StartupSequencer::runInBackground(const QString &name, std::function<void()> work)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        Phase phase = { -1, -1, 0, true };
+        m_phases.insert(name, phase);
+        m_order.append(name);
+    }
+    QtConcurrent::run([=]() {
+        qint64 start = m_clock.elapsed();
+        BootTrace::instance()->begin(name);
+        work();
+        BootTrace::instance()->end(name);
+        {
+            QMutexLocker locker(&m_mutex);
+            Phase &phase = m_phases[name];
+            phase.startMs = start;
+            phase.endMs = m_clock.elapsed();
+        }
+        // 跨线程发信号，接收方在 GUI 线程排队处理
+        emit phaseFinished(name);
+    });
+}
+
+void StartupSequencer::begin(const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+    BootTrace::instance()->begin(name);
+    Phase phase = { m_clock.elapsed(), -1, 0, false };
+    m_phases.insert(name, phase);
+    m_order.append(name);
+}
+
+void StartupSequencer::end(const QString &name)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_phases.contains(name)) return;
+        m_phases[name].endMs = m_clock.elapsed();
+    }
+    BootTrace::instance()->end(name);
+    emit phaseFinished(name);
+}
+
+bool StartupSequencer::isDone(const QString &name) const
+{
+    QMutexLocker locker(&m_mutex);
+    QMap<QString, Phase>::const_iterator it = m_phases.constFind(name);
+    return it != m_phases.constEnd() && it->endMs >= 0;
+}
+
+qint64 StartupSequencer::waitFor(const QString &name)
+{
+    if (isDone(name)) return 0;
+
+    qint64 start = m_clock.elapsed();
+    QEventLoop loop;
+    connect(this, &StartupSequencer::phaseFinished, &loop, [&](const QString &finished) {
+        if (finished == name) loop.quit();
+    });
+    // 连接建立前刚好完成的话信号已经错过，再查一次
+    if (!isDone(name)) loop.exec();
+
+    qint64 waited = m_clock.elapsed() - start;
+    QMutexLocker locker(&m_mutex);
+    m_phases[name].waitedMs = waited;
+    return waited;
+}
+
+void StartupSequencer::report() const
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 blocked = 0;
+    for (const QString &name : m_order) {
+        const Phase &phase = m_phases[name];
+        blocked += phase.waitedMs;
+        if (phase.endMs < 0) {
+            qDebug().noquote() << QString("[Startup] %1 (%2): still running")
+                                  .arg(name, -10).arg(phase.background ? "bg" : "gui");
+            continue;
+        }
+        qDebug().noquote() << QString("[Startup] %1 (%2): %3 -> %4 ms (%5 ms), GUI waited %6 ms")
+                              .arg(name, -10).arg(phase.background ? "bg" : "gui")
+                              .arg(phase.startMs).arg(phase.endMs).arg(phase.endMs - phase.startMs)
+                              .arg(phase.waitedMs);
+    }
+    qDebug().noquote() << QString("[Startup] interactive after %1 ms (GUI blocked on background work %2 ms)")
+                          .arg(m_clock.elapsed()).arg(blocked);
+}
@@ -0,0 +1,52 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMap>
+#include <QStringList>
+#include <functional>
+
+// 启动编排
+// 相互独立的启动工作 (开数据库、解码菜品图) 丢到线程池并行跑，
+// GUI 线程只做必须在 GUI 线程做的事；需要某一步结果时 waitFor() 跑局部事件循环等它，
+// 等待期间启动画面照常重绘。启动画面一直显示到登录界面真正需要的步骤都完成为止，不再固定等 3 秒
+class StartupSequencer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit StartupSequencer(QObject *parent = nullptr);
+
+    // 后台步骤：work 在线程池里执行
+    void runInBackground(const QString &name, std::function<void()> work);
+    // GUI 线程上的步骤：begin / end 包住
+    void begin(const QString &name);
+    void end(const QString &name);
+
+    bool isDone(const QString &name) const;
+    // 等某个后台步骤完成，返回在 GUI 线程上等了多少毫秒
+    qint64 waitFor(const QString &name);
+
+    qint64 elapsed() const { return m_clock.elapsed(); }
+    // 打印各步骤起止时间和到可操作的总耗时
+    void report() const;
+
+signals:
+    void phaseFinished(const QString &name);
+
+private:
+    struct Phase {
+        qint64 startMs;
+        qint64 endMs;       // 未完成为 -1
+        qint64 waitedMs;    // GUI 线程为它阻塞的时间
+        bool background;
+    };
+
+    QElapsedTimer m_clock;
+    mutable QMutex m_mutex;     // m_phases 会被工作线程写
+    QMap<QString, Phase> m_phases;
+    QStringList m_order;        // 按开始顺序
+};
+
+#endif // STARTUP_H
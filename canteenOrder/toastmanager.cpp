@@ -0,0 +1,262 @@
+#include "toastmanager.h"
+#include <QApplication>
+#include <QPainter>
+#include <QPropertyAnimation>
+#include <QFontMetrics>
+#include <QMouseEvent>
+#include <QDebug>
+
+#define TOAST_FADE_MS       180     // 淡入淡出时长
+#define TOAST_PREEMPT_MS    80      // 被高优先级抢占时快速收起
+#define TOAST_MAX_QUEUE     8       // 队列上限，满了丢最旧的低优先级提示
+#define TOAST_PADDING       24
+#define TOAST_MIN_WIDTH     260
+
+// ================== ToastWidget ==================
+
+ToastWidget::ToastWidget(QWidget *parent) : QWidget(parent)
+{
+    m_opacity = 0;
+    setAttribute(Qt::WA_TranslucentBackground);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setFocusPolicy(Qt::NoFocus);
+
+    QFont font = this->font();
+    font.setPixelSize(20);
+    font.setBold(true);
+    setFont(font);
+}
+
+void ToastWidget::setContent(const QString &text, const QColor &fill, const QColor &textColor)
+{
+    m_text = text;
+    m_fill = fill;
+    m_textColor = textColor;
+    update();
+}
+
+void ToastWidget::setText(const QString &text)
+{
+    m_text = text;
+    update();
+}
+
+void ToastWidget::setOpacity(qreal opacity)
+{
+    m_opacity = opacity;
+    update();
+}
+
+void ToastWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setOpacity(m_opacity);
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(m_fill);
+    painter.drawRoundedRect(rect(), 12, 12);
+
+    painter.setPen(m_textColor);
+    painter.drawText(rect().adjusted(TOAST_PADDING, 0, -TOAST_PADDING, 0), Qt::AlignCenter | Qt::TextWordWrap, m_text);
+}
+
+void ToastWidget::mousePressEvent(QMouseEvent *event)
+{
+    event->accept();
+    emit clicked();
+}
+
+// ================== ToastManager ==================
+
+ToastManager *ToastManager::m_instance = nullptr;
+
+ToastManager *ToastManager::instance()
+{
+    if (!m_instance) m_instance = new ToastManager(qApp);
+    return m_instance;
+}
+
+ToastManager::ToastManager(QObject *parent) : QObject(parent)
+{
+    m_showing = false;
+    m_leaving = false;
+    m_anim = new QPropertyAnimation(this);
+    m_anim->setPropertyName("opacity");
+    connect(m_anim, SIGNAL(finished()), this, SLOT(onFadeOutFinished()));
+
+    m_holdTimer.setSingleShot(true);
+    connect(&m_holdTimer, &QTimer::timeout, this, [=](){ fadeOut(TOAST_FADE_MS); });
+}
+
+void ToastManager::show(const QString &text, Priority priority, const QString &key, int durationMs)
+{
+    Toast toast;
+    toast.text = text;
+    toast.key = key.isEmpty() ? text : key;
+    toast.priority = priority;
+    toast.count = 1;
+    if (durationMs > 0) {
+        toast.durationMs = durationMs;
+    } else {
+        // 取餐提醒多停一会儿，用户可能不在屏幕前
+        toast.durationMs = priority == Urgent ? 8000 : (priority == Warning ? 3000 : 2000);
+    }
+
+    // 1. 和正在显示的是同一条：更新文字、计数加一、重新计时
+    if (m_showing && !m_leaving && m_current.key == toast.key) {
+        m_current.text = toast.text;
+        m_current.count++;
+        m_current.durationMs = qMax(m_current.durationMs, toast.durationMs);
+        if (m_widget) m_widget->setText(displayText(m_current));
+        m_holdTimer.start(m_current.durationMs);
+        return;
+    }
+
+    // 2. 和队列里的合并
+    for (int i = 0; i < m_queue.size(); ++i) {
+        if (m_queue[i].key == toast.key) {
+            Toast merged = m_queue.takeAt(i);
+            merged.text = toast.text;
+            merged.count++;
+            merged.priority = qMax(merged.priority, toast.priority);
+            merged.durationMs = qMax(merged.durationMs, toast.durationMs);
+            enqueue(merged);
+            return;
+        }
+    }
+
+    enqueue(toast);
+
+    // 3. 高优先级抢占：当前这条快速收起，剩下的时间不要了，重新排到队里
+    if (m_showing && !m_leaving && toast.priority > m_current.priority) {
+        enqueue(m_current);
+        fadeOut(TOAST_PREEMPT_MS);
+        return;
+    }
+
+    if (!m_showing) QTimer::singleShot(0, this, SLOT(showNext()));
+}
+
+void ToastManager::enqueue(const Toast &toast)
+{
+    int pos = 0;
+    while (pos < m_queue.size() && m_queue[pos].priority >= toast.priority) ++pos;
+    m_queue.insert(pos, toast);
+
+    if (m_queue.size() > TOAST_MAX_QUEUE) {
+        qDebug() << "[Toast] queue full, drop:" << m_queue.last().text;
+        m_queue.removeLast();
+    }
+}
+
+void ToastManager::dismiss()
+{
+    if (m_showing && !m_leaving) fadeOut(TOAST_FADE_MS);
+}
+
+void ToastManager::showNext()
+{
+    if (m_showing || m_queue.isEmpty()) return;
+    present(m_queue.takeFirst());
+}
+
+void ToastManager::present(const Toast &toast)
+{
+    QWidget *host = hostWindow();
+    if (!host) {
+        // 还没有任何窗口 (启动早期)，只打日志
+        qDebug() << "[Toast] no window:" << toast.text;
+        return;
+    }
+
+    // 登录界面和主界面是两个顶层窗口，每次显示前挂到当前窗口上
+    if (!m_widget) {
+        m_widget = new ToastWidget(host);
+        connect(m_widget.data(), &ToastWidget::clicked, this, &ToastManager::dismiss);
+        m_anim->setTargetObject(m_widget);
+    } else if (m_widget->parentWidget() != host) {
+        m_widget->setParent(host);
+    }
+
+    QColor fill, textColor(Qt::white);
+    switch (toast.priority) {
+    case Urgent:  fill = QColor("#E65100"); break;
+    case Warning: fill = QColor("#FF8C00"); break;
+    default:      fill = QColor("#5D4037"); break;
+    }
+    fill.setAlpha(235);
+
+    m_current = toast;
+    m_showing = true;
+    m_leaving = false;
+
+    QString text = displayText(toast);
+    QFontMetrics fm(m_widget->font());
+    QRect textRect = fm.boundingRect(QRect(0, 0, host->width() - 80 - 2 * TOAST_PADDING, host->height()),
+                                     Qt::AlignCenter | Qt::TextWordWrap, text);
+    int w = qMax(TOAST_MIN_WIDTH, textRect.width() + 2 * TOAST_PADDING);
+    int h = textRect.height() + TOAST_PADDING;
+    // 放在上部，避开底部的软键盘
+    m_widget->setGeometry((host->width() - w) / 2, host->height() / 6, w, h);
+    m_widget->setContent(text, fill, textColor);
+    m_widget->setOpacity(0);
+    m_widget->show();
+    m_widget->raise();
+
+    m_anim->stop();
+    m_anim->setDuration(TOAST_FADE_MS);
+    m_anim->setStartValue(0.0);
+    m_anim->setEndValue(1.0);
+    m_anim->start();
+
+    m_holdTimer.start(toast.durationMs);
+}
+
+void ToastManager::fadeOut(int ms)
+{
+    if (!m_showing || m_leaving) return;
+    m_leaving = true;
+    m_holdTimer.stop();
+
+    if (!m_widget) {
+        onFadeOutFinished();
+        return;
+    }
+    m_anim->stop();
+    m_anim->setDuration(ms);
+    m_anim->setStartValue(m_widget->opacity());
+    m_anim->setEndValue(0.0);
+    m_anim->start();
+}
+
+void ToastManager::onFadeOutFinished()
+{
+    // 淡入结束也会到这里，只处理淡出
+    if (!m_leaving) return;
+
+    if (m_widget) m_widget->hide();
+    m_showing = false;
+    m_leaving = false;
+    showNext();
+}
+
+QWidget *ToastManager::hostWindow() const
+{
+    QWidget *active = QApplication::activeWindow();
+    if (active && active->isVisible()) return active;
+
+    foreach (QWidget *w, QApplication::topLevelWidgets()) {
+        if (w->isVisible() && !w->isMinimized() && w->isWindow() && w->windowType() != Qt::Popup
+                && w->width() > TOAST_MIN_WIDTH) {
+            return w;
+        }
+    }
+    return nullptr;
+}
+
+QString ToastManager::displayText(const Toast &toast) const
+{
+    if (toast.count <= 1) return toast.text;
+    return QString("%1  ×%2").arg(toast.text).arg(toast.count);
+}
@@ -0,0 +1,91 @@
+#ifndef TOASTMANAGER_H
+#define TOASTMANAGER_H
+
+#include <QObject>
+#include <QWidget>
+#include <QPointer>
+#include <QTimer>
+#include <QList>
+#include <QColor>
+
+class QPropertyAnimation;
+
+// 浮层提示条本体：画在当前窗口上面的圆角色块，透明度由动画控制，点一下就收起
+class ToastWidget : public QWidget
+{
+    Q_OBJECT
+    Q_PROPERTY(qreal opacity READ opacity WRITE setOpacity)
+public:
+    explicit ToastWidget(QWidget *parent = nullptr);
+
+    void setContent(const QString &text, const QColor &fill, const QColor &textColor);
+    void setText(const QString &text);
+    qreal opacity() const { return m_opacity; }
+    void setOpacity(qreal opacity);
+
+signals:
+    void clicked();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    QString m_text;
+    QColor m_fill;
+    QColor m_textColor;
+    qreal m_opacity;
+};
+
+// 非阻塞提示管理 (代替 QMessageBox::exec)
+// exec() 会开嵌套事件循环，网络和定时器回调在里面重入，画面也停住；几条通知同时来还会叠好几个框。
+// 这里所有提示排成一个队列，一次只显示一条：
+//   - 同一个 key 的提示合并成一条，后面显示 “×N”，并重新计时
+//   - 高优先级 (取餐提醒) 插到队首，正在显示的低优先级提示让位后重新排队
+//   - 淡入淡出用属性动画，调用方 show() 之后立即返回
+class ToastManager : public QObject
+{
+    Q_OBJECT
+public:
+    enum Priority { Info = 0, Warning, Urgent };
+
+    static ToastManager *instance();
+
+    // key 为空时用文字本身做合并依据；durationMs <= 0 用该优先级的默认时长
+    void show(const QString &text, Priority priority = Info, const QString &key = QString(), int durationMs = 0);
+    void dismiss();             // 收起当前这条，接着显示下一条
+    int pending() const { return m_queue.size(); }
+
+private slots:
+    void showNext();
+    void onFadeOutFinished();
+
+private:
+    explicit ToastManager(QObject *parent = nullptr);
+
+    struct Toast {
+        QString text;
+        QString key;
+        Priority priority;
+        int durationMs;
+        int count;
+    };
+
+    void enqueue(const Toast &toast);
+    void present(const Toast &toast);
+    void fadeOut(int ms);
+    QWidget *hostWindow() const;
+    QString displayText(const Toast &toast) const;
+
+    static ToastManager *m_instance;
+
+    QList<Toast> m_queue;       // 按优先级从高到低，同级先来先显示
+    Toast m_current;
+    bool m_showing;
+    bool m_leaving;             // 正在淡出
+    QPointer<ToastWidget> m_widget;
+    QPropertyAnimation *m_anim;
+    QTimer m_holdTimer;
+};
+
+#endif // TOASTMANAGER_H
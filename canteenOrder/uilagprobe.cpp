@@ -0,0 +1,36 @@
+#include "uilagprobe.h"
+
+UiLagProbe::UiLagProbe(int intervalMs, QObject *parent) : QObject(parent), m_interval(intervalMs)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(intervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &UiLagProbe::onTick);
+    m_last = m_total = m_maxLag = 0;
+    m_samples = m_stalls = 0;
+}
+
+void UiLagProbe::start()
+{
+    m_last = m_total = m_maxLag = 0;
+    m_samples = m_stalls = 0;
+    m_clock.start();
+    m_timer.start();
+}
+
+void UiLagProbe::stop()
+{
+    m_timer.stop();
+}
+
+void UiLagProbe::onTick()
+{
+    qint64 now = m_clock.elapsed();
+    qint64 interval = now - m_last;
+    m_last = now;
+
+    qint64 lag = interval - m_interval;
+    if (lag > m_maxLag) m_maxLag = lag;
+    if (lag > STALL_MS) ++m_stalls;
+    m_total += interval;
+    ++m_samples;
+}
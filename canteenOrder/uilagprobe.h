@@ -0,0 +1,41 @@
+#ifndef UILAGPROBE_H
+#define UILAGPROBE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+// 界面卡顿探针
+// 在 GUI 线程上按固定间隔 (默认一帧 16ms) 触发定时器，统计实际间隔比预期多出来的时间。
+// 事件循环被阻塞时定时器会迟到，迟到量就是用户能感觉到的卡顿。
+class UiLagProbe : public QObject
+{
+    Q_OBJECT
+public:
+    explicit UiLagProbe(int intervalMs = 16, QObject *parent = nullptr);
+
+    void start();
+    void stop();
+
+    int samples() const { return m_samples; }
+    qint64 maxLagMs() const { return m_maxLag; }
+    double avgIntervalMs() const { return m_samples ? (double)m_total / m_samples : 0; }
+    int stalls() const { return m_stalls; } // 超过 STALL_MS 的次数
+
+    static const int STALL_MS = 50;         // 超过 50ms (约 3 帧) 视为可见卡顿
+
+private slots:
+    void onTick();
+
+private:
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    int m_interval;
+    qint64 m_last;
+    qint64 m_total;
+    qint64 m_maxLag;
+    int m_samples;
+    int m_stalls;
+};
+
+#endif // UILAGPROBE_H
@@ -0,0 +1,459 @@
+#include "videodecoder.h"
+#include "yuvconvert.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDebug>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <linux/fb.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+#include <libavutil/mathematics.h>
+}
+
+// 菜品视频静音播放：1 = 音轨在解复用时直接丢弃，画面照常由本解码器出；
+// 0 = 带音轨的片子交给 mplayer 播 (有声音，但没有进程内解码的好处)
+#ifndef DISH_VIDEO_MUTE
+#define DISH_VIDEO_MUTE 1
+#endif
+
+// --- 帧缓冲输出 ---
+FramebufferSink::~FramebufferSink()
+{
+    if (m_map) ::munmap(m_map, m_mapLen);
+}
+
+bool FramebufferSink::open(const char *device, const QRect &screenRect)
+{
+    int fd = ::open(device, O_RDWR | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct fb_var_screeninfo var;
+    struct fb_fix_screeninfo fix;
+    if (::ioctl(fd, FBIOGET_VSCREENINFO, &var) < 0 || ::ioctl(fd, FBIOGET_FSCREENINFO, &fix) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    if (var.bits_per_pixel == 16) {
+        m_format = Rgb565;
+    } else if (var.bits_per_pixel == 32 && var.red.offset == 16 && var.blue.offset == 0) {
+        m_format = Argb32;
+    } else {
+        qDebug() << "FramebufferSink: unsupported pixel layout, bpp" << var.bits_per_pixel;
+        ::close(fd);
+        return false;
+    }
+
+    m_mapLen = fix.smem_len;
+    void *map = ::mmap(NULL, m_mapLen, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    m_map = (uchar *)map;
+    m_lineLength = fix.line_length;
+    m_bytesPerPixel = var.bits_per_pixel / 8;
+    // 只允许写可见区域；双缓冲的帧缓冲按当前显示的那一屏偏移
+    m_rect = screenRect & QRect(0, 0, var.xres, var.yres);
+    m_rect.translate(var.xoffset, var.yoffset);
+
+    // 先把整块区域清黑，保持宽高比留下的边不会露出旧内容
+    for (int y = 0; y < m_rect.height(); ++y) {
+        memset(m_map + (m_rect.y() + y) * m_lineLength + m_rect.x() * m_bytesPerPixel, 0,
+               m_rect.width() * m_bytesPerPixel);
+    }
+    return !m_rect.isEmpty();
+}
+
+uchar *FramebufferSink::buffer(int *stride)
+{
+    *stride = m_lineLength;
+    return m_map + m_rect.y() * m_lineLength + m_rect.x() * m_bytesPerPixel;
+}
+
+// --- QImage 输出 ---
+ImageSink::ImageSink(const QSize &size, QObject *parent) : QObject(parent)
+{
+    for (int i = 0; i < 2; ++i) {
+        m_images[i] = QImage(size, QImage::Format_RGB32);
+        m_images[i].fill(Qt::black);
+    }
+}
+
+uchar *ImageSink::buffer(int *stride)
+{
+    QImage &img = m_images[m_current];
+    *stride = img.bytesPerLine();
+    return img.bits(); // 界面还持有同一张图时这里会分离出一份拷贝
+}
+
+void ImageSink::present()
+{
+    emit frameReady(m_images[m_current]);
+    m_current ^= 1;
+}
+
+// --- 解码器 ---
+class VideoDecoder::Worker : public QThread
+{
+public:
+    Worker(VideoDecoder *decoder, void (VideoDecoder::*loop)()) : m_decoder(decoder), m_loop(loop) {}
+
+protected:
+    void run() override { (m_decoder->*m_loop)(); }
+
+private:
+    VideoDecoder *m_decoder;
+    void (VideoDecoder::*m_loop)();
+};
+
+VideoDecoder::VideoDecoder(QObject *parent) : QObject(parent), m_positionMs(0)
+{
+#if LIBAVFORMAT_VERSION_INT < AV_VERSION_INT(58, 9, 100)
+    static bool registered = false;
+    if (!registered) {
+        av_register_all();
+        registered = true;
+    }
+#endif
+}
+
+VideoDecoder::~VideoDecoder()
+{
+    close();
+}
+
+bool VideoDecoder::open(const QString &path, FrameSink *sink)
+{
+    close();
+    m_sink = sink;
+
+    QByteArray file = QFile::encodeName(path);
+    if (avformat_open_input(&m_fmt, file.constData(), nullptr, nullptr) < 0) {
+        qDebug() << "VideoDecoder: cannot open" << path;
+        close();
+        return false;
+    }
+    if (avformat_find_stream_info(m_fmt, nullptr) < 0) {
+        qDebug() << "VideoDecoder: no stream info" << path;
+        close();
+        return false;
+    }
+    // 本解码器只出画面不出声：默认明确丢弃音轨 (点餐屏静音播放)，关掉 DISH_VIDEO_MUTE 则交给 mplayer 出声
+    int audio = av_find_best_stream(m_fmt, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (audio >= 0) {
+#if DISH_VIDEO_MUTE
+        for (unsigned i = 0; i < m_fmt->nb_streams; ++i) {
+            if (m_fmt->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) m_fmt->streams[i]->discard = AVDISCARD_ALL;
+        }
+        qDebug() << "VideoDecoder: audio track muted" << path;
+#else
+        qDebug() << "VideoDecoder: has audio, leave to mplayer" << path;
+        close();
+        return false;
+#endif
+    }
+
+#if LIBAVFORMAT_VERSION_MAJOR >= 59
+    const AVCodec *dec = nullptr;
+#else
+    AVCodec *dec = nullptr;
+#endif
+    m_stream = av_find_best_stream(m_fmt, AVMEDIA_TYPE_VIDEO, -1, -1, &dec, 0);
+    if (m_stream < 0 || !dec) {
+        qDebug() << "VideoDecoder: no video stream" << path;
+        close();
+        return false;
+    }
+
+    m_codec = avcodec_alloc_context3(dec);
+    avcodec_parameters_to_context(m_codec, m_fmt->streams[m_stream]->codecpar);
+    m_codec->thread_count = 0; // 按 CPU 核数开帧级 / 片级解码线程
+    if (avcodec_open2(m_codec, dec, nullptr) < 0) {
+        qDebug() << "VideoDecoder: cannot open codec" << dec->name;
+        close();
+        return false;
+    }
+    m_packet = av_packet_alloc();
+    m_durationMs = m_fmt->duration > 0 ? m_fmt->duration / 1000 : 0; // AV_TIME_BASE 为微秒
+
+    // 保持宽高比居中
+    QSize area = m_sink->size();
+    QSize video(m_codec->width, m_codec->height);
+    video.scale(area, Qt::KeepAspectRatio);
+    m_fitRect = QRect(QPoint((area.width() - video.width()) / 2, (area.height() - video.height()) / 2), video);
+
+    m_positionMs.store(0);
+    m_decodeThread = new Worker(this, &VideoDecoder::decodeLoop);
+    m_presentThread = new Worker(this, &VideoDecoder::presentLoop);
+    m_decodeThread->start();
+    m_presentThread->start();
+    return true;
+}
+
+void VideoDecoder::close()
+{
+    if (m_decodeThread) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stop = true;
+            m_notFull.wakeAll();
+            m_wake.wakeAll();
+        }
+        m_decodeThread->wait();
+        m_presentThread->wait();
+        delete m_decodeThread;
+        delete m_presentThread;
+        m_decodeThread = nullptr;
+        m_presentThread = nullptr;
+    }
+    clearQueue();
+
+    avcodec_free_context(&m_codec);
+    avformat_close_input(&m_fmt);
+    av_packet_free(&m_packet);
+    sws_freeContext(m_sws);
+    m_sws = nullptr;
+    delete m_sink;
+    m_sink = nullptr;
+
+    m_stream = -1;
+    m_durationMs = 0;
+    m_stop = false;
+    m_paused = false;
+    m_eof = false;
+    m_seekMs = -1;
+}
+
+void VideoDecoder::setPaused(bool paused)
+{
+    QMutexLocker locker(&m_mutex);
+    m_paused = paused;
+    m_wake.wakeAll();
+}
+
+void VideoDecoder::seek(qint64 ms)
+{
+    QMutexLocker locker(&m_mutex);
+    m_seekMs = qBound(0LL, ms, m_durationMs > 0 ? m_durationMs : ms);
+    m_notFull.wakeAll();
+    m_wake.wakeAll();
+}
+
+void VideoDecoder::clearQueue()
+{
+    while (!m_queue.isEmpty()) {
+        AVFrame *frame = m_queue.dequeue();
+        av_frame_free(&frame);
+    }
+}
+
+qint64 VideoDecoder::frameMs(const AVFrame *frame) const
+{
+    qint64 pts = frame->best_effort_timestamp;
+    if (pts == AV_NOPTS_VALUE) pts = frame->pts;
+    if (pts == AV_NOPTS_VALUE) return 0;
+
+    const AVStream *st = m_fmt->streams[m_stream];
+    if (st->start_time != AV_NOPTS_VALUE) pts -= st->start_time;
+    return av_rescale_q(pts, st->time_base, AVRational{1, 1000});
+}
+
+// 取出下一帧；文件结束或解码出错返回 false
+bool VideoDecoder::decodeOne(AVFrame *frame)
+{
+    forever {
+        int ret = avcodec_receive_frame(m_codec, frame);
+        if (ret == 0) return true;
+        if (ret != AVERROR(EAGAIN)) return false;
+
+        if (av_read_frame(m_fmt, m_packet) < 0) {
+            avcodec_send_packet(m_codec, nullptr); // 冲出解码器里剩下的帧
+            continue;
+        }
+        if (m_packet->stream_index == m_stream) {
+            avcodec_send_packet(m_codec, m_packet); // 坏包直接跳过
+        }
+        av_packet_unref(m_packet);
+    }
+}
+
+void VideoDecoder::decodeLoop()
+{
+    qint64 dropBeforeMs = -1;
+
+    forever {
+        qint64 target = -1;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_stop) return;
+            if (m_seekMs >= 0) {
+                target = m_seekMs;
+                m_seekMs = -1;
+                clearQueue();
+                m_eof = false;
+                ++m_epoch;
+                m_wake.wakeAll();
+            }
+        }
+
+        if (target >= 0) {
+            // 跳到目标之前最近的关键帧，之后丢弃目标时间之前的帧
+            const AVStream *st = m_fmt->streams[m_stream];
+            qint64 ts = av_rescale_q(target, AVRational{1, 1000}, st->time_base);
+            if (st->start_time != AV_NOPTS_VALUE) ts += st->start_time;
+            av_seek_frame(m_fmt, m_stream, ts, AVSEEK_FLAG_BACKWARD);
+            avcodec_flush_buffers(m_codec);
+            dropBeforeMs = target;
+        }
+
+        AVFrame *frame = av_frame_alloc();
+        if (!decodeOne(frame)) {
+            av_frame_free(&frame);
+            QMutexLocker locker(&m_mutex);
+            m_eof = true;
+            m_wake.wakeAll();
+            while (!m_stop && m_seekMs < 0) m_notFull.wait(&m_mutex);
+            continue;
+        }
+
+        if (dropBeforeMs >= 0) {
+            if (frameMs(frame) < dropBeforeMs) {
+                av_frame_free(&frame);
+                continue;
+            }
+            dropBeforeMs = -1;
+        }
+
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.size() >= FRAME_QUEUE && !m_stop && m_seekMs < 0) m_notFull.wait(&m_mutex);
+        if (m_stop || m_seekMs >= 0) {
+            av_frame_free(&frame);
+            continue;
+        }
+        m_queue.enqueue(frame);
+        m_wake.wakeAll();
+    }
+}
+
+void VideoDecoder::render(AVFrame *frame)
+{
+    bool rgb565 = (m_sink->format() == FrameSink::Rgb565);
+    int stride = 0;
+    uchar *base = m_sink->buffer(&stride);
+    uchar *origin = base + m_fitRect.y() * stride + m_fitRect.x() * (rgb565 ? 2 : 4);
+
+    // 常见的 YUV420P 片源走自己的 SIMD 内核，其他像素格式 (含全范围的 YUVJ) 仍交给 swscale
+    if (frame->format == AV_PIX_FMT_YUV420P) {
+        YuvConvert::Planes src = { frame->data[0], frame->data[1], frame->data[2],
+                                   frame->linesize[0], frame->linesize[1], frame->linesize[2],
+                                   frame->width, frame->height };
+        if (src.width != m_fitRect.width() || src.height != m_fitRect.height()) {
+            if (m_scaled.width != m_fitRect.width() || m_scaled.height != m_fitRect.height()) {
+                m_scaled.resize(m_fitRect.width(), m_fitRect.height());
+            }
+            YuvConvert::scale(src, &m_scaled);
+            src = m_scaled.planes();
+        }
+        if (rgb565) {
+            YuvConvert::toRgb565(src, origin, stride);
+        } else {
+            YuvConvert::toArgb32(src, origin, stride);
+        }
+        m_sink->present();
+        return;
+    }
+
+    m_sws = sws_getCachedContext(m_sws, frame->width, frame->height, (AVPixelFormat)frame->format,
+                                 m_fitRect.width(), m_fitRect.height(),
+                                 rgb565 ? AV_PIX_FMT_RGB565LE : AV_PIX_FMT_BGRA,
+                                 SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!m_sws) return;
+
+    uint8_t *dst[4] = { origin, nullptr, nullptr, nullptr };
+    int dstStride[4] = { stride, 0, 0, 0 };
+    sws_scale(m_sws, frame->data, frame->linesize, 0, frame->height, dst, dstStride);
+    m_sink->present();
+}
+
+void VideoDecoder::presentLoop()
+{
+    QElapsedTimer clock;
+    clock.start();
+    qint64 baseNs = -1;   // PTS 到本地时钟的映射：显示时刻 = baseNs + pts
+    int epoch = -1;
+    int previewEpoch = -1;
+    bool first = true;
+    bool endReported = false;
+    int dropped = 0;
+
+    QMutexLocker locker(&m_mutex);
+    while (!m_stop) {
+        if (epoch != m_epoch) {
+            epoch = m_epoch;
+            baseNs = -1;
+            endReported = false;
+        }
+
+        if (m_queue.isEmpty()) {
+            if (m_eof && !endReported) {
+                endReported = true;
+                locker.unlock();
+                qDebug() << "VideoDecoder: end of stream," << dropped << "late frames dropped";
+                emit finished();
+                locker.relock();
+                continue;
+            }
+            m_wake.wait(&m_mutex);
+            continue;
+        }
+
+        AVFrame *frame = m_queue.head();
+        qint64 ms = frameMs(frame);
+        bool show = true;
+
+        if (m_paused) {
+            // 暂停时只在跳转后显示一帧目标画面，方便拖动定位
+            if (previewEpoch == epoch) {
+                m_wake.wait(&m_mutex);
+                baseNs = -1; // 恢复后重新对时
+                continue;
+            }
+            previewEpoch = epoch;
+        } else {
+            qint64 now = clock.nsecsElapsed();
+            if (baseNs < 0) baseNs = now - ms * 1000000LL;
+            qint64 lateNs = now - (baseNs + ms * 1000000LL);
+            if (lateNs < -1000000LL) {
+                m_wake.wait(&m_mutex, (unsigned long)(-lateNs / 1000000));
+                continue; // 醒来后重新检查暂停 / 跳转 / 停止
+            }
+            show = first || lateNs < LATE_DROP_MS * 1000000LL;
+        }
+
+        m_queue.dequeue();
+        m_notFull.wakeOne();
+        locker.unlock();
+
+        if (show) {
+            render(frame);
+            if (first) {
+                first = false;
+                emit firstFrame();
+            }
+        } else {
+            ++dropped;
+        }
+        av_frame_free(&frame);
+        m_positionMs.store(ms);
+        emit positionChanged(ms);
+
+        locker.relock();
+    }
+}
@@ -0,0 +1,144 @@
+#ifndef VIDEODECODER_H
+#define VIDEODECODER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QImage>
+#include <QRect>
+#include <QString>
+#include <atomic>
+#include "yuvconvert.h"
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+// 解码后画面的去处
+class FrameSink
+{
+public:
+    enum Format {
+        Rgb565,  // 16 位帧缓冲
+        Argb32   // 32 位帧缓冲 / QImage::Format_RGB32 (内存顺序 B G R X)
+    };
+
+    virtual ~FrameSink() {}
+    virtual QSize size() const = 0;
+    virtual Format format() const = 0;
+    // 可写的像素缓冲，左上角对应目标区域左上角；写完一帧后调用 present()
+    virtual uchar *buffer(int *stride) = 0;
+    virtual void present() {}
+};
+
+// 直接写 /dev/fb0 中 VideoSurface 对应的矩形，零拷贝
+class FramebufferSink : public FrameSink
+{
+public:
+    ~FramebufferSink();
+    bool open(const char *device, const QRect &screenRect);
+
+    QSize size() const override { return m_rect.size(); }
+    Format format() const override { return m_format; }
+    uchar *buffer(int *stride) override;
+
+private:
+    uchar *m_map = nullptr;
+    size_t m_mapLen = 0;
+    int m_lineLength = 0;
+    int m_bytesPerPixel = 0;
+    QRect m_rect;
+    Format m_format = Rgb565;
+};
+
+// 画到 QImage 里再交给界面绘制 (offscreen / 桌面平台用)
+// 两张图轮换，界面还拿着上一帧时解码线程写另一张
+class ImageSink : public QObject, public FrameSink
+{
+    Q_OBJECT
+public:
+    explicit ImageSink(const QSize &size, QObject *parent = nullptr);
+
+    QSize size() const override { return m_images[0].size(); }
+    Format format() const override { return Argb32; }
+    uchar *buffer(int *stride) override;
+    void present() override;
+
+signals:
+    void frameReady(const QImage &frame);
+
+private:
+    QImage m_images[2];
+    int m_current = 0;
+};
+
+// 进程内视频解码 (libavformat / libavcodec / libswscale)
+// 两级流水线：解码线程读包解码，帧放进小队列；呈现线程按 PTS 对时，缩放转换后写入 FrameSink
+// 所有公开方法都在 GUI 线程调用，信号从工作线程发出 (排队连接)
+class VideoDecoder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit VideoDecoder(QObject *parent = nullptr);
+    ~VideoDecoder();
+
+    // 打开文件并启动线程，sink 的所有权交给解码器；失败时返回 false，调用方退回 mplayer。
+    // 本解码器不出声：音轨默认丢弃 (DISH_VIDEO_MUTE)，设为 0 时带音轨的片子也返回 false
+    bool open(const QString &path, FrameSink *sink);
+    void close();
+    bool isOpen() const { return m_fmt != nullptr; }
+
+    void setPaused(bool paused);
+    void seek(qint64 ms);           // 精确到帧：先跳到之前的关键帧，再丢弃目标时间之前的帧
+    qint64 durationMs() const { return m_durationMs; }
+    qint64 positionMs() const { return m_positionMs.load(); }
+
+    static const int FRAME_QUEUE = 4;      // 解码领先呈现的帧数
+    static const int LATE_DROP_MS = 100;   // 落后超过这个时间的帧不再转换，直接丢弃
+
+signals:
+    void firstFrame();              // 第一帧上屏
+    void positionChanged(qint64 ms);
+    void finished();                // 播放到结尾
+
+private:
+    class Worker;
+
+    void decodeLoop();
+    void presentLoop();
+    bool decodeOne(AVFrame *frame);
+    void render(AVFrame *frame);
+    qint64 frameMs(const AVFrame *frame) const;
+    void clearQueue();
+
+    AVFormatContext *m_fmt = nullptr;
+    AVCodecContext *m_codec = nullptr;
+    AVPacket *m_packet = nullptr;
+    SwsContext *m_sws = nullptr;
+    FrameSink *m_sink = nullptr;
+    int m_stream = -1;
+    qint64 m_durationMs = 0;
+    std::atomic<qint64> m_positionMs;
+    QRect m_fitRect;                // 保持宽高比后在 sink 中的区域
+    YuvConvert::Image m_scaled;     // 缩放中间结果，只在呈现线程使用
+
+    Worker *m_decodeThread = nullptr;
+    Worker *m_presentThread = nullptr;
+
+    // 以下由 m_mutex 保护
+    QMutex m_mutex;
+    QWaitCondition m_notFull;       // 解码线程等待：队列有空位 / 跳转 / 停止
+    QWaitCondition m_wake;          // 呈现线程等待：新帧 / 暂停恢复 / 跳转 / 停止
+    QQueue<AVFrame *> m_queue;
+    bool m_stop = false;
+    bool m_paused = false;
+    bool m_eof = false;
+    qint64 m_seekMs = -1;           // 待处理的跳转目标
+    int m_epoch = 0;                // 每次跳转加一，呈现线程据此重新对时
+};
+
+#endif // VIDEODECODER_H
@@ -0,0 +1,223 @@
+#include "videoio.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#define IO_ALIGN 4096
+#define STREAM_POLL_MS 50   // 跟读已领先足够多时，隔这么久再看一次播放位置
+
+static inline qint64 alignDown(qint64 offset)
+{
+    return offset & ~(qint64)(IO_ALIGN - 1);
+}
+
+void VideoIoThread::warm(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_warmQueue.contains(path)) return;
+    m_warmQueue.append(path);
+    m_cond.wakeOne();
+}
+
+void VideoIoThread::startStream(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    m_streamPath = path;
+    m_streamSerial++;
+    m_permille.store(0);
+    m_warmQueue.removeAll(path); // 跟读会从头读，不用再单独预热
+    m_cond.wakeOne();
+}
+
+void VideoIoThread::stopStream()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_streamPath.isEmpty()) return;
+    m_streamPath.clear();
+    m_streamSerial++;
+    m_cond.wakeOne();
+}
+
+void VideoIoThread::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stop = true;
+    m_cond.wakeOne();
+}
+
+// 预热：让内核把开头读进页缓存。readahead 会等到 I/O 提交完，所以放在本线程里做
+void VideoIoThread::doWarm(const QString &path)
+{
+    QHash<QString, qint64>::const_iterator it = m_lastWarm.constFind(path);
+    if (it != m_lastWarm.constEnd() && m_clock.elapsed() - it.value() < rewarmMs) return;
+
+    int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    qint64 bytes = (::fstat(fd, &st) == 0) ? qMin<qint64>(warmBytes, st.st_size) : warmBytes;
+
+    QElapsedTimer timer;
+    timer.start();
+    posix_fadvise(fd, 0, bytes, POSIX_FADV_WILLNEED);
+    ::readahead(fd, 0, bytes);
+    ::close(fd);
+
+    m_lastWarm.insert(path, m_clock.elapsed());
+    emit warmed(path, bytes, timer.elapsed());
+}
+
+// 跟读一步：播放位置由进度千分比按文件大小估算 (码率大致恒定)
+void VideoIoThread::streamStep(int fd, qint64 size, qint64 *offset)
+{
+    qint64 consumed = size * m_permille.load() / 1000;
+    if (consumed > *offset) {
+        // 播放器跑到了前面 (读得慢，或者往后跳了)，从播放位置重新开始
+        if (!m_behind) m_underruns++;
+        m_behind = true;
+        *offset = alignDown(consumed);
+    } else if (*offset - consumed > 2 * aheadBytes) {
+        *offset = alignDown(consumed); // 往回跳了
+    }
+    if (*offset >= size || *offset >= consumed + aheadBytes) return;
+
+    QElapsedTimer timer;
+    timer.start();
+    ssize_t n = ::pread(fd, m_buffer, chunkBytes, *offset);
+    qint64 ns = timer.nsecsElapsed();
+    qint64 ms = ns / 1000000;
+    if (n <= 0) {
+        *offset = size; // 读错或到头，不再跟读
+        return;
+    }
+
+    *offset += n;
+    m_bytes += n;
+    m_readNs += ns;
+    m_reads++;
+    if (ms > slowReadMs) m_slowReads++;
+    if (ms > m_maxReadMs) m_maxReadMs = ms;
+    if (*offset > consumed) m_behind = false;
+}
+
+void VideoIoThread::run()
+{
+    m_clock.start();
+    void *buffer = nullptr;
+    if (posix_memalign(&buffer, IO_ALIGN, chunkBytes) != 0) return;
+    m_buffer = static_cast<char *>(buffer);
+
+    int fd = -1;
+    qint64 size = 0;
+    qint64 offset = 0;
+    int serial = 0;
+    QString path;
+    QElapsedTimer streamTimer;
+
+    forever {
+        QString warmPath;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_stop) break;
+
+            if (serial != m_streamSerial) {
+                // 换片或停止：先结算上一段
+                if (fd >= 0) {
+                    ::close(fd);
+                    fd = -1;
+                    emit streamFinished(path, m_bytes, streamTimer.elapsed(), m_readNs, m_reads, m_slowReads, m_maxReadMs, m_underruns);
+                }
+                serial = m_streamSerial;
+                path = m_streamPath;
+                if (!path.isEmpty()) {
+                    fd = ::open(QFile::encodeName(path).constData(), O_RDONLY);
+                    struct stat st;
+                    size = (fd >= 0 && ::fstat(fd, &st) == 0) ? st.st_size : 0;
+                    if (fd >= 0) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+                    offset = 0;
+                    m_bytes = 0;
+                    m_readNs = 0;
+                    m_reads = 0;
+                    m_slowReads = 0;
+                    m_maxReadMs = 0;
+                    m_underruns = 0;
+                    m_behind = false;
+                    streamTimer.start();
+                }
+            }
+        }
+
+        // 跟读优先，领先够了才轮到预热
+        if (fd >= 0) {
+            qint64 before = offset;
+            streamStep(fd, size, &offset);
+            if (offset != before && offset < size) continue;
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_stop) break;
+            if (serial != m_streamSerial) continue;
+            if (!m_warmQueue.isEmpty()) {
+                warmPath = m_warmQueue.takeFirst();
+            } else if (fd >= 0) {
+                m_cond.wait(&m_mutex, STREAM_POLL_MS);
+                continue;
+            } else {
+                m_cond.wait(&m_mutex);
+                continue;
+            }
+        }
+        doWarm(warmPath);
+    }
+
+    if (fd >= 0) ::close(fd);
+    free(m_buffer);
+    m_buffer = nullptr;
+}
+
+// --- 管理 ---
+VideoIo* VideoIo::m_instance = nullptr;
+
+VideoIo* VideoIo::instance()
+{
+    if (m_instance == nullptr) {
+        m_instance = new VideoIo();
+    }
+    return m_instance;
+}
+
+VideoIo::VideoIo(QObject *parent) : QObject(parent)
+{
+    m_thread = new VideoIoThread();
+    connect(m_thread, &VideoIoThread::warmed, this, &VideoIo::onWarmed);
+    connect(m_thread, &VideoIoThread::streamFinished, this, &VideoIo::onStreamFinished);
+    m_thread->start(QThread::LowPriority);
+    connect(qApp, &QCoreApplication::aboutToQuit, m_thread, [=](){ m_thread->stop(); }, Qt::DirectConnection);
+}
+
+static double mbPerSecond(qint64 bytes, double ms)
+{
+    return ms > 0 ? bytes / 1048576.0 * 1000.0 / ms : 0;
+}
+
+void VideoIo::onWarmed(const QString &path, qint64 bytes, qint64 elapsedMs)
+{
+    qDebug().noquote() << QString("[VideoIO] warm %1: %2 MB in %3 ms (%4 MB/s)")
+                          .arg(QFileInfo(path).fileName()).arg(bytes / 1048576.0, 0, 'f', 1)
+                          .arg(elapsedMs).arg(mbPerSecond(bytes, elapsedMs), 0, 'f', 1);
+}
+
+void VideoIo::onStreamFinished(const QString &path, qint64 bytes, qint64 elapsedMs, qint64 readNs, int reads,
+                               int slowReads, qint64 maxReadMs, int underruns)
+{
+    qDebug().noquote() << QString("[VideoIO] stream %1: %2 MB in %3 reads over %4 s, read throughput %5 MB/s, "
+                                  "slow reads %6 (max %7 ms), underruns %8")
+                          .arg(QFileInfo(path).fileName()).arg(bytes / 1048576.0, 0, 'f', 1).arg(reads)
+                          .arg(elapsedMs / 1000.0, 0, 'f', 1).arg(mbPerSecond(bytes, readNs / 1e6), 0, 'f', 1)
+                          .arg(slowReads).arg(maxReadMs).arg(underruns);
+}
@@ -0,0 +1,91 @@
+#ifndef VIDEOIO_H
+#define VIDEOIO_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QStringList>
+#include <QHash>
+#include <QElapsedTimer>
+#include <atomic>
+
+// 视频读取线程：SD 卡 / eMMC 上的片子提前读进页缓存，播放器读的时候直接命中
+//  - 预热：浏览列表时对可能要播的片子 posix_fadvise(WILLNEED) + readahead 开头 warmBytes
+//  - 跟读：播放期间按播放进度估算播放器读到的位置，用大块对齐读保持领先 aheadBytes
+class VideoIoThread : public QThread
+{
+    Q_OBJECT
+public:
+    qint64 warmBytes = 8 * 1024 * 1024;
+    int chunkBytes = 1024 * 1024;          // 跟读每次读的大小，按页对齐
+    qint64 aheadBytes = 16 * 1024 * 1024;  // 最多领先播放位置这么多
+    int slowReadMs = 50;                   // 单次读超过这个时间记为一次卡顿
+    int rewarmMs = 60 * 1000;              // 同一个文件这么久之内不重复预热
+
+    void warm(const QString &path);
+    void startStream(const QString &path);
+    void stopStream();
+    void setPlaybackPermille(int permille) { m_permille.store(permille); }
+    void stop();
+
+protected:
+    void run() override;
+
+signals:
+    void warmed(const QString &path, qint64 bytes, qint64 elapsedMs);
+    // 一次播放的跟读统计：underruns 为播放位置越过已读位置的次数 (播放器要自己等磁盘)
+    // readNs 为花在 pread 上的总时间，用来算吞吐
+    void streamFinished(const QString &path, qint64 bytes, qint64 elapsedMs, qint64 readNs, int reads,
+                        int slowReads, qint64 maxReadMs, int underruns);
+
+private:
+    void doWarm(const QString &path);
+    void streamStep(int fd, qint64 size, qint64 *offset);
+
+    QMutex m_mutex;
+    QWaitCondition m_cond;
+    QStringList m_warmQueue;
+    QString m_streamPath;          // 要跟读的文件，空为不跟读
+    int m_streamSerial = 0;        // 每次 startStream / stopStream 加一
+    bool m_stop = false;
+    std::atomic<int> m_permille{0};
+
+    // 以下只在本线程访问
+    QHash<QString, qint64> m_lastWarm;
+    QElapsedTimer m_clock;
+    char *m_buffer = nullptr;
+    qint64 m_bytes = 0;
+    qint64 m_readNs = 0;
+    int m_reads = 0;
+    int m_slowReads = 0;
+    qint64 m_maxReadMs = 0;
+    int m_underruns = 0;
+    bool m_behind = false;
+};
+
+// 视频 I/O 管理：界面只跟它打交道，统计结果打到日志
+class VideoIo : public QObject
+{
+    Q_OBJECT
+public:
+    static VideoIo* instance();
+
+    void warm(const QString &path) { m_thread->warm(path); }
+    void startStream(const QString &path) { m_thread->startStream(path); }
+    void stopStream() { m_thread->stopStream(); }
+    void setPlaybackPermille(int permille) { m_thread->setPlaybackPermille(permille); }
+
+private slots:
+    void onWarmed(const QString &path, qint64 bytes, qint64 elapsedMs);
+    void onStreamFinished(const QString &path, qint64 bytes, qint64 elapsedMs, qint64 readNs, int reads,
+                          int slowReads, qint64 maxReadMs, int underruns);
+
+private:
+    explicit VideoIo(QObject *parent = nullptr);
+    static VideoIo* m_instance;
+
+    VideoIoThread *m_thread;
+};
+
+#endif // VIDEOIO_H
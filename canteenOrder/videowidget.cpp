@@ -1,57 +1,124 @@
 #include "videowidget.h"
+#include "playbackposition.h"
+#include "postercache.h"
+#include "videoio.h"
+#include "mediaproxy.h"
+#include "brandstyle.h"
 #include <QApplication>
 #include <QDebug>
 #include <QScroller>
 #include <QFile>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
-#include <QMessageBox>
 #include <QStringList>
 #include <QPalette>
 #include <QPainter>
+#include <QGuiApplication>
+#include <QScrollBar>
+#ifdef HAVE_FFMPEG
+#include "videodecoder.h"
+#endif
+
+// 视频画面大小，在 VideoSurface (800x400) 中居中
+#define VIDEO_W 640
+#define VIDEO_H 360
+// 列表滚动停下这么久后，预热可见行的视频
+#define WARM_DEBOUNCE_MS 200
+// 进度条刷新间隔，约 30 帧每秒
+#define PROGRESS_FRAME_MS 33
+// 进度条刻度：千分比
+#define SLIDER_MAX 1000
+
+static QString mplayerProgram()
+{
+    if (QFile::exists("/workdir/mplayer")) return "/workdir/mplayer";
+    if (QFile::exists("/usr/bin/mplayer")) return "/usr/bin/mplayer";
+    return "mplayer";
+}
 
+// linuxfb 平台上视频直接写帧缓冲，其他平台 (offscreen、桌面) 画到 QImage
+static bool useFramebuffer()
+{
+#ifdef HAVE_FFMPEG
+    return QGuiApplication::platformName() == "linuxfb";
+#else
+    return true; // mplayer -vo fbdev
+#endif
+}
+
+// 直写帧缓冲时 Qt 不在这里画任何东西，它就是个“透明洞”；
+// 否则画 ImageSink 送来的帧
 class VideoSurface : public QWidget
 {
 public:
-    explicit VideoSurface(QWidget *parent = nullptr) : QWidget(parent) {
+    explicit VideoSurface(bool direct, QWidget *parent = nullptr) : QWidget(parent), m_direct(direct) {
         setAttribute(Qt::WA_OpaquePaintEvent);
         setAttribute(Qt::WA_NoSystemBackground);
-        setAttribute(Qt::WA_PaintOnScreen);
+        if (m_direct) setAttribute(Qt::WA_PaintOnScreen);
+    }
+
+    void setFrame(const QImage &frame) {
+        m_frame = frame;
+        update();
     }
 
 protected:
     void paintEvent(QPaintEvent *) override {
+        if (m_direct) return;
+        QPainter painter(this);
+        painter.fillRect(rect(), Qt::black);
+        if (!m_frame.isNull()) {
+            painter.drawImage((width() - m_frame.width()) / 2, (height() - m_frame.height()) / 2, m_frame);
+        }
     }
 
     QPaintEngine *paintEngine() const override {
-        return nullptr;
+        return m_direct ? nullptr : QWidget::paintEngine();
     }
+
+private:
+    bool m_direct;
+    QImage m_frame;
 };
 
 VideoWidget::VideoWidget(QWidget *parent) : QWidget(parent)
 {
     // 自身不画背景
     this->setAutoFillBackground(false);
-    mplayerProcess = new QProcess(this);
-    mplayerProcess->setProcessChannelMode(QProcess::MergedChannels);
-    connect(mplayerProcess, SIGNAL(readyReadStandardOutput()), this, SLOT(onMPlayerReadOutput()));
-    connect(mplayerProcess, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
-            [=](int, QProcess::ExitStatus){
-        if(m_isPlaying) stopVideo();
+    m_position = new PlaybackPosition();
+    m_parser = new MplayerOutputParser([=](MplayerOutputParser::Event event, qint64 value){
+        onPlayerEvent(event, value);
     });
+    mplayerProcess = nullptr;
+    createPlayerProcess();
 
     // --- 定时器 ---
+    // 只从位置模型取值刷新界面，不向播放器发命令
     progressTimer = new QTimer(this);
-    progressTimer->setInterval(1000);
+    progressTimer->setInterval(PROGRESS_FRAME_MS);
     connect(progressTimer, SIGNAL(timeout()), this, SLOT(updateVideoProgress()));
 
     m_isPlaying = false;
     m_isPaused = false;
     m_isDragging = false;
-    m_totalDuration = 0;
+    m_useDecoder = false;
+    m_waitFirstFrame = false;
+    m_coldStart = false;
+
+#ifdef HAVE_FFMPEG
+    m_decoder = new VideoDecoder(this);
+    connect(m_decoder, &VideoDecoder::positionChanged, this, &VideoWidget::onDecoderPosition);
+    connect(m_decoder, &VideoDecoder::firstFrame, this, &VideoWidget::onFirstFrame);
+    connect(m_decoder, &VideoDecoder::finished, this, [=](){
+        if (m_isPlaying) stopVideo();
+    });
+#endif
 
     initUI();
 
+    // 海报在后台线程里做，做好一张填一张
+    connect(PosterCache::instance(), &PosterCache::posterReady, this, &VideoWidget::onPosterReady);
+
     // === 测试数据 ===
     addDishItem("招牌鳗鱼饭", "精选新鲜鳗鱼，配以秘制酱汁。", "/workdir/videos/manyu.mp4");
     addDishItem("三文鱼刺身", "挪威直供，新鲜厚切三文鱼。", "/workdir/videos/sashimi.mp4");
@@ -59,11 +126,30 @@ VideoWidget::VideoWidget(QWidget *parent) : QWidget(parent)
     addDishItem("日本清酒", "精选清酒，三十年酿造而成。", "/workdir/videos/drink.mp4");
     addDishItem("经典日式豚骨拉面", "大火熬出骨汤，鲜美至极。", "/workdir/videos/romen.mp4");
     addDishItem("铁火卷", "大火慢烤，外焦里内。", "/workdir/videos/sushi2.mp4");
+
+#ifndef HAVE_FFMPEG
+    // 没有进程内解码时每次都靠 mplayer，启动后立刻把它拉起来待命。
+    // 播放时页头和 Tab 栏隐藏，VideoSurface 位于窗口左上角，画面区域可以提前算出
+    QTimer::singleShot(0, this, [=](){
+        QPoint origin((800 - VIDEO_W) / 2, (400 - VIDEO_H) / 2);
+        startPlayer(QRect(window()->mapToGlobal(origin), QSize(VIDEO_W, VIDEO_H)));
+    });
+#endif
+    preloadNext(QString()); // 先预读第一个片子
+    // 列表里的行已经排在队首，目录下其余视频随后慢慢做
+    PosterCache::instance()->prefetchDir(VIDEO_DIR);
 }
 
 VideoWidget::~VideoWidget()
 {
     stopVideo();
+    if (mplayerProcess->state() != QProcess::NotRunning) {
+        mplayerProcess->write("quit\n");
+        // 程序退出或内存紧张释放视频页时才走到这里，给它一点时间释放帧缓冲
+        if(!mplayerProcess->waitForFinished(300)) mplayerProcess->kill();
+    }
+    delete m_parser;
+    delete m_position;
 }
 
 void VideoWidget::initUI()
@@ -93,7 +179,7 @@ void VideoWidget::initUI()
 
     // 1. 上半部：使用自定义的 VideoSurface (800x400)
     // ------------------------------------------------------------
-    videoSurface = new VideoSurface(playerContainer);
+    videoSurface = new VideoSurface(useFramebuffer(), playerContainer);
     videoSurface->setFixedSize(800, 400);
     // 注意：这里不需要设置颜色，因为 paintEvent 被屏蔽了，它就是个“透明洞”
     // 实际上显示的是父容器 playerContainer 的黑色背景，直到 MPlayer 覆盖它
@@ -114,19 +200,13 @@ void VideoWidget::initUI()
 
     btnPlayPause = new QPushButton("||", controlBar);
     btnPlayPause->setFixedSize(50, 50);
-    btnPlayPause->setStyleSheet(
-        "QPushButton { background-color: #FFD161; border-radius: 25px; font-weight: bold; font-size: 20px; color: #333; border: none; }"
-        "QPushButton:pressed { background-color: #FFC107; }"
-    );
+    BrandStyle::setButton(btnPlayPause, BrandStyle::Look(QColor("#FFD161"), 25).pressed(QColor("#FFC107")), QColor("#333333"), 20, true);
     connect(btnPlayPause, SIGNAL(clicked()), this, SLOT(onBtnPlayPauseClicked()));
 
     seekSlider = new QSlider(Qt::Horizontal, controlBar);
     seekSlider->setFixedHeight(40);
-    // Qt5 样式表
-    seekSlider->setStyleSheet(
-        "QSlider::groove:horizontal { border: 1px solid #444; height: 8px; background: #333; border-radius: 4px; }"
-        "QSlider::handle:horizontal { background: #FF8C00; width: 30px; margin: -11px 0; border-radius: 15px; }"
-    );
+    seekSlider->setRange(0, SLIDER_MAX);
+    // 槽和圆形滑块由 BrandStyle 绘制
     connect(seekSlider, SIGNAL(sliderPressed()), this, SLOT(onSliderPressed()));
     connect(seekSlider, SIGNAL(sliderReleased()), this, SLOT(onSliderReleased()));
     connect(seekSlider, SIGNAL(valueChanged(int)), this, SLOT(onSliderMoved(int)));
@@ -134,14 +214,11 @@ void VideoWidget::initUI()
     lblTime = new QLabel("0%", controlBar);
     lblTime->setFixedWidth(50);
     lblTime->setAlignment(Qt::AlignCenter);
-    lblTime->setStyleSheet("color: white; font-weight: bold; font-size: 16px;");
+    BrandStyle::setText(lblTime, Qt::white, 16, true);
 
     QPushButton *btnStop = new QPushButton("退出", controlBar);
     btnStop->setFixedSize(80, 40);
-    btnStop->setStyleSheet(
-        "QPushButton { background-color: #D32F2F; color: white; border-radius: 5px; font-weight: bold; border: none; }"
-        "QPushButton:pressed { background-color: #B71C1C; }"
-    );
+    BrandStyle::setButton(btnStop, BrandStyle::Look(QColor("#D32F2F"), 5).pressed(QColor("#B71C1C")), Qt::white, 20, true);
     connect(btnStop, SIGNAL(clicked()), this, SLOT(onBtnStopClicked()));
 
     barLayout->addWidget(btnPlayPause);
@@ -167,8 +244,17 @@ void VideoWidget::initList()
     listDishes->setFrameShape(QFrame::NoFrame);
     listDishes->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
     // 给列表一个背景色
-    listDishes->setStyleSheet("background-color: #F5F5F5; border: none;");
+    QPalette listPal = listDishes->palette();
+    listPal.setColor(QPalette::Base, QColor("#F5F5F5"));
+    listDishes->setPalette(listPal);
     QScroller::grabGesture(listDishes, QScroller::LeftMouseButtonGesture);
+
+    // 滚动停下后再预热，惯性滚动过程中不去抢存储带宽
+    m_warmTimer = new QTimer(this);
+    m_warmTimer->setSingleShot(true);
+    m_warmTimer->setInterval(WARM_DEBOUNCE_MS);
+    connect(m_warmTimer, SIGNAL(timeout()), this, SLOT(warmVisibleRows()));
+    connect(listDishes->verticalScrollBar(), SIGNAL(valueChanged(int)), m_warmTimer, SLOT(start()));
 }
 
 void VideoWidget::playVideo(const QString &path)
@@ -185,7 +271,7 @@ void VideoWidget::playVideo(const QString &path)
 
     m_isPaused = false;
     m_isDragging = false;
-    m_totalDuration = 0;
+    m_position->reset();
 
     btnPlayPause->setText("||");
     seekSlider->setValue(0);
@@ -193,49 +279,169 @@ void VideoWidget::playVideo(const QString &path)
 
     m_isPlaying = true;
     currentVideoPath = path;
+    m_tapTimer.start();
+
+    // 布局在显示后才会更新，先算好 VideoSurface 的位置
+    mainLayout->activate();
+    preloadNext(path);
+    // 网络视频交给本地代理 (带磁盘分段缓存)，播放器只看到回环地址
+    QString source = path;
+    if (MediaProxy::isRemote(path)) {
+        source = MediaProxy::instance()->localUrl(path);
+    } else {
+        // 播放期间在后台用大块顺序读领先播放位置，mplayer 的 -cache 只在开播后才开始填
+        VideoIo::instance()->startStream(path);
+    }
+    if (startDecoder(source)) return;
+
+    // 常驻进程没起来，或者画面位置和它启动时不一样 (只能重启)，这次就是冷启动
+    QRect rect = videoRect();
+    m_coldStart = (mplayerProcess->state() == QProcess::NotRunning || rect != m_playerRect);
+    if (m_coldStart) startPlayer(rect);
+
+    // 进程还在启动时写入的命令会先缓存，启动完成后送出，这里不用等
+    QString quoted = QString(source).replace('\\', "\\\\").replace('"', "\\\"");
+    sendMplayerCommand(QString("loadfile \"%1\" 0").arg(quoted));
+    m_waitFirstFrame = true;
+}
 
+void VideoWidget::createPlayerProcess()
+{
+    mplayerProcess = new QProcess(this);
+    mplayerProcess->setProcessChannelMode(QProcess::MergedChannels);
+    connect(mplayerProcess, SIGNAL(readyReadStandardOutput()), this, SLOT(onMPlayerReadOutput()));
+    connect(mplayerProcess, SIGNAL(errorOccurred(QProcess::ProcessError)), this, SLOT(onMPlayerError(QProcess::ProcessError)));
+    connect(mplayerProcess, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+            [=](int, QProcess::ExitStatus){
+        // 常驻进程意外退出，下次播放时重新拉起
+        qDebug() << "[Video] mplayer exited";
+        m_playerRect = QRect();
+        m_parser->reset();
+        if(m_isPlaying) stopVideo();
+    });
+}
+
+void VideoWidget::startPlayer(const QRect &rect)
+{
     if (mplayerProcess->state() != QProcess::NotRunning) {
+        // 只有画面区域变了才会走到这里：旧进程直接杀掉，不等它退出
+        disconnect(mplayerProcess, nullptr, this, nullptr);
         mplayerProcess->kill();
-        mplayerProcess->waitForFinished(300);
+        mplayerProcess->deleteLater();
+        mplayerProcess = nullptr;
+        createPlayerProcess();
     }
 
-    QString mplayerProgram = "mplayer";
-    if (QFile::exists("/workdir/mplayer")) mplayerProgram = "/workdir/mplayer";
-    else if (QFile::exists("/usr/bin/mplayer")) mplayerProgram = "/usr/bin/mplayer";
-
     QStringList args;
-    // 使用 fbdev 输出
-    args << "-slave" << "-quiet" << "-vo" << "fbdev";
+    // -idle：播完或 stop 后不退出，等下一个 loadfile
+    // global=6 打开 "EOF code" 输出，用来区分自然播完和 stop
+    // 不加 -quiet：状态行 (每帧一行，\r 结尾) 就是位置来源
+    args << "-idle" << "-slave" << "-msglevel" << "global=6" << "-vo" << "fbdev";
 
     // [坐标参数]
-    // MPlayer 负责往 (80,20) 宽高 640x360 的区域画图
-    // 这个位置正好对应我们的 VideoSurface 的几何中心
-    args << "-x" << "640" << "-y" << "360" << "-geometry" << "80:20";
+    // MPlayer 负责往 VideoSurface 中居中的 640x360 区域画图
+    args << "-x" << QString::number(rect.width()) << "-y" << QString::number(rect.height())
+         << "-geometry" << QString("%1:%2").arg(rect.x()).arg(rect.y());
 
     args << "-zoom" << "-noborder" << "-cache" << "8192";
-    args << path;
 
-    mplayerProcess->start(mplayerProgram, args);
+    m_playerRect = rect;
+    m_parser->reset();
+    mplayerProcess->start(mplayerProgram(), args);
+    qDebug() << "[Video] mplayer idle player starting, area" << rect;
+}
 
-    if(mplayerProcess->waitForStarted(2000)) {
-        progressTimer->start(1000);
-        sendMplayerCommand("get_time_length");
-    } else {
-        stopVideo();
+void VideoWidget::preloadNext(const QString &path)
+{
+    int index = m_clipPaths.indexOf(path) + 1; // path 为空时从第一个开始
+    if (index <= 0 && !path.isEmpty()) return;
+    if (index >= m_clipPaths.size()) return;
+    warmClip(m_clipPaths.at(index));
+}
+
+// 本地文件预热页缓存，网络视频先把开头几段拉进磁盘缓存
+void VideoWidget::warmClip(const QString &path)
+{
+    if (MediaProxy::isRemote(path)) MediaProxy::instance()->prefetch(path);
+    else VideoIo::instance()->warm(path);
+}
+
+// 预热屏幕上能看到的几行：用户接下来点的多半是它们
+void VideoWidget::warmVisibleRows()
+{
+    if (!listDishes->isVisible()) return;
+    QRect area = listDishes->viewport()->rect();
+    for (int row = 0; row < listDishes->count(); ++row) {
+        QListWidgetItem *it = listDishes->item(row);
+        if (!listDishes->visualItemRect(it).intersects(area)) continue;
+        QString path = it->data(Qt::UserRole).toString();
+        if (!path.isEmpty()) warmClip(path);
     }
 }
 
+QRect VideoWidget::videoRect() const
+{
+    QPoint origin((videoSurface->width() - VIDEO_W) / 2, (videoSurface->height() - VIDEO_H) / 2);
+    return QRect(videoSurface->mapToGlobal(origin), QSize(VIDEO_W, VIDEO_H));
+}
+
+bool VideoWidget::startDecoder(const QString &path)
+{
+#ifdef HAVE_FFMPEG
+    QRect rect = videoRect();
+    FrameSink *sink = nullptr;
+    if (useFramebuffer()) {
+        FramebufferSink *fb = new FramebufferSink();
+        if (fb->open("/dev/fb0", rect)) sink = fb;
+        else delete fb;
+    }
+    if (!sink) {
+        ImageSink *image = new ImageSink(rect.size());
+        VideoSurface *surface = static_cast<VideoSurface *>(videoSurface);
+        connect(image, &ImageSink::frameReady, surface, [surface](const QImage &frame){
+            surface->setFrame(frame);
+        });
+        sink = image;
+    }
+
+    if (!m_decoder->open(path, sink)) return false;
+    m_useDecoder = true;
+    m_position->setDuration(m_decoder->durationMs());
+    progressTimer->start();
+    return true;
+#else
+    Q_UNUSED(path);
+    return false;
+#endif
+}
+
+void VideoWidget::onDecoderPosition(qint64 ms)
+{
+    m_position->report(ms);
+}
+
+void VideoWidget::onFirstFrame()
+{
+    qDebug() << "[Video] tap -> first frame" << m_tapTimer.elapsed() << "ms (in-process decoder)";
+}
+
 void VideoWidget::stopVideo()
 {
     if(listDishes->isVisible()) return;
 
     progressTimer->stop();
 
-    if (mplayerProcess->state() != QProcess::NotRunning) {
-        mplayerProcess->write("quit\n");
-        // 给它一点时间退出，否则可能锁死资源
-        if(!mplayerProcess->waitForFinished(300)) mplayerProcess->kill();
+#ifdef HAVE_FFMPEG
+    if (m_useDecoder) {
+        m_decoder->close();
+        m_useDecoder = false;
     }
+#endif
+
+    // 常驻进程只停止播放回到 idle，不退出
+    sendMplayerCommand("stop");
+    VideoIo::instance()->stopStream();
+    m_waitFirstFrame = false;
 
     m_isPlaying = false;
     m_isPaused = false;
@@ -246,101 +452,124 @@ void VideoWidget::stopVideo()
 
     // 强制刷新列表，覆盖掉可能残留的视频数据
     listDishes->update();
+    m_warmTimer->start();
 
     emit videoStopped();
 }
 
+void VideoWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    m_warmTimer->start(); // 切到视频页就开始预热
+}
+
 void VideoWidget::onBtnStopClicked() { stopVideo(); }
 
 void VideoWidget::onBtnPlayPauseClicked()
 {
-    if (mplayerProcess->state() != QProcess::Running) {
+#ifdef HAVE_FFMPEG
+    if (m_useDecoder) {
+        m_isPaused = !m_isPaused;
+        m_decoder->setPaused(m_isPaused);
+        m_position->setPaused(m_isPaused);
+        btnPlayPause->setText(m_isPaused ? " ▶ " : " || ");
+        return;
+    }
+#endif
+    if (mplayerProcess->state() == QProcess::NotRunning) {
         if(!currentVideoPath.isEmpty()) playVideo(currentVideoPath);
         return;
     }
-    progressTimer->stop();
     sendMplayerCommand("pause");
     m_isPaused = !m_isPaused;
-
-    if (m_isPaused) {
-        btnPlayPause->setText(" ▶ ");
-    } else {
-        btnPlayPause->setText(" || ");
-        progressTimer->start(1000);
-    }
+    m_position->setPaused(m_isPaused);
+    btnPlayPause->setText(m_isPaused ? " ▶ " : " || ");
 }
 
 void VideoWidget::updateVideoProgress()
 {
-    if (m_isPlaying && !m_isPaused && !m_isDragging) {
-        sendMplayerCommand("get_percent_pos");
-        if (m_totalDuration <= 0) {
-            sendMplayerCommand("get_time_length");
-        }
-    }
+    if (!m_isPlaying || m_isDragging) return;
+    int value = m_position->permille();
+    VideoIo::instance()->setPlaybackPermille(value);
+    if (seekSlider->value() != value) seekSlider->setValue(value); // 标签在 onSliderMoved 里跟着变
 }
 
 void VideoWidget::onMPlayerReadOutput()
 {
-    while(mplayerProcess->canReadLine()) {
-        QByteArray data = mplayerProcess->readLine();
-        QString line = QString::fromLatin1(data).trimmed();
-        if(line.isEmpty()) continue;
-
-        if(line.startsWith("ANS_PERCENT_POSITION")) {
-            QStringList parts = line.split("=");
-            if(parts.length() >= 2) {
-                bool ok;
-                int percent = parts.last().toInt(&ok);
-                if (ok && !m_isDragging) {
-                    seekSlider->setValue(percent);
-                    QString str = QString("%1%").arg(percent);
-                    if(lblTime->text() != str) lblTime->setText(str);
-                }
-            }
-        }
-        else if (line.startsWith("ANS_LENGTH")) {
-            QStringList parts = line.split("=");
-            if(parts.length() >= 2) {
-                QString valStr = parts.last().trimmed().remove('\'').remove('"');
-                bool ok;
-                double tempVal = valStr.toDouble(&ok);
-                if (ok) {
-                    int durationInt = static_cast<int>(tempVal);
-                    if (durationInt > 1) {
-                        m_totalDuration = durationInt;
-                    }
-                }
-            }
+    // 整块读进栈上缓冲交给解析器，不经过 QByteArray / QString
+    char buf[4096];
+    qint64 n;
+    while ((n = mplayerProcess->read(buf, sizeof(buf))) > 0) {
+        m_parser->feed(buf, (int)n);
+    }
+}
+
+void VideoWidget::onMPlayerError(QProcess::ProcessError error)
+{
+    if (error != QProcess::FailedToStart) return;
+    qDebug() << "[Video] mplayer failed to start:" << mplayerProcess->errorString();
+    m_playerRect = QRect();
+    if (m_isPlaying) stopVideo();
+}
+
+void VideoWidget::onPlayerEvent(int event, qint64 value)
+{
+    switch (event) {
+    case MplayerOutputParser::Status:
+        if (!m_waitFirstFrame) m_position->report(value);
+        break;
+    case MplayerOutputParser::PlaybackStarted:
+        if (m_waitFirstFrame) {
+            m_waitFirstFrame = false;
+            qDebug() << "[Video] tap -> first frame" << m_tapTimer.elapsed() << "ms"
+                     << (m_coldStart ? "(mplayer cold start)" : "(warm mplayer)");
         }
+        // 时长只在开播时问一次
+        sendMplayerCommand("get_time_length");
+        progressTimer->start();
+        break;
+    case MplayerOutputParser::Length:
+        if (value > 1000) m_position->setDuration(value);
+        break;
+    case MplayerOutputParser::Eof:
+        // 1 为自然播完；stop / loadfile 打断时是别的值
+        if (value == 1 && m_isPlaying && !m_waitFirstFrame) stopVideo();
+        break;
     }
 }
 
 void VideoWidget::onSliderPressed()
 {
     m_isDragging = true;
-    progressTimer->stop();
 }
 
 void VideoWidget::onSliderMoved(int value)
 {
-    QString str = QString("%1%").arg(value);
+    QString str = QString("%1%").arg(value * 100 / SLIDER_MAX);
     if(lblTime->text() != str) lblTime->setText(str);
 }
 
 void VideoWidget::onSliderReleased()
 {
     int sliderVal = seekSlider->value();
-    sendMplayerCommand(QString("seek %1 1").arg(sliderVal));
     m_isDragging = false;
-    QTimer::singleShot(1000, [=](){
-        if(m_isPlaying && !m_isPaused) progressTimer->start(1000);
-    });
+    // 先把模型放到目标位置，免得下一条状态行到来前进度条跳回去
+    qint64 targetMs = sliderVal * m_position->durationMs() / SLIDER_MAX;
+    m_position->report(targetMs);
+#ifdef HAVE_FFMPEG
+    if (m_useDecoder) {
+        m_decoder->seek(targetMs);
+        return;
+    }
+#endif
+    // 暂停中跳转保持暂停
+    QString cmd = QString("seek %1 1").arg(sliderVal * 100.0 / SLIDER_MAX, 0, 'f', 1);
+    sendMplayerCommand(m_isPaused ? "pausing_keep " + cmd : cmd);
 }
 
 void VideoWidget::sendMplayerCommand(const QString &cmd)
 {
-    if (mplayerProcess->state() == QProcess::Running) {
+    if (mplayerProcess->state() != QProcess::NotRunning) {
         mplayerProcess->write((cmd + "\n").toLatin1());
     }
 }
@@ -352,28 +581,47 @@ void VideoWidget::onVideoBtnClicked() {
 
 void VideoWidget::addDishItem(const QString &name, const QString &desc, const QString &path) {
     QWidget *w = new QWidget;
-    w->setStyleSheet("background:white; border-bottom:1px solid #ddd;");
+    BrandStyle::setPanel(w, BrandStyle::Look(Qt::white).border(QColor("#DDDDDD"), 1, Qt::BottomEdge));
     QHBoxLayout *mainHBox = new QHBoxLayout(w);
     mainHBox->setContentsMargins(15, 15, 15, 15);
+    if(!path.isEmpty()){
+        // 海报位置先占住，图做好前显示灰底
+        QLabel *lblPoster = new QLabel;
+        lblPoster->setFixedSize(PosterCache::instance()->thumbSize());
+        lblPoster->setAlignment(Qt::AlignCenter);
+        BrandStyle::setPanel(lblPoster, BrandStyle::Look(QColor("#E0E0E0")));
+        QImage poster = PosterCache::instance()->poster(path);
+        if (!poster.isNull()) lblPoster->setPixmap(QPixmap::fromImage(poster));
+        m_posterLabels.insert(path, lblPoster);
+        mainHBox->addWidget(lblPoster);
+    }
     QVBoxLayout *textVBox = new QVBoxLayout();
     QLabel *lblName = new QLabel(name);
-    lblName->setStyleSheet("color: #333; font-weight: bold; font-size: 18px;");
+    BrandStyle::setText(lblName, QColor("#333333"), 18, true);
     QLabel *lblDesc = new QLabel(desc);
-    lblDesc->setStyleSheet("color: #666; font-size: 14px;");
+    BrandStyle::setText(lblDesc, QColor("#666666"), 14);
     lblDesc->setWordWrap(true);
     textVBox->addWidget(lblName);
     textVBox->addWidget(lblDesc);
     mainHBox->addLayout(textVBox);
     mainHBox->addStretch();
     if(!path.isEmpty()){
+        m_clipPaths << path;
         QPushButton *btn = new QPushButton("▶ 播放");
         btn->setProperty("videoPath", path);
         btn->setFixedSize(80, 40);
-        btn->setStyleSheet("background-color: #E3F2FD; color: #1976D2; border: none; border-radius: 4px;");
+        BrandStyle::setButton(btn, BrandStyle::Look(QColor("#E3F2FD"), 4), QColor("#1976D2"), 20, true);
         connect(btn, SIGNAL(clicked()), this, SLOT(onVideoBtnClicked()));
         mainHBox->addWidget(btn);
     }
     QListWidgetItem *it = new QListWidgetItem(listDishes);
     it->setSizeHint(QSize(600, 100));
+    it->setData(Qt::UserRole, path);
     listDishes->setItemWidget(it, w);
 }
+
+void VideoWidget::onPosterReady(const QString &path, const QImage &poster)
+{
+    QLabel *lblPoster = m_posterLabels.value(path);
+    if (lblPoster) lblPoster->setPixmap(QPixmap::fromImage(poster));
+}
@@ -9,6 +9,14 @@
 #include <QPushButton>
 #include <QSlider>
 #include <QLabel>
+#include <QElapsedTimer>
+#include <QHash>
+
+#ifdef HAVE_FFMPEG
+class VideoDecoder;
+#endif
+class PlaybackPosition;
+class MplayerOutputParser;
 
 class VideoWidget : public QWidget
 {
@@ -17,11 +25,15 @@ public:
     explicit VideoWidget(QWidget *parent = nullptr);
     ~VideoWidget();
 
+    // path 可以是本地文件，也可以是 http(s) URL (经本地代理和磁盘缓存播放)
     void addDishItem(const QString &name, const QString &desc, const QString &path);
 
     // [修正] 将 stopVideo 移动到 public，这样主界面切换时可以调用它停止播放
     void stopVideo();
 
+protected:
+    void showEvent(QShowEvent *event) override;
+
 signals:
     void videoStarted();
     void videoStopped();
@@ -34,7 +46,12 @@ private slots:
     void onSliderMoved(int value);
     void updateVideoProgress();
     void onMPlayerReadOutput();
+    void onMPlayerError(QProcess::ProcessError error);
     void onVideoBtnClicked();
+    void onDecoderPosition(qint64 ms);
+    void onFirstFrame();
+    void onPosterReady(const QString &path, const QImage &poster);
+    void warmVisibleRows();
 
 private:
     void initUI();
@@ -42,11 +59,19 @@ private:
     void playVideo(const QString &path);
     // void stopVideo(); // [删除] 这里原来的声明
     void sendMplayerCommand(const QString &cmd);
+    void createPlayerProcess();
+    void startPlayer(const QRect &rect);  // 启动常驻 mplayer (-idle)，画面区域启动后不能再改
+    void onPlayerEvent(int event, qint64 value); // MplayerOutputParser::Event
+    void preloadNext(const QString &path); // 预读列表中 path 之后的片子
+    void warmClip(const QString &path);
+    QRect videoRect() const;        // 视频画面在屏幕上的区域 (VideoSurface 中居中)
+    bool startDecoder(const QString &path);
 
 private:
     // UI 布局与控件
     QVBoxLayout *mainLayout;
     QListWidget *listDishes;
+    QTimer *m_warmTimer;            // 滚动停下后预热可见行
 
     // 播放器容器
     QWidget *playerContainer;
@@ -60,15 +85,27 @@ private:
     QSlider *seekSlider;
     QLabel *lblTime;
 
-    // MPlayer 逻辑
+    // MPlayer 逻辑：进程常驻 (idle + slave)，每次播放只发 loadfile
     QProcess *mplayerProcess;
+    QRect m_playerRect;             // 常驻进程的画面区域
+    MplayerOutputParser *m_parser;
+    PlaybackPosition *m_position;   // mplayer / 解码器推送，进度条按显示帧率读取
     QTimer *progressTimer;
     QString currentVideoPath;
+    QStringList m_clipPaths;        // 列表顺序，用于猜下一个要播的片子
+    QHash<QString, QLabel *> m_posterLabels; // 视频路径 -> 列表行里的海报
+    QElapsedTimer m_tapTimer;       // 点击播放到第一帧
+    bool m_waitFirstFrame;
+    bool m_coldStart;               // 这次播放是否需要新起进程
+
+#ifdef HAVE_FFMPEG
+    VideoDecoder *m_decoder;        // 进程内解码，打不开时退回 mplayer
+#endif
+    bool m_useDecoder;
 
     bool m_isPlaying;
     bool m_isPaused;
     bool m_isDragging;
-    int m_totalDuration;
 };
 
 #endif // VIDEOWIDGET_H
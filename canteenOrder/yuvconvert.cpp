@@ -0,0 +1,591 @@
+#include "yuvconvert.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <atomic>
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define YUV_X86 1
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YUV_NEON 1
+#if defined(__arm__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+// 系数：BT.601 有限范围，6 位定点 (1.164 / 1.596 / 0.391 / 0.813 / 2.018 乘 64)
+// 中间值都落在 int16 内 (只有加 B、R 分量时可能溢出，用饱和加法，结果反正要钳到 255)，
+// 所以 SIMD 在 16 位通道里算，和下面的标量公式逐位一致
+#define YC 74
+#define RV 102
+#define GU 25
+#define GV 52
+#define BU 129
+
+// 一套内核：行转换 + 缩放用的两行混合
+struct YuvKernels {
+    YuvConvert::Isa isa;
+    void (*rowRgb565)(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint16_t *dst, int width);
+    void (*rowArgb32)(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t *dst, int width);
+    // dst = (r0 * (128 - f) + r1 * f + 64) >> 7，f 为 7 位小数 (1..127)
+    void (*blendRows)(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int width, int f);
+};
+
+// --- 标量 (基准) ---
+static inline int clamp255(int x)
+{
+    return x < 0 ? 0 : (x > 255 ? 255 : x);
+}
+
+static inline void yuvPixel(int y, int u, int v, int *r, int *g, int *b)
+{
+    int y1 = (y - 16) * YC + 32;
+    u -= 128;
+    v -= 128;
+    *r = clamp255((y1 + RV * v) >> 6);
+    *g = clamp255((y1 - GU * u - GV * v) >> 6);
+    *b = clamp255((y1 + BU * u) >> 6);
+}
+
+static void rowRgb565Scalar(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint16_t *dst, int width)
+{
+    for (int x = 0; x < width; ++x) {
+        int r, g, b;
+        yuvPixel(y[x], u[x >> 1], v[x >> 1], &r, &g, &b);
+        dst[x] = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+    }
+}
+
+static void rowArgb32Scalar(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t *dst, int width)
+{
+    for (int x = 0; x < width; ++x) {
+        int r, g, b;
+        yuvPixel(y[x], u[x >> 1], v[x >> 1], &r, &g, &b);
+        dst[x] = 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+    }
+}
+
+static void blendRowsScalar(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int width, int f)
+{
+    for (int x = 0; x < width; ++x) {
+        dst[x] = (uint8_t)((r0[x] * (128 - f) + r1[x] * f + 64) >> 7);
+    }
+}
+
+static const YuvKernels SCALAR_KERNELS = { YuvConvert::Scalar, rowRgb565Scalar, rowArgb32Scalar, blendRowsScalar };
+
+// --- SSE2：每次 8 个像素 ---
+#if defined(YUV_X86) && defined(__SSE2__)
+static inline __m128i loadChroma4(const uint8_t *p)
+{
+    uint32_t bits;
+    memcpy(&bits, p, 4);
+    __m128i c = _mm_cvtsi32_si128((int)bits);
+    return _mm_unpacklo_epi8(c, c); // 每个色度样本水平复制一次
+}
+
+static inline void yuvToRgbSse2(const uint8_t *py, const uint8_t *pu, const uint8_t *pv,
+                                __m128i *r, __m128i *g, __m128i *b)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c128 = _mm_set1_epi16(128);
+    __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)py), zero);
+    __m128i u = _mm_sub_epi16(_mm_unpacklo_epi8(loadChroma4(pu), zero), c128);
+    __m128i v = _mm_sub_epi16(_mm_unpacklo_epi8(loadChroma4(pv), zero), c128);
+
+    __m128i y1 = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)), _mm_set1_epi16(YC)),
+                               _mm_set1_epi16(32));
+    __m128i rr = _mm_srai_epi16(_mm_adds_epi16(y1, _mm_mullo_epi16(v, _mm_set1_epi16(RV))), 6);
+    __m128i gg = _mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(y1, _mm_mullo_epi16(u, _mm_set1_epi16(GU))),
+                                              _mm_mullo_epi16(v, _mm_set1_epi16(GV))), 6);
+    __m128i bb = _mm_srai_epi16(_mm_adds_epi16(y1, _mm_mullo_epi16(u, _mm_set1_epi16(BU))), 6);
+
+    const __m128i c255 = _mm_set1_epi16(255);
+    *r = _mm_min_epi16(_mm_max_epi16(rr, zero), c255);
+    *g = _mm_min_epi16(_mm_max_epi16(gg, zero), c255);
+    *b = _mm_min_epi16(_mm_max_epi16(bb, zero), c255);
+}
+
+static void rowRgb565Sse2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint16_t *dst, int width)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i r, g, b;
+        yuvToRgbSse2(y + x, u + x / 2, v + x / 2, &r, &g, &b);
+        __m128i px = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_and_si128(r, _mm_set1_epi16(0xF8)), 8),
+                                               _mm_slli_epi16(_mm_and_si128(g, _mm_set1_epi16(0xFC)), 3)),
+                                  _mm_srli_epi16(b, 3));
+        _mm_storeu_si128((__m128i *)(dst + x), px);
+    }
+    rowRgb565Scalar(y + x, u + x / 2, v + x / 2, dst + x, width - x);
+}
+
+static void rowArgb32Sse2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t *dst, int width)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i r, g, b;
+        yuvToRgbSse2(y + x, u + x / 2, v + x / 2, &r, &g, &b);
+        __m128i bg = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+        __m128i ra = _mm_or_si128(r, _mm_set1_epi16((short)0xFF00));
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128((__m128i *)(dst + x + 4), _mm_unpackhi_epi16(bg, ra));
+    }
+    rowArgb32Scalar(y + x, u + x / 2, v + x / 2, dst + x, width - x);
+}
+
+static void blendRowsSse2(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int width, int f)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w0 = _mm_set1_epi16((short)(128 - f));
+    const __m128i w1 = _mm_set1_epi16((short)f);
+    const __m128i half = _mm_set1_epi16(64);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(r0 + x));
+        __m128i b = _mm_loadu_si128((const __m128i *)(r1 + x));
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), w0),
+                                                 _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w1)), half);
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), w0),
+                                                 _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w1)), half);
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(_mm_srli_epi16(lo, 7), _mm_srli_epi16(hi, 7)));
+    }
+    blendRowsScalar(r0 + x, r1 + x, dst + x, width - x, f);
+}
+
+static const YuvKernels SSE2_KERNELS = { YuvConvert::Sse2, rowRgb565Sse2, rowArgb32Sse2, blendRowsSse2 };
+#endif
+
+// --- AVX2：每次 16 个像素，用 target 属性单独编译，不影响其他代码的指令集 ---
+#if defined(YUV_X86) && defined(__GNUC__)
+#define AVX2_FN __attribute__((target("avx2")))
+
+AVX2_FN static inline void yuvToRgbAvx2(const uint8_t *py, const uint8_t *pu, const uint8_t *pv,
+                                        __m256i *r, __m256i *g, __m256i *b)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i c128 = _mm256_set1_epi16(128);
+    __m128i u8 = _mm_loadl_epi64((const __m128i *)pu);
+    __m128i v8 = _mm_loadl_epi64((const __m128i *)pv);
+    __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)py));
+    __m256i u = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(u8, u8)), c128);
+    __m256i v = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(v8, v8)), c128);
+
+    __m256i y1 = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(y, _mm256_set1_epi16(16)), _mm256_set1_epi16(YC)),
+                                  _mm256_set1_epi16(32));
+    __m256i rr = _mm256_srai_epi16(_mm256_adds_epi16(y1, _mm256_mullo_epi16(v, _mm256_set1_epi16(RV))), 6);
+    __m256i gg = _mm256_srai_epi16(_mm256_sub_epi16(_mm256_sub_epi16(y1, _mm256_mullo_epi16(u, _mm256_set1_epi16(GU))),
+                                                    _mm256_mullo_epi16(v, _mm256_set1_epi16(GV))), 6);
+    __m256i bb = _mm256_srai_epi16(_mm256_adds_epi16(y1, _mm256_mullo_epi16(u, _mm256_set1_epi16(BU))), 6);
+
+    const __m256i c255 = _mm256_set1_epi16(255);
+    *r = _mm256_min_epi16(_mm256_max_epi16(rr, zero), c255);
+    *g = _mm256_min_epi16(_mm256_max_epi16(gg, zero), c255);
+    *b = _mm256_min_epi16(_mm256_max_epi16(bb, zero), c255);
+}
+
+AVX2_FN static void rowRgb565Avx2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint16_t *dst, int width)
+{
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i r, g, b;
+        yuvToRgbAvx2(y + x, u + x / 2, v + x / 2, &r, &g, &b);
+        __m256i px = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(r, _mm256_set1_epi16(0xF8)), 8),
+                                                     _mm256_slli_epi16(_mm256_and_si256(g, _mm256_set1_epi16(0xFC)), 3)),
+                                     _mm256_srli_epi16(b, 3));
+        _mm256_storeu_si256((__m256i *)(dst + x), px);
+    }
+    rowRgb565Scalar(y + x, u + x / 2, v + x / 2, dst + x, width - x);
+}
+
+AVX2_FN static void rowArgb32Avx2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t *dst, int width)
+{
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i r, g, b;
+        yuvToRgbAvx2(y + x, u + x / 2, v + x / 2, &r, &g, &b);
+        __m256i bg = _mm256_or_si256(b, _mm256_slli_epi16(g, 8));
+        __m256i ra = _mm256_or_si256(r, _mm256_set1_epi16((short)0xFF00));
+        // unpack 在两个 128 位半边内各自进行：lo = 像素 0-3 / 8-11，hi = 像素 4-7 / 12-15
+        __m256i lo = _mm256_unpacklo_epi16(bg, ra);
+        __m256i hi = _mm256_unpackhi_epi16(bg, ra);
+        _mm256_storeu_si256((__m256i *)(dst + x), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + x + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    rowArgb32Scalar(y + x, u + x / 2, v + x / 2, dst + x, width - x);
+}
+
+AVX2_FN static void blendRowsAvx2(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int width, int f)
+{
+    const __m256i w0 = _mm256_set1_epi16((short)(128 - f));
+    const __m256i w1 = _mm256_set1_epi16((short)f);
+    const __m256i half = _mm256_set1_epi16(64);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r0 + x)));
+        __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r1 + x)));
+        __m256i s = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(a, w0),
+                                                                        _mm256_mullo_epi16(b, w1)), half), 7);
+        __m128i out = _mm_packus_epi16(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+        _mm_storeu_si128((__m128i *)(dst + x), out);
+    }
+    blendRowsScalar(r0 + x, r1 + x, dst + x, width - x, f);
+}
+
+static const YuvKernels AVX2_KERNELS = { YuvConvert::Avx2, rowRgb565Avx2, rowArgb32Avx2, blendRowsAvx2 };
+#endif
+
+// --- NEON：每次 8 个像素 ---
+#ifdef YUV_NEON
+static inline void yuvToRgbNeon(const uint8_t *py, const uint8_t *pu, const uint8_t *pv,
+                                uint8x8_t *r, uint8x8_t *g, uint8x8_t *b)
+{
+    uint32_t ubits, vbits;
+    memcpy(&ubits, pu, 4);
+    memcpy(&vbits, pv, 4);
+    uint8x8_t u4 = vreinterpret_u8_u32(vdup_n_u32(ubits));
+    uint8x8_t v4 = vreinterpret_u8_u32(vdup_n_u32(vbits));
+    uint8x8_t u8 = vzip_u8(u4, u4).val[0]; // 每个色度样本水平复制一次
+    uint8x8_t v8 = vzip_u8(v4, v4).val[0];
+
+    const int16x8_t c128 = vdupq_n_s16(128);
+    int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(py)));
+    int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)), c128);
+    int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)), c128);
+
+    int16x8_t y1 = vaddq_s16(vmulq_n_s16(vsubq_s16(y, vdupq_n_s16(16)), YC), vdupq_n_s16(32));
+    int16x8_t rr = vshrq_n_s16(vqaddq_s16(y1, vmulq_n_s16(v, RV)), 6);
+    int16x8_t gg = vshrq_n_s16(vsubq_s16(vsubq_s16(y1, vmulq_n_s16(u, GU)), vmulq_n_s16(v, GV)), 6);
+    int16x8_t bb = vshrq_n_s16(vqaddq_s16(y1, vmulq_n_s16(u, BU)), 6);
+
+    // 饱和窄化即钳到 0..255
+    *r = vqmovun_s16(rr);
+    *g = vqmovun_s16(gg);
+    *b = vqmovun_s16(bb);
+}
+
+static void rowRgb565Neon(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint16_t *dst, int width)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8x8_t r, g, b;
+        yuvToRgbNeon(y + x, u + x / 2, v + x / 2, &r, &g, &b);
+        uint16x8_t px = vorrq_u16(vorrq_u16(vshll_n_u8(vand_u8(r, vdup_n_u8(0xF8)), 8),
+                                            vshll_n_u8(vand_u8(g, vdup_n_u8(0xFC)), 3)),
+                                  vmovl_u8(vshr_n_u8(b, 3)));
+        vst1q_u16(dst + x, px);
+    }
+    rowRgb565Scalar(y + x, u + x / 2, v + x / 2, dst + x, width - x);
+}
+
+static void rowArgb32Neon(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t *dst, int width)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x4_t px;
+        yuvToRgbNeon(y + x, u + x / 2, v + x / 2, &px.val[2], &px.val[1], &px.val[0]);
+        px.val[3] = vdup_n_u8(0xFF);
+        vst4_u8((uint8_t *)(dst + x), px); // 交织写出 B G R A
+    }
+    rowArgb32Scalar(y + x, u + x / 2, v + x / 2, dst + x, width - x);
+}
+
+static void blendRowsNeon(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int width, int f)
+{
+    const uint8x8_t w0 = vdup_n_u8((uint8_t)(128 - f));
+    const uint8x8_t w1 = vdup_n_u8((uint8_t)f);
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint16x8_t s = vmlal_u8(vmull_u8(vld1_u8(r0 + x), w0), vld1_u8(r1 + x), w1);
+        vst1_u8(dst + x, vrshrn_n_u16(s, 7)); // 带舍入右移，等于 (s + 64) >> 7
+    }
+    blendRowsScalar(r0 + x, r1 + x, dst + x, width - x, f);
+}
+
+static const YuvKernels NEON_KERNELS = { YuvConvert::Neon, rowRgb565Neon, rowArgb32Neon, blendRowsNeon };
+#endif
+
+// --- 分派 ---
+static const YuvKernels *kernelsFor(YuvConvert::Isa isa)
+{
+    switch (isa) {
+#if defined(YUV_X86) && defined(__SSE2__)
+    case YuvConvert::Sse2: return &SSE2_KERNELS;
+#endif
+#if defined(YUV_X86) && defined(__GNUC__)
+    case YuvConvert::Avx2: return &AVX2_KERNELS;
+#endif
+#ifdef YUV_NEON
+    case YuvConvert::Neon: return &NEON_KERNELS;
+#endif
+    case YuvConvert::Scalar: return &SCALAR_KERNELS;
+    default: return nullptr;
+    }
+}
+
+bool YuvConvert::isSupported(Isa isa)
+{
+    if (!kernelsFor(isa)) return false;
+    switch (isa) {
+#if defined(YUV_X86) && defined(__GNUC__)
+    case Avx2: return __builtin_cpu_supports("avx2");
+#endif
+#if defined(YUV_NEON) && defined(__arm__)
+    case Neon: return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#endif
+    default: return true;
+    }
+}
+
+static const YuvKernels *pickBest()
+{
+    const YuvConvert::Isa order[] = { YuvConvert::Avx2, YuvConvert::Neon, YuvConvert::Sse2 };
+    for (YuvConvert::Isa isa : order) {
+        if (YuvConvert::isSupported(isa)) return kernelsFor(isa);
+    }
+    return &SCALAR_KERNELS;
+}
+
+static std::atomic<const YuvKernels *> g_forced(nullptr);
+
+static const YuvKernels *kernels()
+{
+    static const YuvKernels *best = pickBest(); // 只检测一次 CPU
+    const YuvKernels *forced = g_forced.load(std::memory_order_relaxed);
+    return forced ? forced : best;
+}
+
+YuvConvert::Isa YuvConvert::isa()
+{
+    return kernels()->isa;
+}
+
+bool YuvConvert::setIsa(Isa isa)
+{
+    if (!isSupported(isa)) return false;
+    g_forced.store(kernelsFor(isa), std::memory_order_relaxed);
+    return true;
+}
+
+const char *YuvConvert::isaName(Isa isa)
+{
+    switch (isa) {
+    case Sse2: return "SSE2";
+    case Avx2: return "AVX2";
+    case Neon: return "NEON";
+    default: return "scalar";
+    }
+}
+
+// --- 转换 ---
+void YuvConvert::toRgb565(const Planes &src, uint8_t *dst, int dstStride)
+{
+    const YuvKernels *k = kernels();
+    for (int y = 0; y < src.height; ++y) {
+        k->rowRgb565(src.y + y * src.strideY, src.u + (y >> 1) * src.strideU, src.v + (y >> 1) * src.strideV,
+                     (uint16_t *)(dst + y * dstStride), src.width);
+    }
+}
+
+void YuvConvert::toArgb32(const Planes &src, uint8_t *dst, int dstStride)
+{
+    const YuvKernels *k = kernels();
+    for (int y = 0; y < src.height; ++y) {
+        k->rowArgb32(src.y + y * src.strideY, src.u + (y >> 1) * src.strideU, src.v + (y >> 1) * src.strideV,
+                     (uint32_t *)(dst + y * dstStride), src.width);
+    }
+}
+
+// --- 缩放 ---
+void YuvConvert::Image::resize(int w, int h)
+{
+    width = w;
+    height = h;
+    y.resize((size_t)w * h);
+    u.resize((size_t)((w + 1) / 2) * ((h + 1) / 2));
+    v.resize(u.size());
+}
+
+YuvConvert::Planes YuvConvert::Image::planes() const
+{
+    Planes p;
+    p.y = y.data();
+    p.u = u.data();
+    p.v = v.data();
+    p.strideY = width;
+    p.strideU = p.strideV = (width + 1) / 2;
+    p.width = width;
+    p.height = height;
+    return p;
+}
+
+// 采样点按像素中心对齐；idx 为左 / 上邻居，frac 为 7 位小数
+static void bilinearTable(int srcLen, int dstLen, std::vector<int> *idx, std::vector<uint8_t> *frac)
+{
+    idx->resize(dstLen);
+    frac->resize(dstLen);
+    for (int i = 0; i < dstLen; ++i) {
+        int64_t pos = ((int64_t)(2 * i + 1) * srcLen << 16) / (2 * dstLen) - 32768; // 16.16 定点
+        if (pos < 0) pos = 0;
+        int i0 = (int)(pos >> 16);
+        int f = (int)((pos & 0xFFFF) >> 9);
+        if (i0 >= srcLen - 1) {
+            i0 = srcLen - 1;
+            f = 0;
+        }
+        (*idx)[i] = i0;
+        (*frac)[i] = (uint8_t)f;
+    }
+}
+
+// 先用 SIMD 做垂直方向两行混合，再用查表做水平插值；系数表只在尺寸变化时重算
+static void scalePlane(const YuvKernels *k, const uint8_t *src, int sw, int sh, int sstride,
+                       uint8_t *dst, int dw, int dh, int dstride, YuvConvert::ScaleTable *t)
+{
+    if (t->srcW != sw || t->srcH != sh || t->dstW != dw || t->dstH != dh) {
+        bilinearTable(sw, dw, &t->xi, &t->xf);
+        bilinearTable(sh, dh, &t->yi, &t->yf);
+        t->row.resize(sw);
+        t->srcW = sw;
+        t->srcH = sh;
+        t->dstW = dw;
+        t->dstH = dh;
+    }
+    const std::vector<int> &xi = t->xi, &yi = t->yi;
+    const std::vector<uint8_t> &xf = t->xf, &yf = t->yf;
+    std::vector<uint8_t> &row = t->row;
+
+    for (int y = 0; y < dh; ++y) {
+        const uint8_t *r0 = src + yi[y] * sstride;
+        const uint8_t *line = r0;
+        if (yf[y]) {
+            k->blendRows(r0, r0 + sstride, row.data(), sw, yf[y]);
+            line = row.data();
+        }
+
+        uint8_t *out = dst + y * dstride;
+        for (int x = 0; x < dw; ++x) {
+            int i0 = xi[x];
+            int f = xf[x];
+            out[x] = f ? (uint8_t)((line[i0] * (128 - f) + line[i0 + 1] * f + 64) >> 7) : line[i0];
+        }
+    }
+}
+
+void YuvConvert::scale(const Planes &src, Image *dst)
+{
+    const YuvKernels *k = kernels();
+    int cw = (src.width + 1) / 2, ch = (src.height + 1) / 2;
+    int dcw = (dst->width + 1) / 2, dch = (dst->height + 1) / 2;
+    scalePlane(k, src.y, src.width, src.height, src.strideY, dst->y.data(), dst->width, dst->height, dst->width, &dst->lumaTable);
+    scalePlane(k, src.u, cw, ch, src.strideU, dst->u.data(), dcw, dch, dcw, &dst->chromaTable);
+    scalePlane(k, src.v, cw, ch, src.strideV, dst->v.data(), dcw, dch, dcw, &dst->chromaTable);
+}
+
+// --- 自检与性能测试 ---
+static void fillRandom(YuvConvert::Image *img, unsigned seed)
+{
+    srand(seed);
+    for (size_t i = 0; i < img->y.size(); ++i) img->y[i] = (uint8_t)rand();
+    for (size_t i = 0; i < img->u.size(); ++i) {
+        img->u[i] = (uint8_t)rand();
+        img->v[i] = (uint8_t)rand();
+    }
+}
+
+// 用 isa 跑一遍转换和缩放，输出拼在一起方便比较
+static std::vector<uint8_t> runAll(YuvConvert::Isa isa, const YuvConvert::Image &src, int dw, int dh)
+{
+    YuvConvert::setIsa(isa);
+    YuvConvert::Planes p = src.planes();
+    std::vector<uint8_t> out((size_t)src.width * src.height * 6);
+    YuvConvert::toRgb565(p, out.data(), src.width * 2);
+    YuvConvert::toArgb32(p, out.data() + (size_t)src.width * src.height * 2, src.width * 4);
+
+    YuvConvert::Image scaled;
+    scaled.resize(dw, dh);
+    YuvConvert::scale(p, &scaled);
+    out.insert(out.end(), scaled.y.begin(), scaled.y.end());
+    out.insert(out.end(), scaled.u.begin(), scaled.u.end());
+    out.insert(out.end(), scaled.v.begin(), scaled.v.end());
+    return out;
+}
+
+bool YuvConvert::selfTest()
+{
+    // 覆盖 SIMD 主循环、尾部以及奇数宽高
+    const int sizes[][4] = { {64, 32, 40, 24}, {77, 33, 50, 17}, {1280, 720, 640, 360}, {15, 9, 31, 19} };
+    const YuvKernels *saved = g_forced.load();
+    bool ok = true;
+
+    for (const auto &s : sizes) {
+        Image src;
+        src.resize(s[0], s[1]);
+        fillRandom(&src, (unsigned)(s[0] * 131 + s[1]));
+        std::vector<uint8_t> ref = runAll(Scalar, src, s[2], s[3]);
+
+        for (Isa isa : { Sse2, Avx2, Neon }) {
+            if (!isSupported(isa)) continue;
+            std::vector<uint8_t> out = runAll(isa, src, s[2], s[3]);
+            if (out != ref) {
+                size_t i = 0;
+                while (i < out.size() && out[i] == ref[i]) ++i;
+                qDebug() << "[YUV] self-test FAILED:" << isaName(isa) << s[0] << "x" << s[1] << "first diff at byte" << i;
+                ok = false;
+            }
+        }
+    }
+    g_forced.store(saved);
+    return ok;
+}
+
+bool YuvConvert::runBenchmark(int frames)
+{
+    bool passed = selfTest();
+    qDebug() << "[YUV] self-test" << (passed ? "passed" : "FAILED") << ", dispatch picks" << isaName(isa());
+
+    Image src720, src480;
+    src720.resize(1280, 720);
+    src480.resize(800, 480);
+    fillRandom(&src720, 1);
+    fillRandom(&src480, 2);
+    Image scaled;
+    scaled.resize(640, 360);
+    std::vector<uint8_t> out(800 * 480 * 4);
+
+    const YuvKernels *saved = g_forced.load();
+    for (Isa isa : { Scalar, Sse2, Avx2, Neon }) {
+        if (!setIsa(isa)) continue;
+
+        QElapsedTimer t;
+        t.start();
+        for (int i = 0; i < frames; ++i) {
+            scale(src720.planes(), &scaled);
+            toRgb565(scaled.planes(), out.data(), 640 * 2);
+        }
+        double fps565 = frames * 1000.0 / qMax<qint64>(1, t.elapsed());
+
+        t.restart();
+        for (int i = 0; i < frames; ++i) {
+            scale(src720.planes(), &scaled);
+            toArgb32(scaled.planes(), out.data(), 640 * 4);
+        }
+        double fpsArgb = frames * 1000.0 / qMax<qint64>(1, t.elapsed());
+
+        t.restart();
+        for (int i = 0; i < frames; ++i) {
+            toRgb565(src480.planes(), out.data(), 800 * 2);
+        }
+        double fpsFull = frames * 1000.0 / qMax<qint64>(1, t.elapsed());
+
+        qDebug().noquote() << QString("[YUV] %1: 720p->640x360 RGB565 %2 fps | ARGB32 %3 fps | 800x480 RGB565 %4 fps")
+                              .arg(isaName(isa), -6).arg(fps565, 0, 'f', 1).arg(fpsArgb, 0, 'f', 1).arg(fpsFull, 0, 'f', 1);
+    }
+    g_forced.store(saved);
+    return passed;
+}
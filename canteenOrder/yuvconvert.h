@@ -0,0 +1,63 @@
+#ifndef YUVCONVERT_H
+#define YUVCONVERT_H
+
+#include <stdint.h>
+#include <vector>
+
+// YUV420P -> RGB565 / ARGB32 颜色转换与双线性缩放
+// 每帧都要跑的热点循环，提供标量、SSE2、AVX2、NEON 几套内核，运行时按 CPU 选最快的；
+// 所有 SIMD 内核的输出与标量版本逐位一致，标量版本就是正确性基准
+class YuvConvert
+{
+public:
+    enum Isa { Scalar, Sse2, Avx2, Neon };
+
+    // 一帧 YUV420P 的三个平面 (不持有内存)
+    struct Planes {
+        const uint8_t *y;
+        const uint8_t *u;
+        const uint8_t *v;
+        int strideY;
+        int strideU;
+        int strideV;
+        int width;
+        int height;
+    };
+
+    // 双线性缩放的系数表：按源 / 目标尺寸算一次，尺寸不变时每帧复用
+    struct ScaleTable {
+        int srcW = 0, srcH = 0, dstW = 0, dstH = 0;
+        std::vector<int> xi, yi;        // 左 / 上邻居
+        std::vector<uint8_t> xf, yf;    // 7 位小数
+        std::vector<uint8_t> row;       // 垂直混合的行缓冲
+    };
+
+    // 持有内存的 YUV420P 图，缩放的输出
+    struct Image {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> y, u, v;
+        ScaleTable lumaTable, chromaTable;  // scale() 用的系数表缓存，跟着目标图走
+
+        void resize(int w, int h);
+        Planes planes() const;
+    };
+
+    static Isa isa();                   // 当前使用的内核
+    static bool isSupported(Isa isa);
+    static bool setIsa(Isa isa);        // 强制使用某套内核 (测试 / 基准用)，CPU 不支持时返回 false
+    static const char *isaName(Isa isa);
+
+    // dst 指向目标区域左上角；BT.601 有限范围
+    static void toRgb565(const Planes &src, uint8_t *dst, int dstStride);
+    static void toArgb32(const Planes &src, uint8_t *dst, int dstStride); // 内存顺序 B G R A
+    static void scale(const Planes &src, Image *dst);                     // 按 dst 已设定的尺寸缩放
+
+    // 各套内核与标量版本逐位比对 (含奇数宽高)
+    static bool selfTest();
+    // 性能测试：按我们的分辨率 (720p 片源 -> 640x360 画面，800x480 全屏) 报告每套内核的帧率 (启动参数 --bench-video)
+    // 先跑一遍 selfTest()，返回它的结果
+    static bool runBenchmark(int frames = 200);
+};
+
+#endif // YUVCONVERT_H